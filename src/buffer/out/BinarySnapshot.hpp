@@ -0,0 +1,56 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- BinarySnapshot.hpp
+
+Abstract:
+- Tiny helpers to read and write trivially copyable values from/to the binary
+  TextBuffer snapshots used for session restore. The layout of the snapshot
+  itself is described next to TextBuffer::SerializeSnapshotTo().
+- Values are stored in their native in-memory representation. Snapshots are
+  only ever read back by the same build that wrote them (see the version field).
+
+--*/
+
+#pragma once
+
+namespace BinarySnapshot
+{
+    template<typename T>
+    void Append(std::string& out, const T* data, size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
+        out.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+    }
+
+    template<typename T>
+    void Append(std::string& out, const T& value)
+    {
+        Append(out, &value, 1);
+    }
+
+    // Copies `count` items from the front of `in` into `data` and advances `in`.
+    // Returns false without consuming anything if `in` is too short.
+    template<typename T>
+    [[nodiscard]] bool Read(std::string_view& in, T* data, size_t count) noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (count > in.size() / sizeof(T))
+        {
+            return false;
+        }
+        const auto bytes = count * sizeof(T);
+        memcpy(data, in.data(), bytes);
+        in.remove_prefix(bytes);
+        return true;
+    }
+
+    template<typename T>
+    [[nodiscard]] bool Read(std::string_view& in, T& value) noexcept
+    {
+        return Read(in, &value, 1);
+    }
+}
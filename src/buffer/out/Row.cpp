@@ -4,6 +4,8 @@
 #include "precomp.h"
 #include "Row.hpp"
 
+#include "BinarySnapshot.hpp"
+
 #include <isa_availability.h>
 
 #include "../../types/inc/CodepointWidthDetector.hpp"
@@ -368,6 +370,189 @@ void ROW::CopyFrom(const ROW& source)
     _attr.resize_trailing_extent(_columnCount);
 }
 
+// Each row in a binary TextBuffer snapshot starts with a RowSnapshotHeader. It's followed by:
+// * charsLength-many wchar_t
+// * _columnCount+1 char offsets, unless RowSnapshotFlags::PlainOffsets is set
+// * attrRuns-many {TextAttribute, uint16_t} runs
+// * a RowSnapshotScrollbar, if RowSnapshotFlags::ScrollbarData is set
+// Images are not part of the snapshot.
+enum class RowSnapshotFlags : uint8_t
+{
+    None = 0x00,
+    WrapForced = 0x01,
+    DoubleBytePadded = 0x02,
+    // The row contains exactly 1 narrow, single wchar_t glyph per column (the common case).
+    PlainOffsets = 0x04,
+    ScrollbarData = 0x08,
+};
+DEFINE_ENUM_FLAG_OPERATORS(RowSnapshotFlags);
+
+struct RowSnapshotHeader
+{
+    uint16_t charsLength;
+    uint16_t attrRuns;
+    LineRendition lineRendition;
+    RowSnapshotFlags flags;
+};
+
+struct RowSnapshotScrollbar
+{
+    MarkCategory category;
+    bool hasColor;
+    bool hasExitCode;
+    uint8_t reserved;
+    til::color color;
+    uint32_t exitCode;
+};
+
+// TextAttributes and MarkCategories are copied from the snapshot verbatim.
+// Reject any enum values that the rest of the buffer code doesn't expect.
+static bool isValidSnapshotAttribute(const TextAttribute& attr) noexcept
+{
+    const auto isValidColor = [](const TextColor& color) noexcept {
+        return color.GetType() <= ColorType::IsRgb;
+    };
+    return isValidColor(attr.GetForeground()) &&
+           isValidColor(attr.GetBackground()) &&
+           isValidColor(attr.GetUnderlineColor()) &&
+           attr.GetUnderlineStyle() <= UnderlineStyle::Max &&
+           attr.GetMarkAttributes() <= MarkKind::Output;
+}
+
+// Returns the smallest number of bytes AppendSnapshot() writes for a row of the given width:
+// A header, either the characters or the char offsets (whichever is smaller) and 1 attribute run.
+// TextBuffer uses it to reject snapshots that claim to contain more rows than they possibly can.
+size_t ROW::GetMinimumSnapshotSize(uint16_t columnCount) noexcept
+{
+    return sizeof(RowSnapshotHeader) + size_t{ columnCount } * sizeof(wchar_t) + sizeof(TextAttribute) + sizeof(uint16_t);
+}
+
+// Appends the contents of this row to `out` in the format described above.
+// The counterpart is LoadSnapshot(), which expects a ROW of identical width.
+void ROW::AppendSnapshot(std::string& out) const
+{
+    const auto charsLength = _charSize();
+    const auto& runs = _attr.runs();
+
+    auto plainOffsets = charsLength == _columnCount;
+    for (uint16_t i = 0; plainOffsets && i < _columnCount; ++i)
+    {
+        plainOffsets = til::at(_charOffsets, i) == i;
+    }
+
+    auto flags = RowSnapshotFlags::None;
+    WI_SetFlagIf(flags, RowSnapshotFlags::WrapForced, _wrapForced);
+    WI_SetFlagIf(flags, RowSnapshotFlags::DoubleBytePadded, _doubleBytePadded);
+    WI_SetFlagIf(flags, RowSnapshotFlags::PlainOffsets, plainOffsets);
+    WI_SetFlagIf(flags, RowSnapshotFlags::ScrollbarData, _promptData.has_value());
+
+    BinarySnapshot::Append(out, RowSnapshotHeader{
+                                    .charsLength = charsLength,
+                                    .attrRuns = gsl::narrow<uint16_t>(runs.size()),
+                                    .lineRendition = _lineRendition,
+                                    .flags = flags,
+                                });
+    BinarySnapshot::Append(out, _chars.data(), charsLength);
+    if (!plainOffsets)
+    {
+        BinarySnapshot::Append(out, _charOffsets.data(), _charOffsets.size());
+    }
+    for (const auto& run : runs)
+    {
+        BinarySnapshot::Append(out, run.value);
+        BinarySnapshot::Append(out, run.length);
+    }
+    if (_promptData)
+    {
+        BinarySnapshot::Append(out, RowSnapshotScrollbar{
+                                        .category = _promptData->category,
+                                        .hasColor = _promptData->color.has_value(),
+                                        .hasExitCode = _promptData->exitCode.has_value(),
+                                        .color = _promptData->color.value_or(til::color{}),
+                                        .exitCode = _promptData->exitCode.value_or(0),
+                                    });
+    }
+}
+
+// Restores the contents of a row written by AppendSnapshot() and advances `in` past it.
+// Returns false if the data is truncated or inconsistent with this row's width,
+// in which case the row is left blank (filled with `fillAttribute`).
+bool ROW::LoadSnapshot(std::string_view& in, const TextAttribute& fillAttribute)
+{
+    Reset(fillAttribute);
+
+    RowSnapshotHeader header;
+    if (!BinarySnapshot::Read(in, header) ||
+        header.attrRuns == 0 ||
+        static_cast<uint8_t>(header.lineRendition) > static_cast<uint8_t>(LineRendition::DoubleHeightBottom) ||
+        (WI_IsFlagSet(header.flags, RowSnapshotFlags::PlainOffsets) && header.charsLength != _columnCount))
+    {
+        return false;
+    }
+
+    // Reset() pointed _chars at _charsBuffer, which fits exactly _columnCount characters.
+    if (header.charsLength > _chars.size())
+    {
+        _charsHeap = std::make_unique_for_overwrite<wchar_t[]>(header.charsLength);
+        _chars = { _charsHeap.get(), header.charsLength };
+    }
+
+    // Reset() already filled _charOffsets with 0..._columnCount, which is what RowSnapshotFlags::PlainOffsets implies.
+    if (!BinarySnapshot::Read(in, _chars.data(), header.charsLength) ||
+        (WI_IsFlagClear(header.flags, RowSnapshotFlags::PlainOffsets) && !BinarySnapshot::Read(in, _charOffsets.data(), _charOffsets.size())))
+    {
+        Reset(fillAttribute);
+        return false;
+    }
+
+    // The rest of ROW relies on _charOffsets being monotonic and in bounds. Don't trust the file.
+    auto valid = (til::at(_charOffsets, 0) & CharOffsetsTrailer) == 0 && til::at(_charOffsets, _columnCount) == header.charsLength;
+    for (uint16_t i = 1; valid && i <= _columnCount; ++i)
+    {
+        const auto prev = til::at(_charOffsets, i - 1) & CharOffsetsMask;
+        const auto curr = til::at(_charOffsets, i) & CharOffsetsMask;
+        valid = prev <= curr && curr <= header.charsLength;
+    }
+
+    RowAttributes::container runs;
+    runs.reserve(header.attrRuns);
+    size_t totalLength = 0;
+    for (uint16_t i = 0; valid && i < header.attrRuns; ++i)
+    {
+        TextAttribute attr;
+        uint16_t length = 0;
+        valid = BinarySnapshot::Read(in, attr) && BinarySnapshot::Read(in, length) && length != 0 && isValidSnapshotAttribute(attr);
+        totalLength += length;
+        runs.emplace_back(attr, length);
+    }
+
+    RowSnapshotScrollbar scrollbar{};
+    if (valid && WI_IsFlagSet(header.flags, RowSnapshotFlags::ScrollbarData))
+    {
+        valid = BinarySnapshot::Read(in, scrollbar) && scrollbar.category <= MarkCategory::Prompt;
+    }
+
+    if (!valid || totalLength != _columnCount)
+    {
+        Reset(fillAttribute);
+        return false;
+    }
+
+    _attr = RowAttributes{ std::move(runs) };
+    _lineRendition = header.lineRendition;
+    _wrapForced = WI_IsFlagSet(header.flags, RowSnapshotFlags::WrapForced);
+    _doubleBytePadded = WI_IsFlagSet(header.flags, RowSnapshotFlags::DoubleBytePadded);
+    if (WI_IsFlagSet(header.flags, RowSnapshotFlags::ScrollbarData))
+    {
+        _promptData = ScrollbarData{
+            .category = scrollbar.category,
+            .color = scrollbar.hasColor ? std::optional{ scrollbar.color } : std::nullopt,
+            .exitCode = scrollbar.hasExitCode ? std::optional{ scrollbar.exitCode } : std::nullopt,
+        };
+    }
+    return true;
+}
+
 // Returns the previous possible cursor position, preceding the given column.
 // Returns 0 if column is less than or equal to 0.
 til::CoordType ROW::NavigateToPrevious(til::CoordType column) const noexcept
@@ -539,6 +724,245 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
     return it;
 }
 
+// Routine Description:
+// - Writes CHAR_INFOs as used by WriteConsoleOutputW() into this row. Doesn't change the wrap flag.
+// - This behaves identical to calling WriteCells() with an OutputCellIterator over the same CHAR_INFOs,
+//   but instead of writing one cell at a time, the text is converted into a single string and the
+//   attributes into runs first, both of which are then written at once.
+// Arguments:
+// - columnBegin - The column to start writing at.
+// - infos - The CHAR_INFOs to write. Anything past the end of the row is ignored.
+void ROW::WriteCharInfos(const til::CoordType columnBegin, const std::span<const CHAR_INFO> infos)
+{
+    const auto colBeg = _clampedColumn(columnBegin);
+    const auto count = std::min<size_t>(infos.size(), _columnCount - colBeg);
+    if (count == 0)
+    {
+        return;
+    }
+
+    {
+        // TextAttribute doesn't retain the lead/trail byte flags, so we don't need to split runs on them.
+        til::small_vector<RowAttributes::rle_type, 16> runs;
+        auto attr = gsl::narrow_cast<WORD>(til::at(infos, 0).Attributes & ~COMMON_LVB_SBCSDBCS);
+        uint16_t length = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto a = gsl::narrow_cast<WORD>(til::at(infos, i).Attributes & ~COMMON_LVB_SBCSDBCS);
+            if (a != attr)
+            {
+                runs.emplace_back(TextAttribute{ attr }, length);
+                attr = a;
+                length = 0;
+            }
+            ++length;
+        }
+
+        runs.emplace_back(TextAttribute{ attr }, length);
+        _attr.replace(colBeg, gsl::narrow_cast<uint16_t>(colBeg + count), { runs.data(), runs.size() });
+    }
+
+    til::small_vector<wchar_t, 256> chars;
+    til::small_vector<uint16_t, 256> offsets;
+    til::CoordType segmentBegin = colBeg;
+    auto padded = false;
+
+    const auto push = [&](wchar_t ch, til::CoordType width) {
+        const auto offset = gsl::narrow_cast<uint16_t>(chars.size());
+        chars.push_back(ch);
+        offsets.push_back(offset);
+        if (width == 2)
+        {
+            offsets.push_back(gsl::narrow_cast<uint16_t>(offset | CharOffsetsTrailer));
+        }
+    };
+    const auto flush = [&](til::CoordType nextSegmentBegin) {
+        if (!offsets.empty())
+        {
+            offsets.push_back(gsl::narrow_cast<uint16_t>(chars.size()));
+            _replaceTextWithOffsets(segmentBegin, { chars.data(), chars.size() }, { offsets.data(), offsets.size() });
+            chars.clear();
+            offsets.clear();
+        }
+        segmentBegin = nextSegmentBegin;
+    };
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto& info = til::at(infos, i);
+        const auto column = gsl::narrow_cast<til::CoordType>(colBeg + i);
+        const auto ch = info.Char.UnicodeChar;
+
+        if (WI_IsFlagSet(info.Attributes, COMMON_LVB_LEADING_BYTE))
+        {
+            if (column == _columnCount - 1)
+            {
+                // The wide char doesn't fit. Pad with whitespace.
+                push(L' ', 1);
+                padded = true;
+            }
+            else if (i + 1 == count || WI_IsFlagSet(til::at(infos, i + 1).Attributes, COMMON_LVB_TRAILING_BYTE))
+            {
+                push(ch, 2);
+                // The trailing half doesn't contribute anything. Skip it.
+                ++i;
+            }
+            else
+            {
+                // The next CHAR_INFO overwrites the trailing half of this wide char,
+                // which leaves nothing but whitespace in the leading half.
+                push(L' ', 1);
+            }
+        }
+        else if (WI_IsFlagSet(info.Attributes, COMMON_LVB_TRAILING_BYTE))
+        {
+            if (column == 0)
+            {
+                // The wide char doesn't fit. Pad with whitespace.
+                push(L' ', 1);
+            }
+            else if (i == 0)
+            {
+                // See the corresponding comment in WriteCells() for why only the first trailer is considered.
+                segmentBegin = column - 1;
+                push(ch, 2);
+            }
+            else
+            {
+                // A trailer without a leading half leaves the cell untouched, just like in WriteCells().
+                flush(column + 1);
+            }
+        }
+        else
+        {
+            push(ch, 1);
+        }
+    }
+
+    flush(0);
+
+    if (padded)
+    {
+        SetDoubleBytePadded(true);
+    }
+}
+
+// Routine Description:
+// - Fills the columns [columnBegin, columnEnd) with copies of a narrow character.
+// - Unlike ReplaceText() with a repeated string, this never joins the characters into grapheme clusters.
+void ROW::FillCharacters(const til::CoordType columnBegin, const til::CoordType columnEnd, const wchar_t ch)
+{
+    const auto colBeg = _clampedColumn(columnBegin);
+    const auto colEnd = _clampedColumnInclusive(columnEnd);
+    if (colBeg >= colEnd)
+    {
+        return;
+    }
+
+    const size_t count = colEnd - colBeg;
+    til::small_vector<wchar_t, 256> chars;
+    til::small_vector<uint16_t, 256> offsets;
+    chars.resize(count, ch);
+    offsets.resize(count + 1);
+    std::iota(offsets.begin(), offsets.end(), uint16_t{ 0 });
+
+    _replaceTextWithOffsets(colBeg, { chars.data(), chars.size() }, { offsets.data(), offsets.size() });
+}
+
+// Routine Description:
+// - Exports the columns [columnBegin, columnBegin + infos.size()) as CHAR_INFOs as used by ReadConsoleOutputW().
+// - The result is identical to calling CONSOLE_INFORMATION::AsCharInfo() for each cell: Glyphs that
+//   don't fit into a single wchar_t are replaced with U+FFFD and wide glyphs get the lead/trail byte flags.
+//   But instead of converting the attributes of each cell, they're converted once per attribute run.
+// Arguments:
+// - columnBegin - The first column to export.
+// - infos - Receives the CHAR_INFOs. Items past the end of the row are left untouched.
+void ROW::ExportCharInfos(const til::CoordType columnBegin, const std::span<CHAR_INFO> infos) const
+{
+    const auto colBeg = _clampedColumnInclusive(columnBegin);
+    const auto colEnd = gsl::narrow_cast<uint16_t>(std::min<size_t>(_columnCount, colBeg + infos.size()));
+    if (colBeg >= colEnd)
+    {
+        return;
+    }
+
+    // The text and the lead/trail byte flags, one glyph at a time.
+    // Since the first column may be the trailing half of a wide glyph we can't just start at colBeg's
+    // char offset. Instead we search for the glyph's end, which works the same for all columns.
+    for (auto col = colBeg; col < colEnd;)
+    {
+        const auto chBeg = _uncheckedCharOffset(col);
+        auto colNext = col;
+        // Safety: colNext cannot be incremented past _columnCount, because the last
+        // _charOffset at index _columnCount will never get the CharOffsetsTrailer flag.
+        while (_uncheckedIsTrailer(++colNext))
+        {
+        }
+        const auto chEnd = _uncheckedCharOffset(colNext);
+        const auto ch = chEnd - chBeg == 1 ? til::at(_chars, chBeg) : UNICODE_REPLACEMENT;
+
+        for (; col < colNext && col < colEnd; ++col)
+        {
+            auto& info = til::at(infos, col - colBeg);
+            info.Char.UnicodeChar = ch;
+            info.Attributes = 0;
+            if (_uncheckedIsTrailer(col))
+            {
+                info.Attributes = COMMON_LVB_TRAILING_BYTE;
+            }
+            else if (col + 1 < colNext)
+            {
+                info.Attributes = COMMON_LVB_LEADING_BYTE;
+            }
+        }
+    }
+
+    // The attributes, converted once per run.
+    uint16_t runBeg = 0;
+    for (const auto& run : _attr.runs())
+    {
+        const auto runEnd = gsl::narrow_cast<uint16_t>(runBeg + run.length);
+        const auto beg = std::max(runBeg, colBeg);
+        const auto end = std::min(runEnd, colEnd);
+
+        if (beg < end)
+        {
+            const auto legacy = run.value.GetLegacyAttributes();
+            for (auto col = beg; col < end; ++col)
+            {
+                til::at(infos, col - colBeg).Attributes |= legacy;
+            }
+        }
+        if (runEnd >= colEnd)
+        {
+            break;
+        }
+
+        runBeg = runEnd;
+    }
+}
+
+// Writes `chars` at `columnBegin`, with `charOffsets` describing the column layout in the
+// same format as _charOffsets: One entry per column and a final one with the length of `chars`.
+void ROW::_replaceTextWithOffsets(const til::CoordType columnBegin, const std::wstring_view chars, const std::span<const uint16_t> charOffsets)
+try
+{
+    WriteHelper h{ *this, columnBegin, _columnCount, chars };
+    if (!h.IsValid())
+    {
+        return;
+    }
+    h.CopyTextFrom(charOffsets);
+    h.Finish();
+}
+catch (...)
+{
+    // See ReplaceCharacters().
+    Reset(TextAttribute{});
+    throw;
+}
+
 void ROW::SetAttrToEnd(const til::CoordType columnBegin, const TextAttribute attr)
 {
     _attr.replace(_clampedColumnInclusive(columnBegin), _attr.size(), attr);
@@ -1077,6 +1501,27 @@ bool ROW::ContainsText() const noexcept
     return false;
 }
 
+// Returns true if this row is indistinguishable from one that was
+// freshly constructed or Reset() with the given attributes.
+bool ROW::IsPristine(const TextAttribute& attr) const noexcept
+{
+    if (_charsHeap || _imageSlice || _wrapForced || _doubleBytePadded || _promptData || _lineRendition != LineRendition::SingleWidth)
+    {
+        return false;
+    }
+
+    const auto& runs = _attr.runs();
+    if (runs.size() != 1 || runs.front().value != attr)
+    {
+        return false;
+    }
+
+    // A row of _columnCount many whitespace characters can't contain wide glyphs,
+    // so its _charOffsets must be the identity mapping that _init() produces.
+    const auto text = GetText();
+    return text.size() == _columnCount && !ContainsText();
+}
+
 std::wstring_view ROW::GlyphAt(til::CoordType column) const noexcept
 {
     auto col = _clampedColumn(column);
@@ -140,6 +140,9 @@ public:
 
     void Reset(const TextAttribute& attr) noexcept;
     void CopyFrom(const ROW& source);
+    static size_t GetMinimumSnapshotSize(uint16_t columnCount) noexcept;
+    void AppendSnapshot(std::string& out) const;
+    bool LoadSnapshot(std::string_view& in, const TextAttribute& fillAttribute);
 
     til::CoordType NavigateToPrevious(til::CoordType column) const noexcept;
     til::CoordType NavigateToNext(til::CoordType column) const noexcept;
@@ -148,6 +151,9 @@ public:
 
     void ClearCell(til::CoordType column);
     OutputCellIterator WriteCells(OutputCellIterator it, til::CoordType columnBegin, std::optional<bool> wrap = std::nullopt, std::optional<til::CoordType> limitRight = std::nullopt);
+    void WriteCharInfos(til::CoordType columnBegin, std::span<const CHAR_INFO> infos);
+    void FillCharacters(til::CoordType columnBegin, til::CoordType columnEnd, wchar_t ch);
+    void ExportCharInfos(til::CoordType columnBegin, std::span<CHAR_INFO> infos) const;
     void SetAttrToEnd(til::CoordType columnBegin, TextAttribute attr);
     void ReplaceAttributes(til::CoordType beginIndex, til::CoordType endIndex, const TextAttribute& newAttr);
     void ReplaceCharacters(til::CoordType columnBegin, til::CoordType width, const std::wstring_view& chars);
@@ -166,6 +172,7 @@ public:
     til::CoordType MeasureLeft() const noexcept;
     til::CoordType MeasureRight() const noexcept;
     bool ContainsText() const noexcept;
+    bool IsPristine(const TextAttribute& attr) const noexcept;
     std::wstring_view GlyphAt(til::CoordType column) const noexcept;
     DbcsAttribute DbcsAttrAt(til::CoordType column) const noexcept;
     std::wstring_view GetText() const noexcept;
@@ -260,6 +267,7 @@ private:
 
     void _init() noexcept;
     void _resizeChars(uint16_t colEndDirty, uint16_t chBegDirty, size_t chEndDirty, uint16_t chEndDirtyOld);
+    void _replaceTextWithOffsets(til::CoordType columnBegin, std::wstring_view chars, std::span<const uint16_t> charOffsets);
     CharToColumnMapper _createCharToColumnMapper(ptrdiff_t offset) const noexcept;
 
     // These fields are a bit "wasteful", but it makes all this a bit more robust against
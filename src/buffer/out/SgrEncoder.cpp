@@ -0,0 +1,218 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "SgrEncoder.hpp"
+
+#include <til/hash.h>
+
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+
+// Hyperlinks are OSC 8 sequences and marks aren't visible at all.
+// Neither is part of SGR, so we strip them to improve the cache hit rate.
+static TextAttribute stripNonSgr(TextAttribute attr) noexcept
+{
+    attr.SetHyperlinkId(0);
+    attr.SetMarkAttributes(MarkKind::None);
+    return attr;
+}
+
+static char* appendParam(char* out, uint8_t n) noexcept
+{
+    *out++ = ';';
+    return fmt::format_to(out, FMT_COMPILE("{}"), n);
+}
+
+static char* appendColor(char* out, const TextColor& color, uint8_t base) noexcept
+{
+    switch (color.GetType())
+    {
+    case ColorType::IsDefault:
+        return appendParam(out, gsl::narrow_cast<uint8_t>(base + 9));
+    case ColorType::IsIndex16:
+    {
+        // 30-37 and 90-97 for the foreground, 40-47 and 100-107 for the background.
+        const auto bright = WI_IsFlagSet(color.GetIndex(), 8);
+        return appendParam(out, gsl::narrow_cast<uint8_t>((bright ? base + 60 : base) + (color.GetIndex() & 7)));
+    }
+    case ColorType::IsIndex256:
+        return fmt::format_to(out, FMT_COMPILE(";{};5;{}"), base + 8, color.GetIndex());
+    case ColorType::IsRgb:
+        return fmt::format_to(out, FMT_COMPILE(";{};2;{};{};{}"), base + 8, color.GetR(), color.GetG(), color.GetB());
+    default:
+        return out;
+    }
+}
+
+static char* appendUnderlineColor(char* out, const TextColor& color) noexcept
+{
+    switch (color.GetType())
+    {
+    case ColorType::IsDefault:
+        return appendParam(out, 59);
+    case ColorType::IsIndex16:
+    case ColorType::IsIndex256:
+        return fmt::format_to(out, FMT_COMPILE(";58:5:{}"), color.GetIndex());
+    case ColorType::IsRgb:
+        return fmt::format_to(out, FMT_COMPILE(";58:2::{}:{}:{}"), color.GetR(), color.GetG(), color.GetB());
+    default:
+        return out;
+    }
+}
+
+char* SgrEncoder::FormatParams(char* out, const TextAttribute& previous, const TextAttribute& next) noexcept
+{
+    const auto previousAttr = previous.GetCharacterAttributes();
+    const auto attr = next.GetCharacterAttributes();
+
+    if (previousAttr != attr)
+    {
+        auto attrDelta = attr ^ previousAttr;
+
+        // There's no escape sequence that only turns off either bold/intense or dim/faint. SGR 22 turns off both.
+        // So, if either of them turned off, we emit SGR 22 and then turn on whatever is supposed to remain on.
+        // Otherwise, we only need to turn on the ones that are new.
+        static constexpr auto intenseFaint = CharacterAttributes::Intense | CharacterAttributes::Faint;
+        if (WI_IsAnyFlagSet(attrDelta, intenseFaint))
+        {
+            auto turnOn = attr & intenseFaint;
+
+            if (WI_IsAnyFlagSet(previousAttr & attrDelta, intenseFaint))
+            {
+                out = appendParam(out, 22);
+            }
+            else
+            {
+                turnOn &= attrDelta;
+            }
+
+            if (WI_IsFlagSet(turnOn, CharacterAttributes::Intense))
+            {
+                out = appendParam(out, 1);
+            }
+            if (WI_IsFlagSet(turnOn, CharacterAttributes::Faint))
+            {
+                out = appendParam(out, 2);
+            }
+
+            WI_ClearAllFlags(attrDelta, intenseFaint);
+        }
+
+        struct Mapping
+        {
+            CharacterAttributes attr;
+            uint8_t change[2]; // [0] = off, [1] = on
+        };
+        static constexpr Mapping mappings[] = {
+            { CharacterAttributes::Italics, { 23, 3 } },
+            { CharacterAttributes::Blinking, { 25, 5 } },
+            { CharacterAttributes::Invisible, { 28, 8 } },
+            { CharacterAttributes::CrossedOut, { 29, 9 } },
+            { CharacterAttributes::TopGridline, { 55, 53 } },
+            { CharacterAttributes::ReverseVideo, { 27, 7 } },
+        };
+        for (const auto& mapping : mappings)
+        {
+            if (WI_IsAnyFlagSet(attrDelta, mapping.attr))
+            {
+                out = appendParam(out, til::at(mapping.change, WI_IsAnyFlagSet(attr, mapping.attr)));
+            }
+        }
+
+        if (WI_IsAnyFlagSet(attrDelta, CharacterAttributes::UnderlineStyle))
+        {
+            static constexpr std::string_view mappings[] = {
+                ";24", // UnderlineStyle::NoUnderline
+                ";4", // UnderlineStyle::SinglyUnderlined
+                ";21", // UnderlineStyle::DoublyUnderlined
+                ";4:3", // UnderlineStyle::CurlyUnderlined
+                ";4:4", // UnderlineStyle::DottedUnderlined
+                ";4:5", // UnderlineStyle::DashedUnderlined
+            };
+
+            auto idx = WI_EnumValue(next.GetUnderlineStyle());
+            if (idx >= std::size(mappings))
+            {
+                idx = 1; // UnderlineStyle::SinglyUnderlined
+            }
+
+            const auto& str = til::at(mappings, idx);
+            out = std::copy(str.begin(), str.end(), out);
+        }
+    }
+
+    if (const auto fg = next.GetForeground(); previous.GetForeground() != fg)
+    {
+        out = appendColor(out, fg, 30);
+    }
+
+    if (const auto bg = next.GetBackground(); previous.GetBackground() != bg)
+    {
+        out = appendColor(out, bg, 40);
+    }
+
+    if (const auto ul = next.GetUnderlineColor(); previous.GetUnderlineColor() != ul)
+    {
+        out = appendUnderlineColor(out, ul);
+    }
+
+    return out;
+}
+
+std::string_view SgrEncoder::_lookup(const TextAttribute& previous, const TextAttribute& next) noexcept
+{
+    const auto p = stripNonSgr(previous);
+    const auto n = stripNonSgr(next);
+    const auto hash = til::hasher{}.write(p).write(n).finalize();
+    auto& entry = til::at(_cache, hash % cacheSize);
+
+    if (!entry.valid || entry.previous != p || entry.next != n)
+    {
+        const auto end = FormatParams(&entry.params[0], p, n);
+        entry.previous = p;
+        entry.next = n;
+        entry.length = gsl::narrow_cast<uint8_t>(end - &entry.params[0]);
+        entry.valid = true;
+    }
+
+    return { &entry.params[0], entry.length };
+}
+
+template<typename T>
+static void appendSequence(std::basic_string<T>& target, std::string_view prefix, std::string_view params)
+{
+    const auto beg = target.size();
+    target.resize(beg + prefix.size() + params.size() + 1);
+    auto out = target.data() + beg;
+    out = std::copy(prefix.begin(), prefix.end(), out);
+    out = std::copy(params.begin(), params.end(), out);
+    *out = 'm';
+}
+
+void SgrEncoder::AppendTransition(std::string& target, const TextAttribute& previous, const TextAttribute& next)
+{
+    if (const auto params = _lookup(previous, next); !params.empty())
+    {
+        // Skip the leading ";" of the first parameter.
+        appendSequence(target, "\x1b[", params.substr(1));
+    }
+}
+
+void SgrEncoder::AppendTransition(std::wstring& target, const TextAttribute& previous, const TextAttribute& next)
+{
+    if (const auto params = _lookup(previous, next); !params.empty())
+    {
+        appendSequence(target, "\x1b[", params.substr(1));
+    }
+}
+
+void SgrEncoder::AppendReset(std::string& target, const TextAttribute& next)
+{
+    appendSequence(target, "\x1b[0", _lookup({}, next));
+}
+
+void SgrEncoder::AppendReset(std::wstring& target, const TextAttribute& next)
+{
+    appendSequence(target, "\x1b[0", _lookup({}, next));
+}
@@ -0,0 +1,52 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SgrEncoder.hpp
+
+Abstract:
+- Encodes the transition between two TextAttributes into a single SGR escape sequence.
+- Serializing a buffer or a WriteConsoleOutput() call usually alternates between a handful
+  of attributes, so the encoded transitions are memoized in a small direct-mapped cache.
+--*/
+
+#pragma once
+
+#include "TextAttribute.hpp"
+
+class SgrEncoder
+{
+public:
+    // Appends the shortest "CSI ... m" that turns `previous` into `next`.
+    // Nothing is appended if the two are visually identical.
+    void AppendTransition(std::string& target, const TextAttribute& previous, const TextAttribute& next);
+    void AppendTransition(std::wstring& target, const TextAttribute& previous, const TextAttribute& next);
+
+    // Appends a "CSI 0 ; ... m" that resets all attributes before applying `next`.
+    // This is what SetConsoleTextAttribute() and similar APIs need, because
+    // they're supposed to replace any VT-exclusive attributes as well.
+    void AppendReset(std::string& target, const TextAttribute& next);
+    void AppendReset(std::wstring& target, const TextAttribute& next);
+
+    // Uncached: Writes the SGR parameters (each prefixed with ";") necessary to turn `previous` into `next`.
+    // `out` must refer to at least MaxParamsLength characters. Returns a pointer past the end.
+    static constexpr size_t MaxParamsLength = 128;
+    static char* FormatParams(char* out, const TextAttribute& previous, const TextAttribute& next) noexcept;
+
+private:
+    struct Entry
+    {
+        TextAttribute previous;
+        TextAttribute next;
+        uint8_t length = 0;
+        bool valid = false;
+        char params[MaxParamsLength];
+    };
+
+    static constexpr size_t cacheSize = 64;
+
+    std::string_view _lookup(const TextAttribute& previous, const TextAttribute& next) noexcept;
+
+    std::array<Entry, cacheSize> _cache;
+};
@@ -6,6 +6,8 @@
 
 #include <til/hash.h>
 
+#include "BinarySnapshot.hpp"
+#include "SgrEncoder.hpp"
 #include "UTextAdapter.h"
 #include "../../types/inc/CodepointWidthDetector.hpp"
 #include "../renderer/base/renderer.hpp"
@@ -172,6 +174,54 @@ void TextBuffer::_destroy() const noexcept
     }
 }
 
+// Decommits the trailing rows that are still in their initial state, like the parts of the
+// buffer the application hasn't written to yet and the read-ahead of _commit(). Such rows
+// are indistinguishable from uncommitted ones and _commit() recreates them on demand.
+// This lets buffers that aren't shown give memory back without changing their contents.
+void TextBuffer::TrimCommittedMemory() noexcept
+{
+    // Once the buffer has wrapped around, the physically last rows are old scrollback and not the
+    // end of the logical buffer anymore. _estimateOffsetOfLastCommittedRow() relies on the watermark
+    // being at the end of the buffer in that case, so we must leave it alone.
+    if (_firstRow != 0)
+    {
+        return;
+    }
+
+    // Row 0 is the scratchpad row (see GetScratchpadRow()). We keep it around.
+    const auto first = _buffer.get() + _bufferRowStride;
+    auto watermark = _commitWatermark;
+
+    while (watermark > first && reinterpret_cast<const ROW*>(watermark - _bufferRowStride)->IsPristine(_initialAttributes))
+    {
+        watermark -= _bufferRowStride;
+    }
+
+    if (watermark == _commitWatermark)
+    {
+        return;
+    }
+
+    for (auto it = watermark; it < _commitWatermark; it += _bufferRowStride)
+    {
+        std::destroy_at(reinterpret_cast<ROW*>(it));
+    }
+
+    // VirtualFree() decommits every page that the given range touches, but the row right below
+    // the new watermark may extend into the same page. So we round up to the next page boundary.
+    // The destroyed rows in between stay committed, which is fine, because committing memory
+    // twice is a no-op for VirtualAlloc() in _commit(). (All Windows targets use 4KiB pages.)
+    static constexpr uintptr_t pageSize = 4096;
+    const auto offset = gsl::narrow_cast<uintptr_t>(watermark - _buffer.get());
+    const auto decommitBeg = _buffer.get() + ((offset + pageSize - 1) & ~(pageSize - 1));
+    if (decommitBeg < _commitWatermark)
+    {
+        VirtualFree(decommitBeg, gsl::narrow_cast<size_t>(_commitWatermark - decommitBeg), MEM_DECOMMIT);
+    }
+
+    _commitWatermark = watermark;
+}
+
 // This function is "direct" because it trusts the caller to properly
 // wrap the "offset" parameter modulo the _height of the buffer.
 ROW& TextBuffer::_getRowByOffsetDirect(size_t offset)
@@ -719,6 +769,71 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
     return newIt;
 }
 
+// Routine Description:
+// - Writes one row of CHAR_INFOs (as given to WriteConsoleOutputW) to the output buffer.
+//   See ROW::WriteCharInfos for more information.
+// Arguments:
+// - target - Coordinate targeted within output buffer
+// - infos - The cells to write. Anything past the end of the row is ignored.
+void TextBuffer::WriteCharInfos(const til::point target, const std::span<const CHAR_INFO> infos)
+{
+    if (!GetSize().IsInBounds(target) || infos.empty())
+    {
+        return;
+    }
+
+    auto& row = GetMutableRowByOffset(target.y);
+    row.WriteCharInfos(target.x, infos);
+
+    // Wide glyphs may have modified 1 column to the left and right of the written range.
+    const auto left = std::max(0, target.x - 1);
+    const auto right = gsl::narrow_cast<til::CoordType>(std::min<size_t>(row.size(), target.x + infos.size() + 1));
+    TriggerRedraw(Viewport::FromExclusive({ left, target.y, right, target.y + 1 }));
+}
+
+// Routine Description:
+// - Fills `length` cells starting at `target` and continuing in the following rows
+//   with the same narrow character and/or attribute. Rows whose last column
+//   got filled with text are marked as not wrapped.
+// - This is identical to Write() with a fill OutputCellIterator, but a whole row at a time.
+// Arguments:
+// - target - Coordinate targeted within output buffer
+// - length - The number of cells to fill
+// - ch - If not null, the character to fill with. Must not be a wide glyph.
+// - attr - If not null, the attribute to fill with.
+void TextBuffer::FillCells(const til::point target, const size_t length, const wchar_t* ch, const TextAttribute* attr)
+{
+    const auto size = GetSize();
+    if (!size.IsInBounds(target))
+    {
+        return;
+    }
+
+    auto remaining = length;
+    for (auto pos = target; remaining != 0 && pos.y < size.Height(); pos = { 0, pos.y + 1 })
+    {
+        const auto columns = gsl::narrow_cast<til::CoordType>(std::min<size_t>(remaining, size.Width() - pos.x));
+        const auto end = pos.x + columns;
+        auto& row = GetMutableRowByOffset(pos.y);
+
+        if (attr)
+        {
+            row.ReplaceAttributes(pos.x, end, *attr);
+        }
+        if (ch)
+        {
+            row.FillCharacters(pos.x, end, *ch);
+            if (end == size.Width())
+            {
+                row.SetWrapForced(false);
+            }
+        }
+
+        TriggerRedraw(Viewport::FromExclusive({ std::max(0, pos.x - 1), pos.y, std::min(size.Width(), end + 1), pos.y + 1 }));
+        remaining -= columns;
+    }
+}
+
 //Routine Description:
 // - Increments the circular buffer by one. Circular buffer is represented by FirstRow variable.
 //Arguments:
@@ -1925,6 +2040,7 @@ std::wstring TextBuffer::GetWithControlSequences(const CopyRequest& req) const
     }
 
     std::wstring selectedText;
+    SgrEncoder sgr;
     std::optional<TextAttribute> previousTextAttr;
     bool delayedLineBreak = false;
 
@@ -1939,7 +2055,7 @@ std::wstring TextBuffer::GetWithControlSequences(const CopyRequest& req) const
         const bool isLastRow = currentRow == lastRow;
         const bool addLineBreak = reqAddLineBreak && !isLastRow;
 
-        _SerializeRow(row, startX, endX, addLineBreak, isLastRow, selectedText, previousTextAttr, delayedLineBreak);
+        _SerializeRow(row, startX, endX, addLineBreak, isLastRow, selectedText, previousTextAttr, delayedLineBreak, sgr);
     }
 
     return selectedText;
@@ -2383,6 +2499,7 @@ void TextBuffer::SerializeTo(HANDLE handle) const
     buffer.reserve(writeThreshold + writeThreshold / 2);
     buffer.push_back(L'\uFEFF');
 
+    SgrEncoder sgr;
     std::optional<TextAttribute> previousTextAttr;
     bool delayedLineBreak = false;
 
@@ -2400,7 +2517,7 @@ void TextBuffer::SerializeTo(HANDLE handle) const
         const auto endX = row.GetReadableColumnCount();
         const bool addLineBreak = !row.WasWrapForced() || isLastRow;
 
-        _SerializeRow(row, startX, endX, addLineBreak, isLastRow, buffer, previousTextAttr, delayedLineBreak);
+        _SerializeRow(row, startX, endX, addLineBreak, isLastRow, buffer, previousTextAttr, delayedLineBreak, sgr);
 
         if (buffer.size() >= writeThreshold || isLastRow)
         {
@@ -2418,6 +2535,180 @@ void TextBuffer::SerializeTo(HANDLE handle) const
     }
 }
 
+// A binary snapshot starts with this header, which is followed by:
+// * hyperlinkCount-many {uint16_t id, uint32_t length, wchar_t uri[length]} entries (_hyperlinkMap)
+// * customIdCount-many entries of the same layout, where the string is the custom ID (_hyperlinkCustomIdMap)
+// * rowCount-many rows as written by ROW::AppendSnapshot()
+struct TextBufferSnapshotHeader
+{
+    static constexpr uint32_t Magic = 0x42535457; // "WTSB" in little-endian
+    // Increment this whenever the layout of the snapshot or of TextAttribute changes.
+    static constexpr uint32_t Version = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint16_t width;
+    uint16_t currentHyperlinkId;
+    uint32_t rowCount;
+    uint32_t hyperlinkCount;
+    uint32_t customIdCount;
+};
+
+static_assert(sizeof(TextAttribute) == 18, "TextBufferSnapshotHeader::Version needs to be incremented");
+
+// Writes the contents of the buffer (text, attributes, line renditions, wrap flags, hyperlinks and
+// prompt marks) in a compact binary form. Unlike SerializeTo() this involves no VT encoding, and
+// LoadSnapshot() can restore it without going through the VT parser, which makes it a lot cheaper
+// for session restore. The snapshot is written in 32 KiB chunks, just like SerializeTo().
+void TextBuffer::SerializeSnapshotTo(HANDLE handle) const
+{
+    static constexpr size_t writeThreshold = 32 * 1024;
+    std::string buffer;
+    buffer.reserve(writeThreshold + writeThreshold / 2);
+
+    const auto flush = [&]() {
+        const auto fileSize = gsl::narrow<DWORD>(buffer.size());
+        DWORD bytesWritten = 0;
+        THROW_IF_WIN32_BOOL_FALSE(WriteFile(handle, buffer.data(), fileSize, &bytesWritten, nullptr));
+        THROW_WIN32_IF_MSG(ERROR_WRITE_FAULT, bytesWritten != fileSize, "failed to write");
+        buffer.clear();
+    };
+
+    const auto rowCount = GetLastNonSpaceCharacter(nullptr).y + 1;
+
+    BinarySnapshot::Append(buffer, TextBufferSnapshotHeader{
+                                       .magic = TextBufferSnapshotHeader::Magic,
+                                       .version = TextBufferSnapshotHeader::Version,
+                                       .width = gsl::narrow<uint16_t>(_width),
+                                       .currentHyperlinkId = _currentHyperlinkId,
+                                       .rowCount = gsl::narrow<uint32_t>(rowCount),
+                                       .hyperlinkCount = gsl::narrow<uint32_t>(_hyperlinkMap.size()),
+                                       .customIdCount = gsl::narrow<uint32_t>(_hyperlinkCustomIdMap.size()),
+                                   });
+
+    for (const auto& [id, uri] : _hyperlinkMap)
+    {
+        BinarySnapshot::Append(buffer, id);
+        BinarySnapshot::Append(buffer, gsl::narrow<uint32_t>(uri.size()));
+        BinarySnapshot::Append(buffer, uri.data(), uri.size());
+    }
+    for (const auto& [customId, id] : _hyperlinkCustomIdMap)
+    {
+        BinarySnapshot::Append(buffer, id);
+        BinarySnapshot::Append(buffer, gsl::narrow<uint32_t>(customId.size()));
+        BinarySnapshot::Append(buffer, customId.data(), customId.size());
+    }
+
+    for (til::CoordType y = 0; y < rowCount; ++y)
+    {
+        GetRowByOffset(y).AppendSnapshot(buffer);
+        if (buffer.size() >= writeThreshold)
+        {
+            flush();
+        }
+    }
+
+    if (!buffer.empty())
+    {
+        flush();
+    }
+}
+
+// Returns the size of the buffer that's needed to LoadSnapshot() the given data,
+// or nullopt if the data isn't a snapshot written by this version of SerializeSnapshotTo().
+// The files are untrusted input, so the row count is checked against the size of the data:
+// Since the rows are yet to be validated, this is still an upper bound and not the exact size.
+std::optional<til::size> TextBuffer::GetSnapshotSize(std::string_view data) noexcept
+{
+    TextBufferSnapshotHeader header;
+    if (!BinarySnapshot::Read(data, header) ||
+        header.magic != TextBufferSnapshotHeader::Magic ||
+        header.version != TextBufferSnapshotHeader::Version ||
+        header.width == 0 ||
+        header.rowCount == 0 ||
+        header.rowCount > static_cast<uint32_t>(til::CoordTypeMax) ||
+        header.rowCount > data.size() / ROW::GetMinimumSnapshotSize(header.width))
+    {
+        return std::nullopt;
+    }
+    return til::size{ header.width, gsl::narrow_cast<til::CoordType>(header.rowCount) };
+}
+
+// Loads a snapshot written by SerializeSnapshotTo() into this buffer, which must be exactly as wide
+// as GetSnapshotSize() says. If the snapshot has more rows than the buffer, only the last ones are kept.
+// Returns false if the snapshot is invalid or corrupted.
+// Callers are expected to load into a scratch buffer and Reflow() it into place on success.
+bool TextBuffer::LoadSnapshot(std::string_view data)
+{
+    const auto size = GetSnapshotSize(data);
+    if (!size || size->width != _width)
+    {
+        return false;
+    }
+
+    TextBufferSnapshotHeader header;
+    std::ignore = BinarySnapshot::Read(data, header);
+
+    const auto readString = [&](uint16_t& id, std::wstring& str) {
+        uint32_t length = 0;
+        if (!BinarySnapshot::Read(data, id) || !BinarySnapshot::Read(data, length) || length > data.size() / sizeof(wchar_t))
+        {
+            return false;
+        }
+        str.resize(length);
+        return BinarySnapshot::Read(data, str.data(), length);
+    };
+
+    uint16_t id = 0;
+    std::wstring str;
+    for (uint32_t i = 0; i < header.hyperlinkCount; ++i)
+    {
+        if (!readString(id, str))
+        {
+            return false;
+        }
+        _hyperlinkMap.insert_or_assign(id, str);
+    }
+    for (uint32_t i = 0; i < header.customIdCount; ++i)
+    {
+        if (!readString(id, str))
+        {
+            return false;
+        }
+        _hyperlinkCustomIdMap.insert_or_assign(str, id);
+    }
+    _currentHyperlinkId = header.currentHyperlinkId;
+
+    for (til::CoordType y = 0; y < size->height; ++y)
+    {
+        // Once the buffer is full, we circle around and overwrite the oldest row, like IncrementCircularBuffer()
+        // (which we can't use, because pruning hyperlinks for every row would make this quadratic).
+        if (y >= _height)
+        {
+            _firstRow = (_firstRow + 1) % _height;
+        }
+
+        auto& row = GetMutableRowByOffset(std::min(y, _height - 1));
+        if (!row.LoadSnapshot(data, _initialAttributes))
+        {
+            return false;
+        }
+
+        // GetHyperlinkUriFromId() assumes that every ID in the buffer is in the map.
+        for (const auto id : row.GetHyperlinks())
+        {
+            if (!_hyperlinkMap.contains(id))
+            {
+                row.Reset(_initialAttributes);
+                return false;
+            }
+        }
+    }
+
+    TriggerRedrawAll();
+    return true;
+}
+
 // Serializes one row of the text buffer including ANSI escape code control sequences.
 // Arguments:
 // - row - A reference to the row being serialized.
@@ -2432,7 +2723,8 @@ void TextBuffer::SerializeTo(HANDLE handle) const
 // - delayedLineBreak - Similarly used for tracking state across multiple calls, and similarly will be mutated
 //      by the call. The initial call should pass `false` and subsequent calls should pass the value that was
 //      written by the previous call.
-void TextBuffer::_SerializeRow(const ROW& row, const til::CoordType startX, const til::CoordType endX, const bool addLineBreak, const bool isLastRow, std::wstring& buffer, std::optional<TextAttribute>& previousTextAttr, bool& delayedLineBreak) const
+// - sgr - Encodes (and caches) the SGR sequences between consecutive attributes. Reuse it across rows.
+void TextBuffer::_SerializeRow(const ROW& row, const til::CoordType startX, const til::CoordType endX, const bool addLineBreak, const bool isLastRow, std::wstring& buffer, std::optional<TextAttribute>& previousTextAttr, bool& delayedLineBreak, SgrEncoder& sgr) const
 {
     if (const auto lr = row.GetLineRendition(); lr != LineRendition::SingleWidth)
     {
@@ -2461,161 +2753,10 @@ void TextBuffer::_SerializeRow(const ROW& row, const til::CoordType startX, cons
     for (; it != end; ++it)
     {
         const auto effectivePreviousTextAttr = previousTextAttr.value_or(TextAttribute{ CharacterAttributes::Unused1, TextColor{}, TextColor{}, 0, TextColor{} });
-        const auto previousAttr = effectivePreviousTextAttr.GetCharacterAttributes();
         const auto previousHyperlinkId = effectivePreviousTextAttr.GetHyperlinkId();
-        const auto previousFg = effectivePreviousTextAttr.GetForeground();
-        const auto previousBg = effectivePreviousTextAttr.GetBackground();
-        const auto previousUl = effectivePreviousTextAttr.GetUnderlineColor();
-
-        const auto attr = it->value.GetCharacterAttributes();
         const auto hyperlinkId = it->value.GetHyperlinkId();
-        const auto fg = it->value.GetForeground();
-        const auto bg = it->value.GetBackground();
-        const auto ul = it->value.GetUnderlineColor();
-
-        if (previousAttr != attr)
-        {
-            auto attrDelta = attr ^ previousAttr;
-
-            // There's no escape sequence that only turns off either bold/intense or dim/faint. SGR 22 turns off both.
-            // This results in two issues in our generic "Mapping" code below. Assuming, both Intense and Faint were on...
-            // * ...and either turned off, it would emit SGR 22 which turns both attributes off = Wrong.
-            // * ...and both are now off, it would emit SGR 22 twice.
-            //
-            // This extra branch takes care of both issues. If both attributes turned off it'll emit a single \x1b[22m,
-            // if faint turned off \x1b[22;1m (intense is still on), and \x1b[22;2m if intense turned off (vice versa).
-            if (WI_AreAllFlagsSet(previousAttr, CharacterAttributes::Intense | CharacterAttributes::Faint) &&
-                WI_IsAnyFlagSet(attrDelta, CharacterAttributes::Intense | CharacterAttributes::Faint))
-            {
-                wchar_t buf[8] = L"\x1b[22m";
-                size_t len = 5;
-
-                if (WI_IsAnyFlagSet(attr, CharacterAttributes::Intense | CharacterAttributes::Faint))
-                {
-                    buf[4] = L';';
-                    buf[5] = WI_IsAnyFlagSet(attr, CharacterAttributes::Intense) ? L'1' : L'2';
-                    buf[6] = L'm';
-                    len = 7;
-                }
-
-                buffer.append(&buf[0], len);
-                WI_ClearAllFlags(attrDelta, CharacterAttributes::Intense | CharacterAttributes::Faint);
-            }
 
-            {
-                struct Mapping
-                {
-                    CharacterAttributes attr;
-                    uint8_t change[2]; // [0] = off, [1] = on
-                };
-                static constexpr Mapping mappings[] = {
-                    { CharacterAttributes::Intense, { 22, 1 } },
-                    { CharacterAttributes::Italics, { 23, 3 } },
-                    { CharacterAttributes::Blinking, { 25, 5 } },
-                    { CharacterAttributes::Invisible, { 28, 8 } },
-                    { CharacterAttributes::CrossedOut, { 29, 9 } },
-                    { CharacterAttributes::Faint, { 22, 2 } },
-                    { CharacterAttributes::TopGridline, { 55, 53 } },
-                    { CharacterAttributes::ReverseVideo, { 27, 7 } },
-                };
-                for (const auto& mapping : mappings)
-                {
-                    if (WI_IsAnyFlagSet(attrDelta, mapping.attr))
-                    {
-                        const auto n = til::at(mapping.change, WI_IsAnyFlagSet(attr, mapping.attr));
-                        fmt::format_to(std::back_inserter(buffer), FMT_COMPILE(L"\x1b[{}m"), n);
-                    }
-                }
-            }
-
-            if (WI_IsAnyFlagSet(attrDelta, CharacterAttributes::UnderlineStyle))
-            {
-                static constexpr std::wstring_view mappings[] = {
-                    L"\x1b[24m", // UnderlineStyle::NoUnderline
-                    L"\x1b[4m", // UnderlineStyle::SinglyUnderlined
-                    L"\x1b[21m", // UnderlineStyle::DoublyUnderlined
-                    L"\x1b[4:3m", // UnderlineStyle::CurlyUnderlined
-                    L"\x1b[4:4m", // UnderlineStyle::DottedUnderlined
-                    L"\x1b[4:5m", // UnderlineStyle::DashedUnderlined
-                };
-
-                auto idx = WI_EnumValue(it->value.GetUnderlineStyle());
-                if (idx >= std::size(mappings))
-                {
-                    idx = 1; // UnderlineStyle::SinglyUnderlined
-                }
-
-                buffer.append(til::at(mappings, idx));
-            }
-        }
-
-        if (previousFg != fg)
-        {
-            switch (fg.GetType())
-            {
-            case ColorType::IsDefault:
-                buffer.append(L"\x1b[39m");
-                break;
-            case ColorType::IsIndex16:
-            {
-                uint8_t index = WI_IsFlagSet(fg.GetIndex(), 8) ? 90 : 30;
-                index += fg.GetIndex() & 7;
-                fmt::format_to(std::back_inserter(buffer), FMT_COMPILE(L"\x1b[{}m"), index);
-                break;
-            }
-            case ColorType::IsIndex256:
-                fmt::format_to(std::back_inserter(buffer), FMT_COMPILE(L"\x1b[38;5;{}m"), fg.GetIndex());
-                break;
-            case ColorType::IsRgb:
-                fmt::format_to(std::back_inserter(buffer), FMT_COMPILE(L"\x1b[38;2;{};{};{}m"), fg.GetR(), fg.GetG(), fg.GetB());
-                break;
-            default:
-                break;
-            }
-        }
-
-        if (previousBg != bg)
-        {
-            switch (bg.GetType())
-            {
-            case ColorType::IsDefault:
-                buffer.append(L"\x1b[49m");
-                break;
-            case ColorType::IsIndex16:
-            {
-                uint8_t index = WI_IsFlagSet(bg.GetIndex(), 8) ? 100 : 40;
-                index += bg.GetIndex() & 7;
-                fmt::format_to(std::back_inserter(buffer), FMT_COMPILE(L"\x1b[{}m"), index);
-                break;
-            }
-            case ColorType::IsIndex256:
-                fmt::format_to(std::back_inserter(buffer), FMT_COMPILE(L"\x1b[48;5;{}m"), bg.GetIndex());
-                break;
-            case ColorType::IsRgb:
-                fmt::format_to(std::back_inserter(buffer), FMT_COMPILE(L"\x1b[48;2;{};{};{}m"), bg.GetR(), bg.GetG(), bg.GetB());
-                break;
-            default:
-                break;
-            }
-        }
-
-        if (previousUl != ul)
-        {
-            switch (fg.GetType())
-            {
-            case ColorType::IsDefault:
-                buffer.append(L"\x1b[59m");
-                break;
-            case ColorType::IsIndex256:
-                fmt::format_to(std::back_inserter(buffer), FMT_COMPILE(L"\x1b[58:5:{}m"), ul.GetIndex());
-                break;
-            case ColorType::IsRgb:
-                fmt::format_to(std::back_inserter(buffer), FMT_COMPILE(L"\x1b[58:2::{}:{}:{}m"), ul.GetR(), ul.GetG(), ul.GetB());
-                break;
-            default:
-                break;
-            }
-        }
+        sgr.AppendTransition(buffer, effectivePreviousTextAttr, it->value);
 
         if (previousHyperlinkId != hyperlinkId)
         {
@@ -57,6 +57,7 @@ filling in the last row, and updating the screen.
 #include "../buffer/out/textBufferCellIterator.hpp"
 #include "../buffer/out/textBufferTextIterator.hpp"
 
+class SgrEncoder;
 struct URegularExpression;
 enum class SearchFlag : unsigned int;
 
@@ -121,6 +122,9 @@ public:
                                  const std::optional<bool> setWrap = std::nullopt,
                                  const std::optional<til::CoordType> limitRight = std::nullopt);
 
+    void WriteCharInfos(const til::point target, const std::span<const CHAR_INFO> infos);
+    void FillCells(const til::point target, const size_t length, const wchar_t* ch, const TextAttribute* attr);
+
     // Scroll needs access to this to quickly rotate around the buffer.
     void IncrementCircularBuffer(const TextAttribute& fillAttributes = {});
 
@@ -155,6 +159,7 @@ public:
     til::point BufferToScreenPosition(const til::point position) const;
 
     void Reset() noexcept;
+    void TrimCommittedMemory() noexcept;
     void ClearScrollback(const til::CoordType start, const til::CoordType height);
 
     void ResizeTraditional(const til::size newSize);
@@ -284,6 +289,9 @@ public:
                        std::function<std::tuple<COLORREF, COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors) const noexcept;
 
     void SerializeTo(HANDLE handle) const;
+    void SerializeSnapshotTo(HANDLE handle) const;
+    static std::optional<til::size> GetSnapshotSize(std::string_view data) noexcept;
+    bool LoadSnapshot(std::string_view data);
 
     struct PositionInformation
     {
@@ -337,7 +345,7 @@ private:
 
     std::tuple<til::CoordType, til::CoordType, bool> _RowCopyHelper(const CopyRequest& req, const til::CoordType iRow, const ROW& row) const;
 
-    void _SerializeRow(const ROW& row, const til::CoordType startX, const til::CoordType endX, const bool addLineBreak, const bool isLastRow, std::wstring& buffer, std::optional<TextAttribute>& previousTextAttr, bool& delayedLineBreak) const;
+    void _SerializeRow(const ROW& row, const til::CoordType startX, const til::CoordType endX, const bool addLineBreak, const bool isLastRow, std::wstring& buffer, std::optional<TextAttribute>& previousTextAttr, bool& delayedLineBreak, SgrEncoder& sgr) const;
 
     static void _AppendRTFText(std::string& contentBuilder, const std::wstring_view& text);
 
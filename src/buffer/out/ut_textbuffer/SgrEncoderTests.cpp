@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../SgrEncoder.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class SgrEncoderTests
+{
+    TEST_CLASS(SgrEncoderTests);
+
+    TEST_METHOD(IdenticalAttributesEmitNothing);
+    TEST_METHOD(TransitionsAreCombined);
+    TEST_METHOD(IntenseAndFaint);
+    TEST_METHOD(ResetMatchesLegacyFormat);
+    TEST_METHOD(CachedResultsMatchUncached);
+};
+
+void SgrEncoderTests::IdenticalAttributesEmitNothing()
+{
+    SgrEncoder sgr;
+    std::wstring actual;
+
+    TextAttribute attr{ RGB(1, 2, 3), RGB(4, 5, 6) };
+    sgr.AppendTransition(actual, attr, attr);
+    VERIFY_ARE_EQUAL(L"", actual);
+
+    // Hyperlinks aren't part of SGR.
+    auto linked = attr;
+    linked.SetHyperlinkId(42);
+    sgr.AppendTransition(actual, attr, linked);
+    VERIFY_ARE_EQUAL(L"", actual);
+}
+
+void SgrEncoderTests::TransitionsAreCombined()
+{
+    SgrEncoder sgr;
+    std::wstring actual;
+
+    TextAttribute previous;
+    TextAttribute next;
+    next.SetItalic(true);
+    next.SetUnderlineStyle(UnderlineStyle::CurlyUnderlined);
+    next.SetIndexedForeground(TextColor::BRIGHT_RED);
+    next.SetIndexedBackground256(123);
+    next.SetUnderlineColor(TextColor{ RGB(1, 2, 3) });
+
+    sgr.AppendTransition(actual, previous, next);
+    VERIFY_ARE_EQUAL(L"\x1b[3;4:3;91;48;5;123;58:2::1:2:3m", actual);
+
+    // ...and back again.
+    actual.clear();
+    sgr.AppendTransition(actual, next, previous);
+    VERIFY_ARE_EQUAL(L"\x1b[23;24;39;49;59m", actual);
+}
+
+void SgrEncoderTests::IntenseAndFaint()
+{
+    SgrEncoder sgr;
+    std::string actual;
+
+    TextAttribute intense;
+    intense.SetIntense(true);
+    TextAttribute faint;
+    faint.SetFaint(true);
+    auto both = intense;
+    both.SetFaint(true);
+
+    // SGR 22 turns off both, so we need to turn intense on again.
+    sgr.AppendTransition(actual, both, intense);
+    VERIFY_ARE_EQUAL("\x1b[22;1m", actual);
+
+    // Turning faint on mustn't affect intense.
+    actual.clear();
+    sgr.AppendTransition(actual, intense, both);
+    VERIFY_ARE_EQUAL("\x1b[2m", actual);
+
+    // Switching from one to the other.
+    actual.clear();
+    sgr.AppendTransition(actual, faint, intense);
+    VERIFY_ARE_EQUAL("\x1b[22;1m", actual);
+
+    actual.clear();
+    sgr.AppendTransition(actual, both, TextAttribute{});
+    VERIFY_ARE_EQUAL("\x1b[22m", actual);
+}
+
+void SgrEncoderTests::ResetMatchesLegacyFormat()
+{
+    SgrEncoder sgr;
+    std::string actual;
+
+    sgr.AppendReset(actual, TextAttribute{ FOREGROUND_RED | BACKGROUND_GREEN });
+    VERIFY_ARE_EQUAL("\x1b[0;31;42m", actual);
+
+    actual.clear();
+    sgr.AppendReset(actual, TextAttribute{ FOREGROUND_BLUE | FOREGROUND_INTENSITY | COMMON_LVB_REVERSE_VIDEO });
+    VERIFY_ARE_EQUAL("\x1b[0;7;94;40m", actual);
+
+    actual.clear();
+    sgr.AppendReset(actual, TextAttribute{});
+    VERIFY_ARE_EQUAL("\x1b[0m", actual);
+}
+
+void SgrEncoderTests::CachedResultsMatchUncached()
+{
+    // Exercise more attribute pairs than there are cache slots, so that entries get evicted and recomputed.
+    SgrEncoder sgr;
+    std::string cached;
+    char uncached[SgrEncoder::MaxParamsLength];
+
+    for (WORD a = 0; a < 256; a += 7)
+    {
+        for (WORD b = 0; b < 256; b += 11)
+        {
+            const TextAttribute previous{ a };
+            const TextAttribute next{ b };
+
+            cached.clear();
+            sgr.AppendTransition(cached, previous, next);
+
+            const auto end = SgrEncoder::FormatParams(&uncached[0], previous, next);
+            const std::string_view params{ &uncached[0], end };
+            const auto expected = params.empty() ? std::string{} : "\x1b[" + std::string{ params.substr(1) } + "m";
+
+            if (cached != expected)
+            {
+                VERIFY_ARE_EQUAL(expected, cached);
+            }
+        }
+    }
+}
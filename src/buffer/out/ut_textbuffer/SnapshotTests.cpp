@@ -0,0 +1,239 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class SnapshotTests
+{
+    TEST_CLASS(SnapshotTests);
+
+    TEST_METHOD(RoundTrip);
+    TEST_METHOD(RejectsInvalidData);
+    TEST_METHOD(RejectsInvalidEnums);
+    TEST_METHOD(KeepsLastRowsIfTooLarge);
+
+    static DummyRenderer renderer;
+
+    static std::string _serialize(const TextBuffer& buffer)
+    {
+        wchar_t tempPath[MAX_PATH];
+        wchar_t tempFile[MAX_PATH];
+        VERIFY_ARE_NOT_EQUAL(0u, GetTempPathW(MAX_PATH, &tempPath[0]));
+        VERIFY_ARE_NOT_EQUAL(0u, GetTempFileNameW(&tempPath[0], L"wts", 0, &tempFile[0]));
+
+        const wil::unique_hfile file{ CreateFileW(&tempFile[0], GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr) };
+        VERIFY_IS_TRUE(file.is_valid());
+
+        buffer.SerializeSnapshotTo(file.get());
+
+        LARGE_INTEGER size{};
+        VERIFY_WIN32_BOOL_SUCCEEDED(GetFileSizeEx(file.get(), &size));
+        VERIFY_WIN32_BOOL_SUCCEEDED(SetFilePointerEx(file.get(), {}, nullptr, FILE_BEGIN));
+
+        std::string data;
+        data.resize(gsl::narrow_cast<size_t>(size.QuadPart));
+        DWORD read = 0;
+        VERIFY_WIN32_BOOL_SUCCEEDED(ReadFile(file.get(), data.data(), gsl::narrow_cast<DWORD>(data.size()), &read, nullptr));
+        VERIFY_ARE_EQUAL(data.size(), static_cast<size_t>(read));
+        return data;
+    }
+};
+
+DummyRenderer SnapshotTests::renderer{};
+
+void SnapshotTests::RoundTrip()
+{
+    TextBuffer source{ { 10, 20 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+
+    // Row 0: plain text with a wrap and an attribute run in the middle.
+    {
+        auto& row = source.GetMutableRowByOffset(0);
+        row.ReplaceCharacters(0, 1, L"a");
+        row.ReplaceCharacters(1, 1, L"b");
+        row.ReplaceCharacters(2, 1, L"c");
+        row.ReplaceAttributes(1, 3, TextAttribute{ RGB(255, 0, 0), RGB(0, 0, 255) });
+        row.SetWrapForced(true);
+    }
+    // Row 1: a wide glyph and a surrogate pair, which require non-trivial char offsets.
+    {
+        auto& row = source.GetMutableRowByOffset(1);
+        row.ReplaceCharacters(0, 2, L"\u732B");
+        row.ReplaceCharacters(2, 2, L"\U0001F600");
+        row.SetLineRendition(LineRendition::DoubleWidth);
+    }
+    // Row 2: a hyperlink and a prompt mark.
+    {
+        const auto id = source.GetHyperlinkId(L"https://example.com", L"custom");
+        source.AddHyperlinkToMap(L"https://example.com", id);
+
+        auto linked = TextAttribute{ 0x7 };
+        linked.SetHyperlinkId(id);
+
+        auto& row = source.GetMutableRowByOffset(2);
+        row.ReplaceCharacters(0, 1, L"x");
+        row.ReplaceAttributes(0, 1, linked);
+        row.SetScrollbarData(ScrollbarData{ .category = MarkCategory::Prompt, .color = til::color{ 1, 2, 3 }, .exitCode = 42 });
+    }
+
+    const auto data = _serialize(source);
+
+    const auto size = TextBuffer::GetSnapshotSize(data);
+    VERIFY_IS_TRUE(size.has_value());
+    VERIFY_ARE_EQUAL(til::size(10, 3), *size);
+
+    TextBuffer target{ *size, TextAttribute{ 0x7 }, 0, false, &renderer };
+    VERIFY_IS_TRUE(target.LoadSnapshot(data));
+
+    for (til::CoordType y = 0; y < size->height; ++y)
+    {
+        const auto& expected = source.GetRowByOffset(y);
+        const auto& actual = target.GetRowByOffset(y);
+        VERIFY_ARE_EQUAL(expected.GetText(), actual.GetText());
+        VERIFY_ARE_EQUAL(expected.WasWrapForced(), actual.WasWrapForced());
+        VERIFY_IS_TRUE(expected.GetLineRendition() == actual.GetLineRendition());
+        VERIFY_IS_TRUE(expected.Attributes() == actual.Attributes());
+        for (til::CoordType x = 0; x < size->width; ++x)
+        {
+            VERIFY_IS_TRUE(expected.DbcsAttrAt(x) == actual.DbcsAttrAt(x));
+        }
+    }
+
+    const auto& scrollbar = target.GetRowByOffset(2).GetScrollbarData();
+    VERIFY_IS_TRUE(scrollbar.has_value());
+    VERIFY_IS_TRUE(MarkCategory::Prompt == scrollbar->category);
+    VERIFY_ARE_EQUAL(til::color(1, 2, 3), scrollbar->color.value());
+    VERIFY_ARE_EQUAL(42u, scrollbar->exitCode.value());
+
+    const auto id = target.GetRowByOffset(2).GetAttrByColumn(0).GetHyperlinkId();
+    VERIFY_ARE_EQUAL(L"https://example.com", target.GetHyperlinkUriFromId(id));
+    VERIFY_ARE_EQUAL(id, target.GetHyperlinkId(L"https://example.com", L"custom"));
+}
+
+void SnapshotTests::RejectsInvalidData()
+{
+    TextBuffer source{ { 10, 5 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+    source.GetMutableRowByOffset(1).ReplaceCharacters(0, 2, L"\u732B");
+    const auto data = _serialize(source);
+
+    // The VT serialization used by older versions starts with a UTF-16 BOM.
+    VERIFY_IS_FALSE(TextBuffer::GetSnapshotSize(std::string_view{ "\xff\xfe\x1b\x00[\x00m\x00", 8 }).has_value());
+
+    // The snapshot must be exactly as wide as the buffer it's loaded into.
+    {
+        TextBuffer target{ { 11, 5 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+        VERIFY_IS_FALSE(target.LoadSnapshot(data));
+    }
+
+    // Truncated files are rejected...
+    {
+        TextBuffer target{ { 10, 5 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+        VERIFY_IS_FALSE(target.LoadSnapshot(std::string_view{ data }.substr(0, data.size() - 1)));
+    }
+
+    // ...and so are inconsistent attribute runs, which leave the affected row blank.
+    {
+        auto corrupted = data;
+        corrupted.back() ^= 0x7f;
+        TextBuffer target{ { 10, 5 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+        VERIFY_IS_FALSE(target.LoadSnapshot(corrupted));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"          " }, target.GetRowByOffset(1).GetText());
+    }
+
+    // A row count that the data can't possibly hold is rejected before anything gets allocated.
+    {
+        static constexpr size_t rowCountOffset = 12;
+        auto corrupted = data;
+        const uint32_t rowCount = 0x7fffffff;
+        memcpy(corrupted.data() + rowCountOffset, &rowCount, sizeof(rowCount));
+        VERIFY_IS_FALSE(TextBuffer::GetSnapshotSize(corrupted).has_value());
+    }
+}
+
+void SnapshotTests::RejectsInvalidEnums()
+{
+    // Returns a copy of `data` with the first byte after `needle` replaced by `value`.
+    const auto corruptAfter = [](const std::string& data, const std::string_view& needle, char value) {
+        const auto pos = data.find(needle);
+        VERIFY_ARE_NOT_EQUAL(std::string::npos, pos);
+        auto corrupted = data;
+        corrupted[pos + needle.size()] = value;
+        return corrupted;
+    };
+
+    {
+        Log::Comment(L"Colors with an invalid type");
+        TextBuffer source{ { 10, 1 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+        source.GetMutableRowByOffset(0).ReplaceAttributes(0, 1, TextAttribute{ RGB(0x12, 0x34, 0x56), RGB(0, 0, 0) });
+        const auto data = _serialize(source);
+
+        // A TextColor is stored as {red, green, blue, type}.
+        const auto corrupted = corruptAfter(data, "\x12\x34\x56", 0x7f);
+        TextBuffer target{ { 10, 1 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+        VERIFY_IS_FALSE(target.LoadSnapshot(corrupted));
+    }
+
+    {
+        Log::Comment(L"Scrollbar marks with an invalid category");
+        TextBuffer source{ { 10, 1 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+        source.GetMutableRowByOffset(0).SetScrollbarData(ScrollbarData{ .category = MarkCategory::Prompt, .exitCode = 0x0badf00d });
+        const auto data = _serialize(source);
+
+        // The category is the first member of the trailing RowSnapshotScrollbar,
+        // which is followed by 3 bytes of flags, the color and the exit code.
+        auto corrupted = data;
+        const std::string_view exitCode{ "\x0d\xf0\xad\x0b", 4 };
+        const auto pos = corrupted.rfind(exitCode);
+        VERIFY_ARE_NOT_EQUAL(std::string::npos, pos);
+        corrupted[pos - 8] = 0x7f;
+
+        TextBuffer target{ { 10, 1 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+        VERIFY_IS_TRUE(target.LoadSnapshot(data));
+        VERIFY_IS_FALSE(target.LoadSnapshot(corrupted));
+    }
+
+    {
+        Log::Comment(L"Hyperlink IDs that aren't part of the snapshot");
+        TextBuffer source{ { 10, 1 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+        auto linked = TextAttribute{ 0x7 };
+        linked.SetHyperlinkId(0x1234);
+        source.GetMutableRowByOffset(0).ReplaceCharacters(0, 1, L"x");
+        source.GetMutableRowByOffset(0).ReplaceAttributes(0, 1, linked);
+        const auto data = _serialize(source);
+
+        TextBuffer target{ { 10, 1 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+        VERIFY_IS_FALSE(target.LoadSnapshot(data));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"          " }, target.GetRowByOffset(0).GetText());
+    }
+}
+
+void SnapshotTests::KeepsLastRowsIfTooLarge()
+{
+    TextBuffer source{ { 10, 20 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+    for (til::CoordType y = 0; y < 10; ++y)
+    {
+        source.GetMutableRowByOffset(y).ReplaceCharacters(0, 1, std::to_wstring(y));
+    }
+    const auto data = _serialize(source);
+
+    const auto size = TextBuffer::GetSnapshotSize(data);
+    VERIFY_IS_TRUE(size.has_value());
+    VERIFY_ARE_EQUAL(til::size(10, 10), *size);
+
+    TextBuffer target{ { 10, 4 }, TextAttribute{ 0x7 }, 0, false, &renderer };
+    VERIFY_IS_TRUE(target.LoadSnapshot(data));
+
+    for (til::CoordType y = 0; y < 4; ++y)
+    {
+        const auto expected = std::to_wstring(y + 6) + L"         ";
+        VERIFY_ARE_EQUAL(std::wstring_view{ expected }, target.GetRowByOffset(y).GetText());
+    }
+}
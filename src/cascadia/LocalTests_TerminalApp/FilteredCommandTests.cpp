@@ -40,6 +40,7 @@ namespace TerminalAppLocalTests
         TEST_METHOD(VerifyWeight);
         TEST_METHOD(VerifyCompare);
         TEST_METHOD(VerifyCompareIgnoreCase);
+        TEST_METHOD(VerifyCommandFilter);
     };
 
     static void _verifySegment(auto&& segments, uint32_t index, uint64_t start, uint64_t end)
@@ -219,4 +220,42 @@ namespace TerminalAppLocalTests
 
         VERIFY_SUCCEEDED(result);
     }
+
+    void FilteredCommandTests::VerifyCommandFilter()
+    {
+        auto result = RunOnUIThread([]() {
+            // Enough items to take the parallel path.
+            std::vector<winrt::TerminalApp::FilteredCommand> items;
+            for (auto i = 0; i < 3000; ++i)
+            {
+                const auto name = fmt::format(L"item {} {}", i % 7 ? L"foo" : L"bar", i);
+                items.emplace_back(winrt::make<winrt::TerminalApp::implementation::FilteredCommand>(winrt::make<StringPaletteItem>(name)));
+            }
+            const auto commands = winrt::single_threaded_vector(std::move(items));
+
+            // Filtering incrementally must give the same results as filtering from scratch.
+            winrt::TerminalApp::implementation::CommandFilter incremental;
+            for (const auto query : { L"", L"i", L"ibar", L"ibar 1", L"ibar 12", L"ibar 1" })
+            {
+                Log::Comment(NoThrowString().Format(L"Filtering for \"%s\"", query));
+
+                const auto actual = incremental.Filter(commands, query, true);
+                const auto expected = winrt::TerminalApp::implementation::CommandFilter{}.Filter(commands, query, true);
+
+                VERIFY_ARE_EQUAL(expected.size(), actual.size());
+                for (size_t i = 0; i < expected.size(); ++i)
+                {
+                    VERIFY_ARE_EQUAL(expected[i], actual[i]);
+                }
+            }
+
+            Log::Comment(L"The filter remembers the matches of the previous query");
+            VERIFY_ARE_EQUAL(3000u, incremental.Filter(commands, L"", false).size());
+            const auto bars = incremental.Filter(commands, L"bar", false).size();
+            VERIFY_ARE_EQUAL(429u, bars);
+            VERIFY_ARE_EQUAL(bars, incremental._matches.size());
+        });
+
+        VERIFY_SUCCEEDED(result);
+    }
 }
@@ -4,6 +4,7 @@
 #include "pch.h"
 
 #include "../TerminalApp/TerminalPage.h"
+#include "../TerminalApp/TerminalSettingsCache.h"
 #include "../UnitTests_SettingsModel/TestUtils.h"
 #include "../TerminalSettingsAppAdapterLib/TerminalSettings.h"
 
@@ -73,6 +74,8 @@ namespace TerminalAppLocalTests
 
         TEST_METHOD(TestElevateArg);
 
+        TEST_METHOD(TestSettingsCacheAfterThemeChange);
+
         TEST_CLASS_SETUP(ClassSetup)
         {
             return true;
@@ -1619,4 +1622,71 @@ namespace TerminalAppLocalTests
         }
     }
 
+    void SettingsTests::TestSettingsCacheAfterThemeChange()
+    {
+        // A profile's TerminalSettings don't just depend on the settings model, but also on
+        // whether the OS is in dark mode. Toggling that reloads the settings, but leaves the
+        // model itself unchanged. The cache must then not conclude that nothing changed.
+        // We can't toggle the OS theme in a test, so we switch between two themes instead.
+
+        static constexpr std::wstring_view lightJson{ LR"(
+        {
+            "defaultProfile": "{6239a42c-0000-49a3-80bd-e8fdd045185c}",
+            "theme": "lighty",
+            "themes": [
+                { "name": "lighty", "window": { "applicationTheme": "light" } },
+                { "name": "darky", "window": { "applicationTheme": "dark" } }
+            ],
+            "schemes": [{ "name": "Midnight", "foreground": "#FFFFFF", "background": "#000080" }],
+            "profiles": [
+                {
+                    "name": "profile0",
+                    "guid": "{6239a42c-0000-49a3-80bd-e8fdd045185c}",
+                    "colorScheme": { "light": "Campbell", "dark": "Midnight" }
+                }
+            ]
+        })" };
+        static constexpr std::wstring_view darkJson{ LR"(
+        {
+            "defaultProfile": "{6239a42c-0000-49a3-80bd-e8fdd045185c}",
+            "theme": "darky",
+            "themes": [
+                { "name": "lighty", "window": { "applicationTheme": "light" } },
+                { "name": "darky", "window": { "applicationTheme": "dark" } }
+            ],
+            "schemes": [{ "name": "Midnight", "foreground": "#FFFFFF", "background": "#000080" }],
+            "profiles": [
+                {
+                    "name": "profile0",
+                    "guid": "{6239a42c-0000-49a3-80bd-e8fdd045185c}",
+                    "colorScheme": { "light": "Campbell", "dark": "Midnight" }
+                }
+            ]
+        })" };
+
+        CascadiaSettings lightSettings{ lightJson, inboxSettings };
+        CascadiaSettings darkSettings{ darkJson, inboxSettings };
+        VERIFY_ARE_EQUAL(0u, lightSettings.Warnings().Size());
+        VERIFY_ARE_EQUAL(0u, darkSettings.Warnings().Size());
+
+        const auto profile{ lightSettings.ActiveProfiles().GetAt(0) };
+        winrt::TerminalApp::implementation::TerminalSettingsCache cache{ lightSettings };
+
+        Log::Comment(L"Settings that were never handed out before the reload can't be assumed to be unchanged.");
+        cache.Reset(lightSettings);
+        VERIFY_IS_FALSE(cache.IsUnchanged(profile));
+
+        Log::Comment(L"Once they were handed out, reloading the same settings is a no-op.");
+        VERIFY_IS_TRUE(cache.TryLookup(profile).has_value());
+        cache.Reset(lightSettings);
+        VERIFY_IS_TRUE(cache.IsUnchanged(profile));
+
+        Log::Comment(L"Switching from the light to the dark theme switches the color scheme.");
+        cache.Reset(darkSettings);
+        VERIFY_IS_FALSE(cache.IsUnchanged(profile));
+
+        cache.Reset(darkSettings);
+        VERIFY_IS_TRUE(cache.IsUnchanged(profile));
+    }
+
 }
@@ -84,6 +84,7 @@ namespace TerminalAppLocalTests
         TEST_METHOD(CloseZoomedPane);
 
         TEST_METHOD(SwapPanes);
+        TEST_METHOD(CachedSnappingMatchesUncached);
 
         TEST_METHOD(NextMRUTab);
         TEST_METHOD(VerifyCommandPaletteTabSwitcherOrder);
@@ -1045,6 +1046,76 @@ namespace TerminalAppLocalTests
         });
     }
 
+    void TabTests::CachedSnappingMatchesUncached()
+    {
+        auto page = _commonSetup();
+
+        Log::Comment(L"Setup 3 panes.");
+        // -------------------
+        // |        |   2    |
+        // |   1    |--------|
+        // |        |   3    |
+        // -------------------
+        TestOnUIThread([&]() {
+            page->_SplitPane(nullptr, SplitDirection::Right, 0.5f, page->_MakePane(nullptr, page->_GetFocusedTab(), nullptr));
+        });
+        Sleep(250);
+        TestOnUIThread([&]() {
+            page->_SplitPane(nullptr, SplitDirection::Down, 0.3f, page->_MakePane(nullptr, page->_GetFocusedTab(), nullptr));
+        });
+        Sleep(250);
+
+        // Snaps a sequence of sizes, with every call resuming from the cache the previous one
+        // left behind (unless it's smaller), and compares that to snapping each size from scratch.
+        // The sequence ends with its smallest size, so that the next call to this function
+        // resumes from that cache, unless the change in between invalidated it.
+        const auto verifySnapping = [&](const wchar_t* description) {
+            Log::Comment(description);
+            TestOnUIThread([&]() {
+                const auto tab = page->_GetTabImpl(page->_tabs.GetAt(0));
+                for (const auto widthOrHeight : { true, false })
+                {
+                    static constexpr std::array sizes{ 700.0f, 701.0f, 717.5f, 850.0f, 1200.0f, 1600.0f, 1000.0f, 400.0f };
+                    std::array<float, sizes.size()> cached{};
+                    for (size_t i = 0; i < sizes.size(); ++i)
+                    {
+                        cached[i] = tab->_rootPane->CalcSnappedDimension(widthOrHeight, sizes[i]);
+                    }
+                    for (size_t i = 0; i < sizes.size(); ++i)
+                    {
+                        ::Pane::_InvalidateLayoutCaches();
+                        VERIFY_ARE_EQUAL(tab->_rootPane->CalcSnappedDimension(widthOrHeight, sizes[i]), cached[i]);
+                    }
+                }
+                // Invalidating the cache above affects both dimensions.
+                // Leave a valid one behind for each of them.
+                tab->_rootPane->CalcSnappedDimension(true, 400.0f);
+                tab->_rootPane->CalcSnappedDimension(false, 400.0f);
+            });
+        };
+
+        verifySnapping(L"Snap with a cold cache");
+        verifySnapping(L"Snap with a warm cache");
+
+        TestOnUIThread([&]() {
+            const auto tab = page->_GetTabImpl(page->_tabs.GetAt(0));
+            VERIFY_IS_TRUE(tab->_rootPane->_Resize(ResizeDirection::Left));
+        });
+        verifySnapping(L"Snap after moving the separator");
+
+        TestOnUIThread([&]() {
+            const auto tab = page->_GetTabImpl(page->_tabs.GetAt(0));
+            tab->GetActiveTerminalControl().AdjustFontSize(4.0f);
+        });
+        verifySnapping(L"Snap after changing the font size");
+
+        TestOnUIThread([&]() {
+            page->_SplitPane(nullptr, SplitDirection::Right, 0.5f, page->_MakePane(nullptr, page->_GetFocusedTab(), nullptr));
+        });
+        Sleep(250);
+        verifySnapping(L"Snap after splitting another pane");
+    }
+
     void TabTests::NextMRUTab()
     {
         // This is a test for GH#8025 - we want to make sure that MRU tab
@@ -1197,28 +1197,11 @@ namespace winrt::TerminalApp::implementation
         }
         else if (_currentMode == CommandPaletteMode::TabSearchMode || _currentMode == CommandPaletteMode::ActionMode || _currentMode == CommandPaletteMode::CommandlineMode)
         {
-            auto pattern = std::make_shared<fzf::matcher::Pattern>(fzf::matcher::ParsePattern(searchText));
-
-            for (const auto& action : commandsToFilter)
-            {
-                // Update filter for all commands
-                // This will modify the highlighting but will also lead to re-computation of weight (and consequently sorting).
-                // Pay attention that it already updates the highlighting in the UI
-                auto impl = winrt::get_self<implementation::FilteredCommand>(action);
-                impl->UpdateFilter(pattern);
-
-                // if there is active search we skip commands with 0 weight
-                if (searchText.empty() || action.Weight() > 0)
-                {
-                    actions.push_back(action);
-                }
-            }
-        }
-
-        // We want to present the commands sorted
-        if (_currentMode == CommandPaletteMode::ActionMode)
-        {
-            std::sort(actions.begin(), actions.end(), FilteredCommand::Compare);
+            // Update filter for all commands
+            // This will modify the highlighting but will also lead to re-computation of weight (and consequently sorting).
+            // Pay attention that it already updates the highlighting in the UI
+            // In the action mode we want to present the commands sorted.
+            actions = _commandFilter.Filter(commandsToFilter, searchText, _currentMode == CommandPaletteMode::ActionMode);
         }
 
         return actions;
@@ -5,6 +5,8 @@
 #include "CommandPalette.h"
 #include "fzf/fzf.h"
 
+#include <til/parallel.h>
+
 #include "FilteredCommand.g.cpp"
 
 using namespace winrt;
@@ -29,10 +31,14 @@ namespace winrt::TerminalApp::implementation
             const auto property{ e.PropertyName() };
             if (property == L"Name")
             {
+                _textStale = true;
+                _textChangedSinceFilter = true;
                 _update();
             }
             else if (property == L"Subtitle")
             {
+                _textStale = true;
+                _textChangedSinceFilter = true;
                 _update();
                 PropertyChanged.raise(*this, winrt::Windows::UI::Xaml::Data::PropertyChangedEventArgs{ L"HasSubtitle" });
             }
@@ -55,14 +61,14 @@ namespace winrt::TerminalApp::implementation
         return !_Item.Subtitle().empty();
     }
 
-    static std::tuple<std::vector<winrt::TerminalApp::HighlightedRun>, int32_t> _matchedSegmentsAndWeight(const std::shared_ptr<fzf::matcher::Pattern>& pattern, const winrt::hstring& haystack)
+    static std::tuple<std::vector<winrt::TerminalApp::HighlightedRun>, int32_t> _matchedSegmentsAndWeight(const fzf::matcher::Pattern* pattern, const fzf::matcher::PreparedText& haystack)
     {
         std::vector<winrt::TerminalApp::HighlightedRun> segments;
         int32_t weight = 0;
 
         if (pattern && !pattern->terms.empty())
         {
-            if (auto match = fzf::matcher::Match(haystack, *pattern.get()); match)
+            if (auto match = fzf::matcher::Match(haystack, *pattern); match)
             {
                 auto& matchResult = *match;
                 weight = matchResult.Score;
@@ -77,37 +83,65 @@ namespace winrt::TerminalApp::implementation
 
     void FilteredCommand::_update()
     {
-        auto itemName = _Item.Name();
-        auto [segments, weight] = _matchedSegmentsAndWeight(_pattern, itemName);
-        decltype(segments) subtitleSegments;
+        _prepareText();
+        _apply(_pattern, _match(_pattern.get()));
+    }
 
-        if (HasSubtitle())
+    // Converts the item's name and subtitle for fzf, unless that's already been done.
+    // This calls into _Item and must thus happen on the UI thread.
+    void FilteredCommand::_prepareText()
+    {
+        if (!_textStale)
+        {
+            return;
+        }
+
+        _name = _Item.Name();
+        _preparedName = fzf::matcher::PrepareText(_name);
+        _preparedSubtitle = HasSubtitle() ? fzf::matcher::PrepareText(_Item.Subtitle()) : fzf::matcher::PreparedText{};
+        _textStale = false;
+    }
+
+    // Scores the prepared text against the given pattern. This only reads state
+    // that _prepareText() computed, so CommandFilter may call it from any thread.
+    FilteredCommand::MatchResult FilteredCommand::_match(const fzf::matcher::Pattern* pattern) const
+    {
+        MatchResult result;
+        std::tie(result.nameRuns, result.weight) = _matchedSegmentsAndWeight(pattern, _preparedName);
+
+        if (!_preparedSubtitle.codePoints.empty())
         {
-            auto itemSubtitle = _Item.Subtitle();
             int32_t subtitleWeight = 0;
-            std::tie(subtitleSegments, subtitleWeight) = _matchedSegmentsAndWeight(_pattern, itemSubtitle);
-            weight = std::max(weight, subtitleWeight);
+            std::tie(result.subtitleRuns, subtitleWeight) = _matchedSegmentsAndWeight(pattern, _preparedSubtitle);
+            result.weight = std::max(result.weight, subtitleWeight);
         }
 
-        if (segments.empty())
+        return result;
+    }
+
+    void FilteredCommand::_apply(std::shared_ptr<fzf::matcher::Pattern> pattern, MatchResult&& result)
+    {
+        _pattern = std::move(pattern);
+
+        if (result.nameRuns.empty())
         {
             NameHighlights(nullptr);
         }
         else
         {
-            NameHighlights(winrt::single_threaded_vector(std::move(segments)));
+            NameHighlights(winrt::single_threaded_vector(std::move(result.nameRuns)));
         }
 
-        if (subtitleSegments.empty())
+        if (result.subtitleRuns.empty())
         {
             SubtitleHighlights(nullptr);
         }
         else
         {
-            SubtitleHighlights(winrt::single_threaded_vector(std::move(subtitleSegments)));
+            SubtitleHighlights(winrt::single_threaded_vector(std::move(result.subtitleRuns)));
         }
 
-        Weight(weight);
+        Weight(result.weight);
     }
 
     // Function Description:
@@ -132,4 +166,122 @@ namespace winrt::TerminalApp::implementation
 
         return firstWeight > secondWeight;
     }
+
+    // Below this many items, scoring them on the calling thread is
+    // faster than handing them off to the thread pool.
+    static constexpr size_t ParallelFilterThreshold = 1024;
+    static constexpr size_t ParallelFilterChunkSize = 256;
+
+    // Method Description:
+    // - Updates the highlighting and weight of the given commands for the searchText
+    //   and returns those that match, optionally sorted like FilteredCommand::Compare.
+    // - If the commands are the same as during the previous call and the searchText
+    //   only extends the previous one, only the previous matches are scored again.
+    //   This works because a query can only match if all of its prefixes match as well.
+    // Arguments:
+    // - commands: the commands to filter
+    // - searchText: the text the user typed
+    // - sort: if true, the matches are sorted by weight and then by name.
+    //   Otherwise they're returned in their original order.
+    // Return Value:
+    // - the matching commands
+    std::vector<winrt::TerminalApp::FilteredCommand> CommandFilter::Filter(const IVector<winrt::TerminalApp::FilteredCommand>& commands, const winrt::hstring& searchText, const bool sort)
+    {
+        std::vector<winrt::TerminalApp::FilteredCommand> candidates(commands.Size(), nullptr);
+        commands.GetMany(0, candidates);
+
+        const auto incremental = candidates == _candidates &&
+                                 std::wstring_view{ searchText }.starts_with(_searchText) &&
+                                 std::ranges::none_of(candidates, [](const auto& c) { return winrt::get_self<FilteredCommand>(c)->_textChangedSinceFilter; });
+
+        std::vector<size_t> indices;
+        if (incremental)
+        {
+            indices = std::move(_matches);
+        }
+        else
+        {
+            indices.resize(candidates.size());
+            std::iota(indices.begin(), indices.end(), size_t{ 0 });
+        }
+
+        // Preparing the text calls into the palette items, so it has to happen here on the UI thread.
+        // It's cached by each FilteredCommand, so this is only expensive the first time around.
+        std::vector<FilteredCommand*> impls;
+        impls.reserve(indices.size());
+        for (const auto i : indices)
+        {
+            const auto impl = winrt::get_self<FilteredCommand>(candidates[i]);
+            impl->_prepareText();
+            impl->_textChangedSinceFilter = false;
+            impls.emplace_back(impl);
+        }
+
+        const auto pattern = std::make_shared<fzf::matcher::Pattern>(fzf::matcher::ParsePattern(searchText));
+        std::vector<FilteredCommand::MatchResult> results(impls.size());
+        const auto score = [&](const size_t beg, const size_t end) noexcept {
+            for (auto i = beg; i < end; ++i)
+            {
+                try
+                {
+                    results[i] = impls[i]->_match(pattern.get());
+                }
+                CATCH_LOG();
+            }
+        };
+
+        if (impls.size() >= ParallelFilterThreshold)
+        {
+            const auto chunkCount = (impls.size() + ParallelFilterChunkSize - 1) / ParallelFilterChunkSize;
+            til::parallel_for(chunkCount, [&](const size_t chunk) noexcept {
+                const auto beg = chunk * ParallelFilterChunkSize;
+                score(beg, std::min(impls.size(), beg + ParallelFilterChunkSize));
+            });
+        }
+        else
+        {
+            score(0, impls.size());
+        }
+
+        std::vector<size_t> matches;
+        for (size_t i = 0; i < impls.size(); ++i)
+        {
+            const auto weight = results[i].weight;
+            impls[i]->_apply(pattern, std::move(results[i]));
+
+            // if there is active search we skip commands with 0 weight
+            if (searchText.empty() || weight > 0)
+            {
+                matches.emplace_back(indices[i]);
+            }
+        }
+
+        std::vector<winrt::TerminalApp::FilteredCommand> actions;
+        actions.reserve(matches.size());
+        for (const auto i : matches)
+        {
+            actions.emplace_back(candidates[i]);
+        }
+
+        if (sort)
+        {
+            // Same order as FilteredCommand::Compare, but without calling into the palette items.
+            std::sort(actions.begin(), actions.end(), [](const auto& first, const auto& second) {
+                const auto firstImpl = winrt::get_self<FilteredCommand>(first);
+                const auto secondImpl = winrt::get_self<FilteredCommand>(second);
+                const auto firstWeight = firstImpl->Weight();
+                const auto secondWeight = secondImpl->Weight();
+                if (firstWeight == secondWeight)
+                {
+                    return til::compare_linguistic_insensitive(firstImpl->_name, secondImpl->_name) < 0;
+                }
+                return firstWeight > secondWeight;
+            });
+        }
+
+        _candidates = std::move(candidates);
+        _matches = std::move(matches);
+        _searchText = searchText;
+        return actions;
+    }
 }
@@ -33,10 +33,47 @@ namespace winrt::TerminalApp::implementation
         WINRT_OBSERVABLE_PROPERTY(int, Weight, PropertyChanged.raise);
 
     private:
+        struct MatchResult
+        {
+            std::vector<winrt::TerminalApp::HighlightedRun> nameRuns;
+            std::vector<winrt::TerminalApp::HighlightedRun> subtitleRuns;
+            int32_t weight = 0;
+        };
+
         std::shared_ptr<fzf::matcher::Pattern> _pattern;
+        // The name and subtitle of _Item, converted for fzf. They're refreshed
+        // lazily by _prepareText() whenever the item raises a change.
+        winrt::hstring _name;
+        fzf::matcher::PreparedText _preparedName;
+        fzf::matcher::PreparedText _preparedSubtitle;
+        bool _textStale = true;
+        // Set when the item's text changed and cleared by CommandFilter,
+        // which uses it to tell whether its previous results are still valid.
+        bool _textChangedSinceFilter = false;
+
         void _update();
+        void _prepareText();
+        MatchResult _match(const fzf::matcher::Pattern* pattern) const;
+        void _apply(std::shared_ptr<fzf::matcher::Pattern> pattern, MatchResult&& result);
         Windows::UI::Xaml::Data::INotifyPropertyChanged::PropertyChanged_revoker _itemChangedRevoker;
 
+        friend class CommandFilter;
+        friend class TerminalAppLocalTests::FilteredCommandTests;
+    };
+
+    // Filters a list of FilteredCommands for the CommandPalette and the SuggestionsControl.
+    // It remembers the previous query, so that typing more characters only re-scores the
+    // items that matched before, instead of the entire list. Large lists are scored in parallel.
+    class CommandFilter
+    {
+    public:
+        std::vector<winrt::TerminalApp::FilteredCommand> Filter(const Windows::Foundation::Collections::IVector<winrt::TerminalApp::FilteredCommand>& commands, const winrt::hstring& searchText, bool sort);
+
+    private:
+        std::vector<winrt::TerminalApp::FilteredCommand> _candidates;
+        std::vector<size_t> _matches;
+        winrt::hstring _searchText;
+
         friend class TerminalAppLocalTests::FilteredCommandTests;
     };
 }
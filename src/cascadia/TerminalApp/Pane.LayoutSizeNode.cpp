@@ -4,13 +4,32 @@
 #include "pch.h"
 #include "Pane.h"
 
+// Makes `dst` equal `src`, reusing the node that `dst` already owns, if any.
+template<typename T>
+static void assignNode(std::unique_ptr<T>& dst, const std::unique_ptr<T>& src)
+{
+    if (!src)
+    {
+        dst.reset();
+    }
+    else if (dst)
+    {
+        *dst = *src;
+    }
+    else
+    {
+        dst = std::make_unique<T>(*src);
+    }
+}
+
 Pane::LayoutSizeNode::LayoutSizeNode(const float minSize) :
     size{ minSize },
     isMinimumSize{ true },
     firstChild{ nullptr },
     secondChild{ nullptr },
     nextFirstChild{ nullptr },
-    nextSecondChild{ nullptr }
+    nextSecondChild{ nullptr },
+    minSize{ minSize }
 {
 }
 
@@ -20,13 +39,18 @@ Pane::LayoutSizeNode::LayoutSizeNode(const LayoutSizeNode& other) :
     firstChild{ other.firstChild ? std::make_unique<LayoutSizeNode>(*other.firstChild) : nullptr },
     secondChild{ other.secondChild ? std::make_unique<LayoutSizeNode>(*other.secondChild) : nullptr },
     nextFirstChild{ other.nextFirstChild ? std::make_unique<LayoutSizeNode>(*other.nextFirstChild) : nullptr },
-    nextSecondChild{ other.nextSecondChild ? std::make_unique<LayoutSizeNode>(*other.nextSecondChild) : nullptr }
+    nextSecondChild{ other.nextSecondChild ? std::make_unique<LayoutSizeNode>(*other.nextSecondChild) : nullptr },
+    minSize{ other.minSize },
+    firstSnappedSize{ other.firstSnappedSize },
+    cellSize{ other.cellSize },
+    alongSeparator{ other.alongSeparator },
+    desiredSplitPosition{ other.desiredSplitPosition }
 {
 }
 
 // Method Description:
 // - Makes sure that this node and all its descendants equal the supplied node.
-//   This may be more efficient that copy construction since it will reuse its
+//   This is more efficient than copy construction since it reuses its
 //   allocated children.
 // Arguments:
 // - other: Node to take the values from.
@@ -34,13 +58,131 @@ Pane::LayoutSizeNode::LayoutSizeNode(const LayoutSizeNode& other) :
 // - itself
 Pane::LayoutSizeNode& Pane::LayoutSizeNode::operator=(const LayoutSizeNode& other)
 {
+    if (this == &other)
+    {
+        return *this;
+    }
+
     size = other.size;
     isMinimumSize = other.isMinimumSize;
+    minSize = other.minSize;
+    firstSnappedSize = other.firstSnappedSize;
+    cellSize = other.cellSize;
+    alongSeparator = other.alongSeparator;
+    desiredSplitPosition = other.desiredSplitPosition;
 
-    firstChild = other.firstChild ? std::make_unique<LayoutSizeNode>(*other.firstChild) : nullptr;
-    secondChild = other.secondChild ? std::make_unique<LayoutSizeNode>(*other.secondChild) : nullptr;
-    nextFirstChild = other.nextFirstChild ? std::make_unique<LayoutSizeNode>(*other.nextFirstChild) : nullptr;
-    nextSecondChild = other.nextSecondChild ? std::make_unique<LayoutSizeNode>(*other.nextSecondChild) : nullptr;
+    assignNode(firstChild, other.firstChild);
+    assignNode(secondChild, other.secondChild);
+    assignNode(nextFirstChild, other.nextFirstChild);
+    assignNode(nextSecondChild, other.nextSecondChild);
 
     return *this;
 }
+
+// Method Description:
+// - Increases the size of this node to match the next possible 'snap'. In case of a
+//   leaf this means the next cell of the terminal. Otherwise, it means that one of its
+//   children advances (recursively). It expects this node and its descendants to have
+//   either already snapped or minimum size.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Pane::LayoutSizeNode::Advance()
+{
+    if (!firstChild)
+    {
+        // We're a leaf, so just add one more row or column. If the node is of its minimum
+        // size, this size might not be snapped (it might be, say, half a character, or
+        // fixed 10 pixels), so we snap it upward instead. For content that isn't snappable
+        // both of these are simply "one pixel larger" (see _CreateMinSizeTree()).
+        size = isMinimumSize ? firstSnappedSize : size + cellSize;
+    }
+    else
+    {
+        // We're a parent, so we have to advance our children. In fact, we advance
+        // only one child (chosen later) to keep the growth fine-grained.
+
+        // To choose which child to advance, we actually need to know their advanced sizes
+        // in advance (oh), to see which one would 'fit' better. Often, this is already cached
+        // by the previous invocation of this function in nextFirstChild and nextSecondChild.
+        // If not, we need to calculate them now.
+        if (nextFirstChild == nullptr)
+        {
+            nextFirstChild = std::make_unique<LayoutSizeNode>(*firstChild);
+            nextFirstChild->Advance();
+        }
+        if (nextSecondChild == nullptr)
+        {
+            nextSecondChild = std::make_unique<LayoutSizeNode>(*secondChild);
+            nextSecondChild->Advance();
+        }
+
+        const auto nextFirstSize = nextFirstChild->size;
+        const auto nextSecondSize = nextSecondChild->size;
+
+        // Choose which child to advance.
+        bool advanceFirstOrSecond;
+        if (alongSeparator)
+        {
+            // If we're growing along separator axis, choose the child that
+            // wants to be smaller than the other, so that the resulting size
+            // will be the smallest.
+            advanceFirstOrSecond = nextFirstSize < nextSecondSize;
+        }
+        else
+        {
+            // If we're growing perpendicularly to separator axis, choose a
+            // child so that their size ratio is closer to that we're trying
+            // to maintain (this is, the relative separator position is closer
+            // to the desiredSplitPosition field).
+
+            const auto firstSize = firstChild->size;
+            const auto secondSize = secondChild->size;
+
+            // Because we rely on equality check, these calculations have to be
+            // immune to floating point errors. In common situation where both panes
+            // have the same character sizes and desiredSplitPosition is 0.5 (or
+            // some simple fraction) both ratios will often be the same, and if so
+            // we always take the left child. It could be right as well, but it's
+            // important that it's consistent: that it would always go
+            // 1 -> 2 -> 1 -> 2 -> 1 -> 2 and not like 1 -> 1 -> 2 -> 2 -> 2 -> 1
+            // which would look silly to the user but which occur if there was
+            // a non-floating-point-safe math.
+            const auto deviation1 = nextFirstSize - (nextFirstSize + secondSize) * desiredSplitPosition;
+            const auto deviation2 = -1 * (firstSize - (firstSize + nextSecondSize) * desiredSplitPosition);
+            advanceFirstOrSecond = deviation1 <= deviation2;
+        }
+
+        // Here we advance one of our children. Because we already know the appropriate
+        // (advanced) size that given child would need to have, we simply assign that size
+        // to it. We then advance its 'next*' size (nextFirstChild or nextSecondChild) so
+        // the invariant holds (as it will likely be used by the next invocation of this
+        // function). The other child's next* size remains unchanged because its size
+        // haven't changed either.
+        if (advanceFirstOrSecond)
+        {
+            *firstChild = *nextFirstChild;
+            nextFirstChild->Advance();
+        }
+        else
+        {
+            *secondChild = *nextSecondChild;
+            nextSecondChild->Advance();
+        }
+
+        // Since the size of one of our children has changed we need to update our size as well.
+        if (alongSeparator)
+        {
+            size = std::max(firstChild->size, secondChild->size);
+        }
+        else
+        {
+            size = firstChild->size + secondChild->size;
+        }
+    }
+
+    // Because we have grown, we're certainly no longer of our
+    // minimal size (if we've ever been).
+    isMinimumSize = false;
+}
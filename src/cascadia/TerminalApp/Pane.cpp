@@ -27,6 +27,8 @@ static const int CombinedPaneBorderSize = 2 * PaneBorderSize;
 static const int AnimationDurationInMilliseconds = 200;
 static const Duration AnimationDuration = DurationHelper::FromTimeSpan(winrt::Windows::Foundation::TimeSpan(std::chrono::milliseconds(AnimationDurationInMilliseconds)));
 
+std::atomic<uint64_t> Pane::_layoutGeneration{ 0 };
+
 Pane::Pane(IPaneContent content, const bool lastFocused) :
     _lastActive{ lastFocused }
 {
@@ -1297,6 +1299,9 @@ void Pane::UpdateSettings(const CascadiaSettings& settings)
     {
         _content.UpdateSettings(settings);
     }
+
+    // The font and padding may have changed.
+    _InvalidateLayoutCaches();
 }
 
 // Method Description:
@@ -1732,6 +1737,8 @@ void Pane::_SetupChildCloseHandlers()
 IPaneContent Pane::_takePaneContent()
 {
     _closeRequestedRevoker.revoke();
+    _fontSizeChangedRevoker.revoke();
+    _InvalidateLayoutCaches();
     return std::move(_content);
 }
 
@@ -1751,7 +1758,14 @@ void Pane::_setPaneContent(IPaneContent content)
     {
         _content = std::move(content);
         _closeRequestedRevoker = _content.CloseRequested(winrt::auto_revoke, [this](auto&&, auto&&) { Close(); });
+
+        // Our size snaps to the cells of the terminal, which change with its font size.
+        if (const auto terminal = _content.try_as<winrt::TerminalApp::TerminalPaneContent>())
+        {
+            _fontSizeChangedRevoker = terminal.GetTermControl().FontSizeChanged(winrt::auto_revoke, [](auto&&, auto&&) { _InvalidateLayoutCaches(); });
+        }
     }
+    _InvalidateLayoutCaches();
 }
 
 // Method Description:
@@ -1767,6 +1781,9 @@ void Pane::_setPaneContent(IPaneContent content)
 // - <none>
 void Pane::_CreateRowColDefinitions()
 {
+    // The split position has likely changed.
+    _InvalidateLayoutCaches();
+
     const auto first = _desiredSplitPosition * 100.0f;
     const auto second = 100.0f - first;
     if (_splitState == SplitState::Vertical)
@@ -1809,6 +1826,10 @@ void Pane::_CreateRowColDefinitions()
 // - <none>
 void Pane::_UpdateBorders()
 {
+    // The borders are part of our minimum size. This gets called whenever
+    // they change, which includes every change to the tree of panes.
+    _InvalidateLayoutCaches();
+
     double top = 0, bottom = 0, left = 0, right = 0;
 
     Thickness newBorders{ 0 };
@@ -2567,7 +2588,7 @@ Pane::SnapChildrenSizeResult Pane::_CalcSnappedChildrenSizes(const bool widthOrH
     // Each node represents a size of given pane. At the beginning, each node has the minimum
     // size that the corresponding pane can have; so has the our (root) node. We then gradually
     // expand our node (which in turn expands some of the child nodes) until we hit the desired
-    // size. Since each expand step (done in _AdvanceSnappedDimension()) guarantees that all the
+    // size. Since each expand step (done in LayoutSizeNode::Advance()) guarantees that all the
     // sizes will be snapped, our return values is also snapped.
     //   Why do we do it this, iterative way? Why can't we just split the given size by
     // _desiredSplitPosition and snap it latter? Because it's hardly doable, if possible, to also
@@ -2579,29 +2600,38 @@ Pane::SnapChildrenSizeResult Pane::_CalcSnappedChildrenSizes(const bool widthOrH
     // only just stop at various moments when the built sizes reaches it.  Eventually, this could
     // be optimized for simple cases like when both children are both leaves with the same character
     // size, but it doesn't seem to be beneficial.
+    //   That same property allows us to pick up where the previous call stopped, as long as
+    // nothing changed that affects the layout (see _InvalidateLayoutCaches()) and the requested
+    // size is past the previous lower size. This is what happens while the user drags the window
+    // border, where we get called for every mouse move with a slightly different size.
 
-    auto sizeTree = _CreateMinSizeTree(widthOrHeight);
-    auto lastSizeTree{ sizeTree };
+    const auto generation = _layoutGeneration.load(std::memory_order_relaxed);
+    auto& cache = widthOrHeight ? _widthLayoutCache : _heightLayoutCache;
+    if (!cache || cache->generation != generation || fullSize <= cache->lowerSize)
+    {
+        cache = std::make_unique<LayoutCache>(_CreateMinSizeTree(widthOrHeight), generation);
+    }
 
+    auto& sizeTree = cache->sizeTree;
     while (sizeTree.size < fullSize)
     {
-        lastSizeTree = sizeTree;
-        _AdvanceSnappedDimension(widthOrHeight, sizeTree);
+        cache->lower = { sizeTree.firstChild->size, sizeTree.secondChild->size };
+        cache->lowerSize = sizeTree.size;
+        sizeTree.Advance();
+    }
 
-        if (sizeTree.size == fullSize)
-        {
-            // If we just hit exactly the requested value, then just return the
-            // current state of children.
-            return { { sizeTree.firstChild->size, sizeTree.secondChild->size },
-                     { sizeTree.firstChild->size, sizeTree.secondChild->size } };
-        }
+    const std::pair higher{ sizeTree.firstChild->size, sizeTree.secondChild->size };
+    if (sizeTree.size == fullSize)
+    {
+        // If we hit exactly the requested value, then just return the
+        // current state of children.
+        return { higher, higher };
     }
 
-    // We exceeded the requested size in the loop above, so lastSizeTree will have
+    // We exceeded the requested size in the loop above, so lower will have
     // the last good sizes (so that children fit in) and sizeTree has the next possible
     // snapped sizes. Return them as lower and higher snap possibilities.
-    return { { lastSizeTree.firstChild->size, lastSizeTree.secondChild->size },
-             { sizeTree.firstChild->size, sizeTree.secondChild->size } };
+    return { cache->lower, higher };
 }
 
 // Method Description:
@@ -2709,139 +2739,6 @@ Pane::SnapSizeResult Pane::_CalcSnappedDimension(const bool widthOrHeight, const
     }
 }
 
-// Method Description:
-// - Increases size of given LayoutSizeNode to match next possible 'snap'. In case of leaf
-//   pane this means the next cell of the terminal. Otherwise, it means that one of its children
-//   advances (recursively). It expects the given node and its descendants to have either
-//   already snapped or minimum size.
-// Arguments:
-// - widthOrHeight: if true operates on width; otherwise, on height.
-// - sizeNode: a layout size node that corresponds to this pane.
-// Return Value:
-// - <none>
-void Pane::_AdvanceSnappedDimension(const bool widthOrHeight, LayoutSizeNode& sizeNode) const
-{
-    if (_IsLeaf())
-    {
-        const auto& snappable{ _content.try_as<ISnappable>() };
-        if (snappable)
-        {
-            // We're a leaf pane, so just add one more row or column (unless isMinimumSize
-            // is true, see below).
-
-            if (sizeNode.isMinimumSize)
-            {
-                // If the node is of its minimum size, this size might not be snapped (it might
-                // be, say, half a character, or fixed 10 pixels), so snap it upward. It might
-                // however be already snapped, so add 1 to make sure it really increases
-                // (not strictly necessary but to avoid surprises).
-                sizeNode.size = _CalcSnappedDimension(widthOrHeight, sizeNode.size + 1).higher;
-            }
-            else
-            {
-                const auto cellSize = snappable.GridUnitSize();
-                sizeNode.size += widthOrHeight ? cellSize.Width : cellSize.Height;
-            }
-        }
-        else
-        {
-            // If we're a leaf that didn't have a TermControl, then just increment
-            // by one. We have to increment by _some_ value, because this is used in
-            // a while() loop to find the next bigger size we can snap to. But since
-            // a non-terminal control doesn't really care what size it's snapped to,
-            // we can just say "one pixel larger is the next snap point"
-            sizeNode.size += 1;
-        }
-    }
-    else
-    {
-        // We're a parent pane, so we have to advance dimension of our children panes. In
-        // fact, we advance only one child (chosen later) to keep the growth fine-grained.
-
-        // To choose which child pane to advance, we actually need to know their advanced sizes
-        // in advance (oh), to see which one would 'fit' better. Often, this is already cached
-        // by the previous invocation of this function in nextFirstChild and nextSecondChild
-        // fields of given node. If not, we need to calculate them now.
-        if (sizeNode.nextFirstChild == nullptr)
-        {
-            sizeNode.nextFirstChild = std::make_unique<LayoutSizeNode>(*sizeNode.firstChild);
-            _firstChild->_AdvanceSnappedDimension(widthOrHeight, *sizeNode.nextFirstChild);
-        }
-        if (sizeNode.nextSecondChild == nullptr)
-        {
-            sizeNode.nextSecondChild = std::make_unique<LayoutSizeNode>(*sizeNode.secondChild);
-            _secondChild->_AdvanceSnappedDimension(widthOrHeight, *sizeNode.nextSecondChild);
-        }
-
-        const auto nextFirstSize = sizeNode.nextFirstChild->size;
-        const auto nextSecondSize = sizeNode.nextSecondChild->size;
-
-        // Choose which child pane to advance.
-        bool advanceFirstOrSecond;
-        if (_splitState == (widthOrHeight ? SplitState::Horizontal : SplitState::Vertical))
-        {
-            // If we're growing along separator axis, choose the child that
-            // wants to be smaller than the other, so that the resulting size
-            // will be the smallest.
-            advanceFirstOrSecond = nextFirstSize < nextSecondSize;
-        }
-        else
-        {
-            // If we're growing perpendicularly to separator axis, choose a
-            // child so that their size ratio is closer to that we're trying
-            // to maintain (this is, the relative separator position is closer
-            // to the _desiredSplitPosition field).
-
-            const auto firstSize = sizeNode.firstChild->size;
-            const auto secondSize = sizeNode.secondChild->size;
-
-            // Because we rely on equality check, these calculations have to be
-            // immune to floating point errors. In common situation where both panes
-            // have the same character sizes and _desiredSplitPosition is 0.5 (or
-            // some simple fraction) both ratios will often be the same, and if so
-            // we always take the left child. It could be right as well, but it's
-            // important that it's consistent: that it would always go
-            // 1 -> 2 -> 1 -> 2 -> 1 -> 2 and not like 1 -> 1 -> 2 -> 2 -> 2 -> 1
-            // which would look silly to the user but which occur if there was
-            // a non-floating-point-safe math.
-            const auto deviation1 = nextFirstSize - (nextFirstSize + secondSize) * _desiredSplitPosition;
-            const auto deviation2 = -1 * (firstSize - (firstSize + nextSecondSize) * _desiredSplitPosition);
-            advanceFirstOrSecond = deviation1 <= deviation2;
-        }
-
-        // Here we advance one of our children. Because we already know the appropriate
-        // (advanced) size that given child would need to have, we simply assign that size
-        // to it. We then advance its 'next*' size (nextFirstChild or nextSecondChild) so
-        // the invariant holds (as it will likely be used by the next invocation of this
-        // function). The other child's next* size remains unchanged because its size
-        // haven't changed either.
-        if (advanceFirstOrSecond)
-        {
-            *sizeNode.firstChild = *sizeNode.nextFirstChild;
-            _firstChild->_AdvanceSnappedDimension(widthOrHeight, *sizeNode.nextFirstChild);
-        }
-        else
-        {
-            *sizeNode.secondChild = *sizeNode.nextSecondChild;
-            _secondChild->_AdvanceSnappedDimension(widthOrHeight, *sizeNode.nextSecondChild);
-        }
-
-        // Since the size of one of our children has changed we need to update our size as well.
-        if (_splitState == (widthOrHeight ? SplitState::Horizontal : SplitState::Vertical))
-        {
-            sizeNode.size = std::max(sizeNode.firstChild->size, sizeNode.secondChild->size);
-        }
-        else
-        {
-            sizeNode.size = sizeNode.firstChild->size + sizeNode.secondChild->size;
-        }
-    }
-
-    // Because we have grown, we're certainly no longer of our
-    // minimal size (if we've ever been).
-    sizeNode.isMinimumSize = false;
-}
-
 // Method Description:
 // - Get the absolute minimum size that this pane can be resized to and still
 //   have 1x1 character visible, in each of its children. If we're a leaf, we'll
@@ -2884,24 +2781,66 @@ Size Pane::_GetMinSize() const
 
 // Method Description:
 // - Builds a tree of LayoutSizeNode that matches the tree of panes. Each node
-//   has minimum size that the corresponding pane can have.
+//   has minimum size that the corresponding pane can have, as well as everything
+//   else LayoutSizeNode::Advance() needs to know about the pane.
+// - The minimum sizes of parents are computed from those of their children, which
+//   is the same as calling _GetMinSize() on each of them, but visits every pane once.
 // Arguments:
 // - widthOrHeight: if true operates on width; otherwise, on height
 // Return Value:
 // - Root node of built tree that matches this pane.
 Pane::LayoutSizeNode Pane::_CreateMinSizeTree(const bool widthOrHeight) const
 {
-    const auto size = _GetMinSize();
-    LayoutSizeNode node(widthOrHeight ? size.Width : size.Height);
-    if (!_IsLeaf())
+    if (_IsLeaf())
     {
-        node.firstChild = std::make_unique<LayoutSizeNode>(_firstChild->_CreateMinSizeTree(widthOrHeight));
-        node.secondChild = std::make_unique<LayoutSizeNode>(_secondChild->_CreateMinSizeTree(widthOrHeight));
+        const auto size = _GetMinSize();
+        LayoutSizeNode node(widthOrHeight ? size.Width : size.Height);
+
+        if (const auto& snappable{ _content.try_as<ISnappable>() })
+        {
+            const auto cellSize = snappable.GridUnitSize();
+            node.cellSize = widthOrHeight ? cellSize.Width : cellSize.Height;
+            // Add 1 to make sure the size really increases, even if the minimum size is already snapped.
+            node.firstSnappedSize = _CalcSnappedDimension(widthOrHeight, node.minSize + 1).higher;
+        }
+        else
+        {
+            // A non-terminal control doesn't really care what size it's snapped to,
+            // so we say "one pixel larger is the next snap point".
+            node.cellSize = 1;
+            node.firstSnappedSize = node.minSize + 1;
+        }
+
+        return node;
     }
 
+    auto firstChild = std::make_unique<LayoutSizeNode>(_firstChild->_CreateMinSizeTree(widthOrHeight));
+    auto secondChild = std::make_unique<LayoutSizeNode>(_secondChild->_CreateMinSizeTree(widthOrHeight));
+    const auto alongSeparator = _splitState == (widthOrHeight ? SplitState::Horizontal : SplitState::Vertical);
+
+    LayoutSizeNode node(alongSeparator ?
+                            std::max(firstChild->minSize, secondChild->minSize) :
+                            firstChild->minSize + secondChild->minSize);
+    node.firstChild = std::move(firstChild);
+    node.secondChild = std::move(secondChild);
+    node.alongSeparator = alongSeparator;
+    node.desiredSplitPosition = _desiredSplitPosition;
     return node;
 }
 
+// Method Description:
+// - Invalidates the LayoutCache of every pane. This needs to be called whenever
+//   anything changes that _CreateMinSizeTree() depends on: the tree of panes,
+//   split positions, borders, as well as the font size and padding of terminals.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Pane::_InvalidateLayoutCaches() noexcept
+{
+    _layoutGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
 // Method Description:
 // - Adjusts split position so that no child pane is smaller then its
 //   minimum size
@@ -230,6 +230,7 @@ private:
     struct SnapSizeResult;
     struct SnapChildrenSizeResult;
     struct LayoutSizeNode;
+    struct LayoutCache;
 
     winrt::Windows::UI::Xaml::Controls::Grid _root{};
     winrt::Windows::UI::Xaml::Controls::Border _borderFirst{};
@@ -255,12 +256,20 @@ private:
     winrt::Windows::UI::Xaml::UIElement::GotFocus_revoker _gotFocusRevoker;
     winrt::Windows::UI::Xaml::UIElement::LostFocus_revoker _lostFocusRevoker;
     winrt::TerminalApp::IPaneContent::CloseRequested_revoker _closeRequestedRevoker;
+    winrt::Microsoft::Terminal::Control::TermControl::FontSizeChanged_revoker _fontSizeChangedRevoker;
 
     Borders _borders{ Borders::None };
 
     bool _zoomed{ false };
     bool _broadcastEnabled{ false };
 
+    // The state of the last _CalcSnappedChildrenSizes() call per dimension.
+    mutable std::unique_ptr<LayoutCache> _widthLayoutCache;
+    mutable std::unique_ptr<LayoutCache> _heightLayoutCache;
+    // Panes don't know their parent, so any change that affects the layout of
+    // a pane invalidates the LayoutCache of all panes. See _InvalidateLayoutCaches().
+    static std::atomic<uint64_t> _layoutGeneration;
+
     bool _IsLeaf() const noexcept;
     bool _HasFocusedChild() const noexcept;
     void _SetupChildCloseHandlers();
@@ -306,9 +315,9 @@ private:
     std::pair<float, float> _CalcChildrenSizes(const float fullSize) const;
     SnapChildrenSizeResult _CalcSnappedChildrenSizes(const bool widthOrHeight, const float fullSize) const;
     SnapSizeResult _CalcSnappedDimension(const bool widthOrHeight, const float dimension) const;
-    void _AdvanceSnappedDimension(const bool widthOrHeight, LayoutSizeNode& sizeNode) const;
     winrt::Windows::Foundation::Size _GetMinSize() const;
     LayoutSizeNode _CreateMinSizeTree(const bool widthOrHeight) const;
+    static void _InvalidateLayoutCaches() noexcept;
     float _ClampSplitPosition(const bool widthOrHeight, const float requestedValue, const float totalSize) const;
 
     SplitState _convertAutomaticOrDirectionalSplitState(const winrt::Microsoft::Terminal::Settings::Model::SplitDirection& splitType) const;
@@ -392,10 +401,46 @@ private:
         std::unique_ptr<LayoutSizeNode> nextFirstChild;
         std::unique_ptr<LayoutSizeNode> nextSecondChild;
 
+        // The properties of the corresponding pane that the layout depends on.
+        // They're gathered once by _CreateMinSizeTree(), so that Advance()
+        // doesn't need to ask the panes and their content over and over again.
+        float minSize;
+        // Leaves only: the first snapped size above minSize and the size of a cell.
+        float firstSnappedSize{ 0 };
+        float cellSize{ 0 };
+        // Parents only: true if the children share the same size (we're growing
+        // along the separator axis) and false if their sizes add up.
+        bool alongSeparator{ false };
+        float desiredSplitPosition{ 0 };
+
         explicit LayoutSizeNode(const float minSize);
         LayoutSizeNode(const LayoutSizeNode& other);
+        LayoutSizeNode(LayoutSizeNode&& other) = default;
 
         LayoutSizeNode& operator=(const LayoutSizeNode& other);
+        LayoutSizeNode& operator=(LayoutSizeNode&& other) = default;
+
+        void Advance();
+    };
+
+    // The layout of _CalcSnappedChildrenSizes() at the point where it stopped the last time.
+    // sizeTree is the first state that reached the requested size and lower holds the sizes of
+    // our children in the state before that, which had a total size of lowerSize.
+    // It's only valid as long as _layoutGeneration is still equal to generation.
+    struct LayoutCache
+    {
+        LayoutSizeNode sizeTree;
+        std::pair<float, float> lower;
+        float lowerSize;
+        uint64_t generation;
+
+        LayoutCache(LayoutSizeNode&& minSizeTree, const uint64_t generation) :
+            sizeTree{ std::move(minSizeTree) },
+            lower{ sizeTree.firstChild->size, sizeTree.secondChild->size },
+            lowerSize{ -std::numeric_limits<float>::infinity() },
+            generation{ generation }
+        {
+        }
     };
 
     friend struct winrt::TerminalApp::implementation::Tab;
@@ -937,30 +937,14 @@ namespace winrt::TerminalApp::implementation
     // - <none>
     std::vector<winrt::TerminalApp::FilteredCommand> SuggestionsControl::_collectFilteredActions()
     {
-        std::vector<winrt::TerminalApp::FilteredCommand> actions;
-
         winrt::hstring searchText{ _getTrimmedInput() };
 
         auto commandsToFilter = _commandsToFilter();
 
-        {
-            auto pattern = std::make_shared<fzf::matcher::Pattern>(fzf::matcher::ParsePattern(searchText));
-
-            for (const auto& action : commandsToFilter)
-            {
-                // Update filter for all commands
-                // This will modify the highlighting but will also lead to re-computation of weight (and consequently sorting).
-                // Pay attention that it already updates the highlighting in the UI
-                auto impl = winrt::get_self<implementation::FilteredCommand>(action);
-                impl->UpdateFilter(pattern);
-
-                // if there is active search we skip commands with 0 weight
-                if (searchText.empty() || action.Weight() > 0)
-                {
-                    actions.push_back(action);
-                }
-            }
-        }
+        // Update filter for all commands
+        // This will modify the highlighting but will also lead to re-computation of weight.
+        // Pay attention that it already updates the highlighting in the UI
+        auto actions = _commandFilter.Filter(commandsToFilter, searchText, false);
 
         // No sorting in palette mode, so results are still filtered, but in the
         // original order. This feels more right for something like
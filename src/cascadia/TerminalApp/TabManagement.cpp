@@ -1109,6 +1109,7 @@ namespace winrt::TerminalApp::implementation
             }
 
             _adjustProcessPriorityThrottled->Run();
+            _hibernateHiddenPanesThrottled->Run();
         }
         CATCH_LOG();
     }
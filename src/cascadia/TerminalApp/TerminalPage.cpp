@@ -453,6 +453,19 @@ namespace winrt::TerminalApp::implementation
             [=]() {
                 _adjustProcessPriority();
             });
+
+        // Terminals that stay hidden for a while release their renderer resources and unused
+        // buffer memory. The delay avoids doing that while the user is just flipping through tabs.
+        _hibernateHiddenPanesThrottled = std::make_shared<ThrottledFunc<>>(
+            DispatcherQueue::GetForCurrentThread(),
+            til::throttled_func_options{
+                .delay = std::chrono::seconds{ 30 },
+                .debounce = true,
+                .trailing = true,
+            },
+            [=]() {
+                _hibernateHiddenPanes();
+            });
     }
 
     Windows::UI::Xaml::Automation::Peers::AutomationPeer TerminalPage::OnCreateAutomationPeer()
@@ -671,7 +684,7 @@ namespace winrt::TerminalApp::implementation
             }
             else if (!_startupActions.empty())
             {
-                ProcessStartupActions(std::move(_startupActions));
+                ProcessStartupActions(std::move(_startupActions), {}, {}, _startupActionsRestoreLayout);
             }
 
             _CompleteInitialization();
@@ -690,9 +703,11 @@ namespace winrt::TerminalApp::implementation
     // - cwd: If not empty, we should try switching to this provided directory
     //   while processing these actions. This will allow something like `wt -w 0
     //   nt -d .` from inside another directory to work as expected.
+    // - restoringLayout: If true, the actions recreate a persisted window layout.
+    //   Tabs that aren't shown won't be laid out and thus won't start until shown.
     // Return Value:
     // - <none>
-    safe_void_coroutine TerminalPage::ProcessStartupActions(std::vector<ActionAndArgs> actions, const winrt::hstring cwd, const winrt::hstring env)
+    safe_void_coroutine TerminalPage::ProcessStartupActions(std::vector<ActionAndArgs> actions, const winrt::hstring cwd, const winrt::hstring env, const bool restoringLayout)
     {
         const auto strong = get_strong();
 
@@ -731,7 +746,15 @@ namespace winrt::TerminalApp::implementation
         // This same logic is also applied to CreateTabFromConnection.
         //
         // See GH#13136.
-        auto suspend = _tabs.Size() > 0;
+        //
+        // Restored layouts are the exception: A TermControl only creates its buffer and
+        // renderer, loads its persisted buffer and starts its connection once it got a size.
+        // If we suspended here, every restored tab would get laid out in turn, which would
+        // make startup time and memory usage scale with the number of restored panes.
+        // Without suspending, only the tab that ends up being selected gets laid out and
+        // all others stay dormant until they're first shown. Splits don't need a layout
+        // either, because persisted layouts only contain explicit split directions.
+        auto suspend = _tabs.Size() > 0 && !restoringLayout;
 
         for (size_t i = 0; i < actions.size(); ++i)
         {
@@ -741,7 +764,7 @@ namespace winrt::TerminalApp::implementation
             }
 
             _actionDispatch->DoAction(actions[i]);
-            suspend = true;
+            suspend = !restoringLayout;
         }
 
         // GH#6586: now that we're done processing all startup commands,
@@ -4097,11 +4120,14 @@ namespace winrt::TerminalApp::implementation
     // - This function will have no effective result after Create() is called.
     // Arguments:
     // - actions: a list of Actions to process on startup.
+    // - restoringLayout: true if the actions come from a persisted window layout.
+    //   See ProcessStartupActions.
     // Return Value:
     // - <none>
-    void TerminalPage::SetStartupActions(std::vector<ActionAndArgs> actions)
+    void TerminalPage::SetStartupActions(std::vector<ActionAndArgs> actions, bool restoringLayout)
     {
         _startupActions = std::move(actions);
+        _startupActionsRestoreLayout = restoringLayout;
     }
 
     void TerminalPage::SetStartupConnection(ITerminalConnection connection)
@@ -4178,6 +4204,11 @@ namespace winrt::TerminalApp::implementation
     void TerminalPage::WindowVisibilityChanged(const bool showOrHide)
     {
         _visible = showOrHide;
+        if (!showOrHide)
+        {
+            _hibernateHiddenPanesThrottled->Run();
+        }
+
         for (const auto& tab : _tabs)
         {
             if (auto tabImpl{ _GetTabImpl(tab) })
@@ -5231,6 +5262,35 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    // Method Description:
+    // - Hibernates all terminals that aren't visible: Those in background tabs,
+    //   or all of them if the window is minimized. See TermControl::Hibernate().
+    //   They resume on their own once they're shown again.
+    void TerminalPage::_hibernateHiddenPanes() const
+    {
+        winrt::com_ptr<Tab> focusedTab;
+        if (_visible)
+        {
+            focusedTab = _GetFocusedTabImpl();
+        }
+
+        for (const auto& tab : _tabs)
+        {
+            const auto tabImpl = _GetTabImpl(tab);
+            if (!tabImpl || tabImpl == focusedTab)
+            {
+                continue;
+            }
+
+            tabImpl->GetRootPane()->WalkTree([](auto&& pane) {
+                if (const auto control = pane->GetTerminalControl())
+                {
+                    control.Hibernate();
+                }
+            });
+        }
+    }
+
     void TerminalPage::_adjustProcessPriority() const
     {
         // Windowing is single-threaded, so this will not cause a race condition.
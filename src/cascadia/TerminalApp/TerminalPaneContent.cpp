@@ -345,6 +345,13 @@ namespace winrt::TerminalApp::implementation
         const auto profile{ settings.FindProfile(_profile.Guid()) };
         _profile = profile ? profile : settings.ProfileDefaults();
 
+        // If none of the settings of our profile changed, there's no need to push them to the control.
+        // Besides being faster, this preserves runtime changes like the font size in unaffected panes.
+        if (profile && _cache->IsUnchanged(_profile))
+        {
+            return;
+        }
+
         if (const auto settings{ _cache->TryLookup(_profile) })
         {
             _control.UpdateControlSettings(settings->DefaultSettings(), settings->UnfocusedSettings());
@@ -25,27 +25,57 @@ namespace winrt::TerminalApp::implementation
 
     std::optional<TerminalSettingsPair> TerminalSettingsCache::TryLookup(const MTSM::Profile& profile)
     {
-        const auto found{ profileGuidSettingsMap.find(profile.Guid()) };
         // GH#2455: If there are any panes with controls that had been
         // initialized with a Profile that no longer exists in our list of
         // profiles, we'll leave it unmodified. The profile doesn't exist
         // anymore, so we can't possibly update its settings.
-        if (found != profileGuidSettingsMap.cend())
+        if (const auto result{ _lookup(_settings, profileGuidSettingsMap, profile.Guid()) })
         {
-            auto& pair{ found->second };
-            if (!pair.second)
-            {
-                pair.second = winrt::Microsoft::Terminal::Settings::TerminalSettings::CreateWithProfile(_settings, pair.first);
-            }
-            return std::optional{ TerminalSettingsPair{ *pair.second } };
+            return std::optional{ TerminalSettingsPair{ *result } };
         }
 
         return std::nullopt;
     }
 
+    // Method Description:
+    // - Returns true if the TerminalSettings for the given profile are identical
+    //   to the ones it had before the last call to Reset(). Controls using
+    //   this profile don't need to be updated in that case.
+    bool TerminalSettingsCache::IsUnchanged(const MTSM::Profile& profile)
+    {
+        const auto guid{ profile.Guid() };
+        if (const auto found{ _unchangedMap.find(guid) }; found != _unchangedMap.end())
+        {
+            return found->second;
+        }
+
+        // We only compare against previous settings that were actually created before the last Reset(),
+        // because those are the ones our panes were updated with. Creating them now from the previous
+        // settings model wouldn't produce the same result: TerminalSettings also depend on state
+        // outside of the model, like whether the OS is in dark mode. If they weren't created
+        // back then, we can't know what our panes hold and have to assume that they changed.
+        const auto current{ _lookup(_settings, profileGuidSettingsMap, guid) };
+        const auto previous{ _tryGet(_previousProfileGuidSettingsMap, guid) };
+        auto unchanged = false;
+
+        if (current && previous)
+        {
+            const auto currentUnfocused{ current->UnfocusedSettings() };
+            const auto previousUnfocused{ previous->UnfocusedSettings() };
+            unchanged = current->DefaultSettings()->SettingsEqual(*previous->DefaultSettings()) &&
+                        static_cast<bool>(currentUnfocused) == static_cast<bool>(previousUnfocused) &&
+                        (!currentUnfocused || currentUnfocused->SettingsEqual(*previousUnfocused));
+        }
+
+        _unchangedMap.emplace(guid, unchanged);
+        return unchanged;
+    }
+
     void TerminalSettingsCache::Reset(const MTSM::CascadiaSettings& settings)
     {
         _settings = settings;
+        _previousProfileGuidSettingsMap = std::move(profileGuidSettingsMap);
+        _unchangedMap.clear();
 
         // Mapping by GUID isn't _excellent_ because the defaults profile doesn't have a stable GUID; however,
         // when we stabilize its guid this will become fully safe.
@@ -63,4 +93,30 @@ namespace winrt::TerminalApp::implementation
             profileGuidSettingsMap.insert_or_assign(newProfile.Guid(), std::pair{ newProfile, std::nullopt });
         }
     }
+
+    const winrt::Microsoft::Terminal::Settings::TerminalSettingsCreateResult* TerminalSettingsCache::_lookup(const MTSM::CascadiaSettings& settings, ProfileSettingsMap& map, const winrt::guid& guid)
+    {
+        const auto found{ map.find(guid) };
+        if (found == map.end())
+        {
+            return nullptr;
+        }
+
+        auto& pair{ found->second };
+        if (!pair.second)
+        {
+            pair.second = winrt::Microsoft::Terminal::Settings::TerminalSettings::CreateWithProfile(settings, pair.first);
+        }
+        return &*pair.second;
+    }
+
+    const winrt::Microsoft::Terminal::Settings::TerminalSettingsCreateResult* TerminalSettingsCache::_tryGet(const ProfileSettingsMap& map, const winrt::guid& guid) noexcept
+    {
+        const auto found{ map.find(guid) };
+        if (found == map.end() || !found->second.second)
+        {
+            return nullptr;
+        }
+        return &*found->second.second;
+    }
 }
@@ -10,6 +10,8 @@ Abstract:
   contains a single map of guid -> TerminalSettings, so that as we update all
   the panes during a settings reload, we only need to create a TerminalSettings
   once per profile.
+- It also remembers the TerminalSettings from before the last reload, so that
+  panes whose profile didn't change can skip updating their control entirely.
 --*/
 #pragma once
 
@@ -40,10 +42,20 @@ namespace winrt::TerminalApp::implementation
     {
         TerminalSettingsCache(const Microsoft::Terminal::Settings::Model::CascadiaSettings& settings);
         std::optional<TerminalSettingsPair> TryLookup(const Microsoft::Terminal::Settings::Model::Profile& profile);
+        bool IsUnchanged(const Microsoft::Terminal::Settings::Model::Profile& profile);
         void Reset(const Microsoft::Terminal::Settings::Model::CascadiaSettings& settings);
 
     private:
+        using ProfileSettingsMap = std::unordered_map<winrt::guid, std::pair<Microsoft::Terminal::Settings::Model::Profile, std::optional<winrt::Microsoft::Terminal::Settings::TerminalSettingsCreateResult>>>;
+
+        static const winrt::Microsoft::Terminal::Settings::TerminalSettingsCreateResult* _lookup(const Microsoft::Terminal::Settings::Model::CascadiaSettings& settings, ProfileSettingsMap& map, const winrt::guid& guid);
+        static const winrt::Microsoft::Terminal::Settings::TerminalSettingsCreateResult* _tryGet(const ProfileSettingsMap& map, const winrt::guid& guid) noexcept;
+
         Microsoft::Terminal::Settings::Model::CascadiaSettings _settings{ nullptr };
-        std::unordered_map<winrt::guid, std::pair<Microsoft::Terminal::Settings::Model::Profile, std::optional<winrt::Microsoft::Terminal::Settings::TerminalSettingsCreateResult>>> profileGuidSettingsMap;
+        ProfileSettingsMap profileGuidSettingsMap;
+
+        // The settings that were handed out before the last Reset(), so that IsUnchanged() can compare against them.
+        ProfileSettingsMap _previousProfileGuidSettingsMap;
+        std::unordered_map<winrt::guid, bool> _unchangedMap;
     };
 }
@@ -170,7 +170,7 @@ namespace winrt::TerminalApp::implementation
         {
             // layout will only ever be non-null if there were >0 tabs persisted in
             // .TabLayout(). We can re-evaluate that as a part of TODO: GH#12633
-            _root->SetStartupActions(wil::to_vector(layout.TabLayout()));
+            _root->SetStartupActions(wil::to_vector(layout.TabLayout()), true);
         }
         else if (_appArgs)
         {
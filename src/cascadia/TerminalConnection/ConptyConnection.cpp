@@ -747,22 +747,149 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         const wil::unique_event overlappedEvent{ CreateEventExW(nullptr, nullptr, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS) };
         OVERLAPPED overlapped{ .hEvent = overlappedEvent.get() };
         bool overlappedPending = false;
-        char buffer[128 * 1024];
-        DWORD read = 0;
+
+        // We alternate between two slabs: While ReadFile() fills one of them,
+        // we convert and parse the contents of the other. Unlike a single buffer,
+        // this allows us to queue the next read _before_ converting the previous one,
+        // so that the pipe never sits idle while we're busy with the UTF-8 -> UTF-16
+        // conversion.
+        //
+        // The read size adapts to the throughput: Interactive use rarely produces more than
+        // a few KiB at a time, so we start small and only grow the slabs when reads keep
+        // filling them up completely (= the pipe has more data than we asked for).
+        static constexpr DWORD minReadSize = 4 * 1024;
+        static constexpr DWORD maxReadSize = 128 * 1024;
+        // Back-to-back reads are coalesced into a single TerminalOutput event until
+        // this many characters are pending. Each event acquires the terminal's write lock,
+        // so this reduces lock traffic during floods, while still bounding the latency.
+        static constexpr size_t maxCoalescedLength = 256 * 1024;
+
+        std::unique_ptr<char[]> slabs[2];
+        DWORD slabCapacity[2]{};
+        DWORD readSize = minReadSize;
+        size_t slabIndex = 0;
+        const char* previousSlab = nullptr;
+        DWORD previousRead = 0;
 
         til::u8state u8State;
-        std::wstring wstr;
+        std::wstring chunk;
+        std::wstring pending;
+
+        struct
+        {
+            uint64_t reads = 0;
+            uint64_t bytes = 0;
+            uint64_t events = 0;
+            uint64_t coalescedReads = 0;
+            uint64_t grownReads = 0;
+            uint64_t shrunkReads = 0;
+        } stats;
+
+        const auto traceStats = wil::scope_exit([&]() noexcept {
+            TraceLoggingWrite(
+                g_hTerminalConnectionProvider,
+                "OutputThreadStats",
+                TraceLoggingDescription("Read sizing and coalescing statistics of the output thread"),
+                TraceLoggingGuid(_sessionId, "session"),
+                TraceLoggingUInt64(stats.reads, "Reads", "Number of completed ReadFile() calls"),
+                TraceLoggingUInt64(stats.bytes, "Bytes", "Number of bytes read"),
+                TraceLoggingUInt64(stats.events, "Events", "Number of TerminalOutput events raised"),
+                TraceLoggingUInt64(stats.coalescedReads, "CoalescedReads", "Reads that were merged into the next TerminalOutput event"),
+                TraceLoggingUInt64(stats.grownReads, "GrownReads", "How often the read size was increased"),
+                TraceLoggingUInt64(stats.shrunkReads, "ShrunkReads", "How often the read size was decreased"),
+                TraceLoggingUInt32(std::max(slabCapacity[0], slabCapacity[1]), "SlabCapacity", "The final size of the read buffers"),
+                TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+        });
+
+        const auto flush = [&]() {
+            // Nobody is interested in output anymore once we're closing,
+            // and raising TerminalOutput during teardown isn't safe either.
+            if (_isStateAtOrBeyond(ConnectionState::Closing))
+            {
+                pending.clear();
+                return;
+            }
+
+            if (!_receivedFirstByte)
+            {
+                const auto now = std::chrono::high_resolution_clock::now();
+                const std::chrono::duration<double> delta = now - _startTime;
+
+#pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
+                TraceLoggingWrite(g_hTerminalConnectionProvider,
+                                  "ReceivedFirstByte",
+                                  TraceLoggingDescription("An event emitted when the connection receives the first byte"),
+                                  TraceLoggingGuid(_sessionId, "SessionGuid", "The WT_SESSION's GUID"),
+                                  TraceLoggingFloat64(delta.count(), "Duration"),
+                                  TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES),
+                                  TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance));
+                _receivedFirstByte = true;
+            }
+
+            try
+            {
+                TerminalOutput.raise(winrt_wstring_to_array_view(pending));
+            }
+            CATCH_LOG();
+
+            pending.clear();
+            stats.events++;
+        };
+
+        const auto convert = [&](const char* data, DWORD size) {
+            TraceLoggingWrite(
+                g_hTerminalConnectionProvider,
+                "ReadFile",
+                TraceLoggingCountedUtf8String(data, size, "buffer"),
+                TraceLoggingGuid(_sessionId, "session"),
+                TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+
+            // If we hit a parsing error, eat it. It's bad utf-8, we can't do anything with it.
+            // chunk can also be empty if the slab only contained an incomplete UTF-8 sequence.
+            if (SUCCEEDED_LOG(til::u8u16({ data, gsl::narrow_cast<size_t>(size) }, chunk, u8State)) && !chunk.empty())
+            {
+                if (pending.empty())
+                {
+                    pending.swap(chunk);
+                }
+                else
+                {
+                    pending.append(chunk);
+                }
+            }
+        };
+
+        // Returns true if the pipe holds more output that the next ReadFile() can return without blocking.
+        // This is false for handles that aren't pipes (e.g. sockets), which simply results in less coalescing.
+        const auto moreOutputAvailable = [&]() noexcept {
+            DWORD available = 0;
+            return PeekNamedPipe(_pipe.get(), nullptr, 0, nullptr, &available, nullptr) && available != 0;
+        };
 
         // If we use overlapped IO We want to queue ReadFile() calls before processing the
         // string, because TerminalOutput.raise() may take a while (relatively speaking).
         // That's why the loop looks a little weird as it starts a read, processes the
-        // previous string, and finally converts the previous read to the next string.
+        // previous slab, and finally waits for the read to complete.
         for (;;)
         {
-            // When we have a `wstr` that's ready for processing we must do so without blocking.
+            // Slabs only ever grow. The slab we're about to read into isn't referenced by
+            // previousSlab, so it's safe to reallocate it here.
+            if (slabCapacity[slabIndex] < readSize)
+            {
+                slabs[slabIndex] = std::make_unique_for_overwrite<char[]>(readSize);
+                slabCapacity[slabIndex] = readSize;
+            }
+
+            const auto slab = slabs[slabIndex].get();
+            slabIndex ^= 1;
+
+            // When we have a previous slab that's ready for processing we must do so without blocking.
             // Otherwise, whatever the user typed will be delayed until the next IO operation.
             // With overlapped IO that's not a problem because the ReadFile() calls won't block.
-            if (!ReadFile(_pipe.get(), &buffer[0], sizeof(buffer), &read, &overlapped))
+            DWORD read = 0;
+            if (!ReadFile(_pipe.get(), slab, readSize, &read, &overlapped))
             {
                 if (GetLastError() != ERROR_IO_PENDING)
                 {
@@ -771,38 +898,31 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 overlappedPending = true;
             }
 
-            // wstr can be empty in two situations:
-            // * The previous call to til::u8u16 failed.
-            // * We're using overlapped IO, and it's the first iteration.
-            if (!wstr.empty())
+            // previousRead is 0 on the first iteration and after a read was processed right away (see below).
+            if (previousRead)
             {
-                if (!_receivedFirstByte)
-                {
-                    const auto now = std::chrono::high_resolution_clock::now();
-                    const std::chrono::duration<double> delta = now - _startTime;
-
-#pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
-                    TraceLoggingWrite(g_hTerminalConnectionProvider,
-                                      "ReceivedFirstByte",
-                                      TraceLoggingDescription("An event emitted when the connection receives the first byte"),
-                                      TraceLoggingGuid(_sessionId, "SessionGuid", "The WT_SESSION's GUID"),
-                                      TraceLoggingFloat64(delta.count(), "Duration"),
-                                      TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES),
-                                      TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance));
-                    _receivedFirstByte = true;
-                }
+                convert(previousSlab, previousRead);
+            }
 
-                try
-                {
-                    TerminalOutput.raise(winrt_wstring_to_array_view(wstr));
-                }
-                CATCH_LOG();
+            // If the read we just queued has already completed, more output arrived while we
+            // were busy. In that case we hold on to what we have and merge it with the next read.
+            // A lone read on the other hand is flushed immediately, so that interactive
+            // latency (e.g. echoing a keypress) isn't affected by any of this.
+            const auto nextReadReady = !overlappedPending || HasOverlappedIoCompleted(&overlapped);
+            if (!pending.empty() && (!nextReadReady || pending.size() >= maxCoalescedLength))
+            {
+                flush();
+            }
+            else if (!pending.empty())
+            {
+                stats.coalescedReads++;
             }
 
-            // Here's the counterpart to the start of the loop. We processed whatever was in `wstr`,
+            // Here's the counterpart to the start of the loop. We processed the previous slab,
             // so blocking synchronously on the pipe is now possible.
             // If we used overlapped IO, we need to wait for the ReadFile() to complete.
             // If we didn't, we can now safely block on our ReadFile() call.
+            const auto completedSynchronously = !overlappedPending;
             if (overlappedPending)
             {
                 overlappedPending = false;
@@ -826,16 +946,47 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 break;
             }
 
-            TraceLoggingWrite(
-                g_hTerminalConnectionProvider,
-                "ReadFile",
-                TraceLoggingCountedUtf8String(&buffer[0], read, "buffer"),
-                TraceLoggingGuid(_sessionId, "session"),
-                TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
-                TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+            stats.reads++;
+            stats.bytes += read;
 
-            // If we hit a parsing error, eat it. It's bad utf-8, we can't do anything with it.
-            FAILED_LOG(til::u8u16({ &buffer[0], gsl::narrow_cast<size_t>(read) }, wstr, u8State));
+            // A read that filled the entire buffer indicates that there's more data in the pipe:
+            // Grow the read size to process floods in fewer, larger chunks. Reads that only use
+            // a fraction of it slowly shrink it again. We don't release memory when shrinking,
+            // since the next flood would only allocate it again anyway.
+            if (read == readSize && readSize < maxReadSize)
+            {
+                readSize *= 2;
+                stats.grownReads++;
+            }
+            else if (read < readSize / 4 && readSize > minReadSize)
+            {
+                readSize /= 2;
+                stats.shrunkReads++;
+            }
+
+            // A read that completed synchronously is normally processed after the next ReadFile() was queued.
+            // But with a synchronous pipe handle that call blocks until more output arrives, which would leave
+            // the output of an idle shell stuck. So, unless more output is available right now, we process it now.
+            if (completedSynchronously && !moreOutputAvailable())
+            {
+                convert(slab, read);
+                if (!pending.empty())
+                {
+                    flush();
+                }
+                previousRead = 0;
+                continue;
+            }
+
+            previousSlab = slab;
+            previousRead = read;
+        }
+
+        // We may have been holding on to output in the hope to coalesce it with the next read.
+        // flush() drops it if we're closing.
+        if (!pending.empty())
+        {
+            flush();
         }
 
         return 0;
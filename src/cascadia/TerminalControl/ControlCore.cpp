@@ -9,6 +9,7 @@
 #include <dsound.h>
 
 #include <DefaultSettings.h>
+#include <til/unicode.h>
 #include <unicode.hpp>
 
 #include "EventArgs.h"
@@ -53,6 +54,50 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    static bool fontMapsEqual(const Windows::Foundation::Collections::IMap<winrt::hstring, float>& lhs, const Windows::Foundation::Collections::IMap<winrt::hstring, float>& rhs)
+    {
+        if (lhs == rhs)
+        {
+            return true;
+        }
+        if (!lhs || !rhs || lhs.Size() != rhs.Size())
+        {
+            return false;
+        }
+        for (const auto& [tag, param] : lhs)
+        {
+            if (!rhs.HasKey(tag) || rhs.Lookup(tag) != param)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns true if any of the settings used by _setFontSizeUnderLock() and _updateFont() differ.
+    static bool fontSettingsChanged(const IControlSettings& lhs, const IControlSettings& rhs)
+    {
+        return lhs.FontFace() != rhs.FontFace() ||
+               lhs.FontSize() != rhs.FontSize() ||
+               lhs.FontWeight().Weight != rhs.FontWeight().Weight ||
+               lhs.EnableBuiltinGlyphs() != rhs.EnableBuiltinGlyphs() ||
+               lhs.EnableColorGlyphs() != rhs.EnableColorGlyphs() ||
+               lhs.CellWidth() != rhs.CellWidth() ||
+               lhs.CellHeight() != rhs.CellHeight() ||
+               !fontMapsEqual(lhs.FontFeatures(), rhs.FontFeatures()) ||
+               !fontMapsEqual(lhs.FontAxes(), rhs.FontAxes());
+    }
+
+    // Returns true for Ctrl+C and Escape, which cancel a paste that's being streamed.
+    static bool isInterruptKey(const WORD vkey, const ::Microsoft::Terminal::Core::ControlKeyStates modifiers) noexcept
+    {
+        if (modifiers.IsAltPressed() || modifiers.IsShiftPressed() || modifiers.IsWinPressed())
+        {
+            return false;
+        }
+        return vkey == VK_ESCAPE ? !modifiers.IsCtrlPressed() : vkey == 'C' && modifiers.IsCtrlPressed();
+    }
+
     TextColor SelectionColor::AsTextColor() const noexcept
     {
         if (IsIndex16())
@@ -482,14 +527,51 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - This method has been overloaded to allow zero-copy winrt::param::hstring optimizations.
     // Arguments:
     // - wstr: the string of characters to write to the terminal connection.
+    // - interrupt: true if wstr is the result of pressing Ctrl+C or Escape.
     // Return Value:
     // - <none>
-    void ControlCore::_sendInputToConnection(std::wstring_view wstr)
+    void ControlCore::_sendInputToConnection(std::wstring_view wstr, bool interrupt)
     {
-        if (_connection)
+        if (!_connection)
         {
-            _connection.WriteInput(winrt_wstring_to_array_view(wstr));
+            return;
+        }
+
+        std::unique_lock pasteGuard{ _pasteLock };
+
+        // If a paste is being streamed in the background, anything we write now would end up
+        // in the middle of it. Queue it up instead, which also avoids blocking on the connection.
+        if (_pasteRunning)
+        {
+            PendingInput input{ .text = winrt::hstring{ wstr }, .connection = _connection, .interrupt = interrupt };
+
+            if (interrupt)
+            {
+                // An interrupt can't be written in the middle of the paste either, because the
+                // application would consider it to be part of it. Instead, it cancels the paste
+                // and gets sent right after the chunk that's currently being written.
+                _cancelPasteUnderLock();
+                const auto it = std::find_if(_inputQueue.begin(), _inputQueue.end(), [](const PendingInput& i) { return !i.interrupt; });
+                _inputQueue.insert(it, std::move(input));
+            }
+            else
+            {
+                _inputQueue.push_back(std::move(input));
+            }
+            return;
         }
+
+        // Acquiring the write lock before releasing the paste lock ensures
+        // that a paste that gets started concurrently can't overtake us.
+        const std::lock_guard writeGuard{ _connectionWriteLock };
+        pasteGuard.unlock();
+        _connection.WriteInput(winrt_wstring_to_array_view(wstr));
+    }
+
+    void ControlCore::_writeToConnection(const TerminalConnection::ITerminalConnection& connection, std::wstring_view wstr)
+    {
+        const std::lock_guard guard{ _connectionWriteLock };
+        connection.WriteInput(winrt_wstring_to_array_view(wstr));
     }
 
     // Method Description:
@@ -499,6 +581,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // Return Value:
     // - <none>
     void ControlCore::SendInput(const std::wstring_view wstr)
+    {
+        _sendInput(wstr, false);
+    }
+
+    void ControlCore::_sendInput(const std::wstring_view wstr, const bool interrupt)
     {
         if (wstr.empty())
         {
@@ -515,7 +602,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
         else
         {
-            _sendInputToConnection(wstr);
+            _sendInputToConnection(wstr, interrupt);
         }
     }
 
@@ -554,7 +641,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
         if (out)
         {
-            SendInput(*out);
+            _sendInput(*out, ch == L'\x3' || ch == L'\x1b');
             return true;
         }
         return false;
@@ -712,7 +799,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
         if (out)
         {
-            SendInput(*out);
+            _sendInput(*out, isInterruptKey(vkey, modifiers));
             return true;
         }
         return false;
@@ -909,7 +996,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - INVARIANT: This method can only be called if the caller DOES NOT HAVE writing lock on the terminal.
     void ControlCore::UpdateSettings(const IControlSettings& settings, const IControlAppearance& newAppearance)
     {
-        _settings = settings;
+        const auto previousSettings = std::exchange(_settings, settings);
         _hasUnfocusedAppearance = static_cast<bool>(newAppearance);
         _unfocusedAppearance = _hasUnfocusedAppearance ? newAppearance : settings;
 
@@ -925,7 +1012,13 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Manually turn off acrylic if they turn off transparency.
         _runtimeUseAcrylic = _settings.Opacity() < 1.0 && _settings.UseAcrylic();
 
-        const auto sizeChanged = _setFontSizeUnderLock(_settings.FontSize());
+        // Reloading the font is costly for the renderer, so skip it if no font setting changed.
+        // The constructor passes our current settings object and always gets a full update.
+        // If the font size was changed at runtime, we reset it as we always did.
+        const auto fontChanged = previousSettings == settings ||
+                                 fontSettingsChanged(previousSettings, settings) ||
+                                 _desiredFont.GetFontSize() != std::max(settings.FontSize(), 1.0f);
+        const auto sizeChanged = fontChanged && _setFontSizeUnderLock(_settings.FontSize());
 
         // Update the terminal core with its new Core settings
         _terminal->UpdateSettings(_settings);
@@ -1448,6 +1541,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return false;
     }
 
+    // Pastes longer than this are written to the connection in chunks of (about) this size from a
+    // background thread. This bounds the memory needed for filtering and keeps the UI responsive.
+    static constexpr size_t PasteChunkSize = 64 * 1024;
+
     // Method Description:
     // - Pre-process text pasted (presumably from the clipboard)
     //   before sending it over the terminal's connection.
@@ -1455,15 +1552,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         using namespace ::Microsoft::Console::Utils;
 
-        auto filtered = FilterStringForPaste(hstr, CarriageReturnNewline | ControlCodes);
-        if (BracketedPasteEnabled())
+        if (!_tryQueuePaste(hstr))
         {
-            filtered.insert(0, L"\x1b[200~");
-            filtered.append(L"\x1b[201~");
-        }
+            auto filtered = FilterStringForPaste(hstr, CarriageReturnNewline | ControlCodes);
+            if (BracketedPasteEnabled())
+            {
+                filtered.insert(0, L"\x1b[200~");
+                filtered.append(L"\x1b[201~");
+            }
 
-        // It's important to not hold the terminal lock while calling this function as sending the data may take a long time.
-        SendInput(filtered);
+            // It's important to not hold the terminal lock while calling this function as sending the data may take a long time.
+            SendInput(filtered);
+        }
 
         const auto lock = _terminal->LockForWriting();
         _terminal->ClearSelection();
@@ -1471,6 +1571,162 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _terminal->TrySnapOnInput();
     }
 
+    // Method Description:
+    // - Aborts all pastes that are currently queued or in progress. The one being written
+    //   right now stops after its current chunk, and is properly terminated if it's bracketed.
+    void ControlCore::CancelPaste()
+    {
+        const std::lock_guard guard{ _pasteLock };
+        _cancelPasteUnderLock();
+    }
+
+    void ControlCore::_cancelPasteUnderLock()
+    {
+        _pasteGeneration.fetch_add(1, std::memory_order_relaxed);
+        // Regular input that was queued behind a paste is still sent.
+        std::erase_if(_inputQueue, [](const PendingInput& input) { return input.paste; });
+    }
+
+    // Method Description:
+    // - Hands the paste off to _pasteInBackground() if it's too large to be sent synchronously,
+    //   or if another paste is still in progress (in which case it has to wait for its turn).
+    // Return Value:
+    // - true if the paste was queued and the caller shouldn't send it itself.
+    bool ControlCore::_tryQueuePaste(const winrt::hstring& hstr)
+    {
+        // SendInput() is responsible for the read-only warning.
+        if (_isReadOnly || !_connection)
+        {
+            return false;
+        }
+
+        const auto bracketed = BracketedPasteEnabled();
+        const std::lock_guard guard{ _pasteLock };
+
+        if (!_pasteRunning && hstr.size() <= PasteChunkSize)
+        {
+            return false;
+        }
+
+        _inputQueue.push_back(PendingInput{
+            .text = hstr,
+            .connection = _connection,
+            .paste = true,
+            .bracketed = bracketed,
+            .generation = _pasteGeneration.load(std::memory_order_relaxed),
+        });
+
+        if (!_pasteRunning)
+        {
+            _pasteRunning = true;
+            _pasteInBackground();
+        }
+        return true;
+    }
+
+    // Method Description:
+    // - Drains the input queue on a background thread. Only one of these runs at a time.
+    safe_void_coroutine ControlCore::_pasteInBackground()
+    {
+        const auto weakThis{ get_weak() };
+
+        co_await winrt::resume_background();
+
+        const auto core = weakThis.get();
+        if (!core)
+        {
+            co_return;
+        }
+
+        for (;;)
+        {
+            PendingInput input;
+            {
+                const std::lock_guard guard{ _pasteLock };
+                if (_inputQueue.empty())
+                {
+                    _pasteRunning = false;
+                    break;
+                }
+                input = std::move(_inputQueue.front());
+                _inputQueue.pop_front();
+            }
+
+            if (input.paste)
+            {
+                _streamPaste(input);
+            }
+            else
+            {
+                _writeToConnection(input.connection, input.text);
+            }
+        }
+    }
+
+    // Method Description:
+    // - Filters and writes the given paste in chunks of PasteChunkSize. Only the first
+    //   and last chunk receive the bracketed paste markers, so that the application still
+    //   sees a single paste. Back-pressure is provided by the connection itself:
+    //   WriteInput() blocks until the previous write has been consumed by the other side.
+    // - PasteProgress is raised when the paste starts, after every chunk and once more when it's done.
+    void ControlCore::_streamPaste(const PendingInput& paste)
+    {
+        using namespace ::Microsoft::Console::Utils;
+
+        std::wstring_view remaining{ paste.text };
+        const uint64_t total = remaining.size();
+        auto started = false;
+
+        PasteProgress.raise(*this, winrt::make<PasteProgressEventArgs>(0, total, false));
+
+        while (!remaining.empty() && _pasteGeneration.load(std::memory_order_relaxed) == paste.generation)
+        {
+            auto length = std::min(remaining.size(), PasteChunkSize);
+            if (length < remaining.size())
+            {
+                // Don't split surrogate pairs, and don't split a CRLF either,
+                // because FilterStringForPaste() would turn it into 2 newlines.
+                const auto last = til::at(remaining, length - 1);
+                if (til::is_leading_surrogate(last) || last == L'\r')
+                {
+                    length--;
+                }
+            }
+
+            auto chunk = FilterStringForPaste(remaining.substr(0, length), CarriageReturnNewline | ControlCodes);
+            remaining = remaining.substr(length);
+
+            if (paste.bracketed)
+            {
+                if (!started)
+                {
+                    chunk.insert(0, L"\x1b[200~");
+                }
+                if (remaining.empty())
+                {
+                    chunk.append(L"\x1b[201~");
+                }
+            }
+            started = true;
+
+            _writeToConnection(paste.connection, chunk);
+
+            if (!remaining.empty())
+            {
+                PasteProgress.raise(*this, winrt::make<PasteProgressEventArgs>(total - remaining.size(), total, false));
+            }
+        }
+
+        // The paste was canceled half-way through. Applications would
+        // otherwise consider everything that follows to be pasted text.
+        if (paste.bracketed && started && !remaining.empty())
+        {
+            _writeToConnection(paste.connection, L"\x1b[201~");
+        }
+
+        PasteProgress.raise(*this, winrt::make<PasteProgressEventArgs>(total - remaining.size(), total, true));
+    }
+
     FontInfo ControlCore::GetFont() const
     {
         return _actualFont;
@@ -1836,6 +2092,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _midiAudio.BeginSkip();
         }
 
+        CancelPaste();
         _closeConnection();
     }
 
@@ -1843,6 +2100,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         const auto lock = _terminal->LockForReading();
         _terminal->SerializeMainBuffer(handle);
+        // The caller opens existing files without truncating them, so that panes which
+        // were never shown can keep their previous contents (see TermControl::PersistTo).
+        LOG_IF_WIN32_BOOL_FALSE(SetEndOfFile(handle));
     }
 
     void ControlCore::RestoreFromPath(const wchar_t* path) const
@@ -1922,15 +2182,63 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             message = fmt::format(FMT_COMPILE(L"\x1b[100;37m  [{} {} {}]\x1b[K\x1b[m\r\n"), msg, date, time);
         }
 
+        // Must be called while holding the write lock.
+        const auto writeMessage = [&]() {
+            // Normally the cursor should already be at the start of the line, but let's be absolutely sure it is.
+            if (_terminal->GetTextBuffer().GetCursor().GetPosition().x != 0)
+            {
+                _terminal->Write(L"\r\n");
+            }
+            _terminal->Write(message);
+        };
+
         wchar_t buffer[32 * 1024];
         DWORD read = 0;
 
-        // Ensure the text file starts with a UTF-16 BOM.
-        if (!ReadFile(file.get(), &buffer[0], 2, &read, nullptr) || read < 2 || buffer[0] != L'\uFEFF')
+        if (!ReadFile(file.get(), &buffer[0], 2, &read, nullptr) || read < 2)
         {
             return;
         }
 
+        // PersistTo() writes binary snapshots (see TextBuffer::SerializeSnapshotTo()), which are
+        // copied straight into the buffer without going through the VT parser. We map the file instead
+        // of reading it, because the snapshot is only needed once and is copied out of it right away.
+        // Since we don't share write access, nobody can truncate the file while it's mapped.
+        // Files written by older versions are UTF-16 text with VT sequences instead and start with a BOM.
+        if (buffer[0] != L'\uFEFF')
+        {
+            LARGE_INTEGER fileSize{};
+            if (!GetFileSizeEx(file.get(), &fileSize) || fileSize.QuadPart > UINT32_MAX)
+            {
+                return;
+            }
+
+            const wil::unique_handle mapping{ CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr) };
+            if (!mapping)
+            {
+                return;
+            }
+
+            const wil::unique_mapview_ptr<char> view{ static_cast<char*>(MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0)) };
+            if (!view)
+            {
+                return;
+            }
+
+            const std::string_view snapshot{ view.get(), gsl::narrow_cast<size_t>(fileSize.QuadPart) };
+            const auto lock = _terminal->LockForWriting();
+            try
+            {
+                // A corrupted snapshot shouldn't prevent the rest of the session from being restored.
+                if (_terminal->RestoreMainBufferSnapshot(snapshot))
+                {
+                    writeMessage();
+                }
+            }
+            CATCH_LOG();
+            return;
+        }
+
         for (;;)
         {
             if (!ReadFile(file.get(), &buffer[0], sizeof(buffer), &read, nullptr))
@@ -1943,12 +2251,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
             if (read < sizeof(buffer))
             {
-                // Normally the cursor should already be at the start of the line, but let's be absolutely sure it is.
-                if (_terminal->GetTextBuffer().GetCursor().GetPosition().x != 0)
-                {
-                    _terminal->Write(L"\r\n");
-                }
-                _terminal->Write(message);
+                writeMessage();
                 break;
             }
         }
@@ -2475,6 +2778,43 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Releases memory we don't need while we aren't shown: The render thread is stopped,
+    //   the render engine drops its device, swap chain and caches, and the text buffers
+    //   give back rows they don't use. Resume() undoes this lazily, starting with the
+    //   next frame. Output is still processed as usual in the meantime.
+    void ControlCore::Hibernate()
+    {
+        if (!_initializedTerminal.load(std::memory_order_relaxed) || _hibernated || _IsClosing())
+        {
+            return;
+        }
+
+        _hibernated = true;
+
+        // Just like Detach(), stop the render thread first,
+        // so that it can't use the engine while we clean it up.
+        _renderer->TriggerTeardown();
+
+        const auto lock = _terminal->LockForWriting();
+        _renderEngine->ReleaseResources();
+        _terminal->TrimMemory();
+        _lastSwapChainHandle = {};
+    }
+
+    void ControlCore::Resume()
+    {
+        if (!std::exchange(_hibernated, false) || _IsClosing())
+        {
+            return;
+        }
+
+        // The lock must be held, because it calls into IRenderData which is shared state.
+        const auto lock = _terminal->LockForWriting();
+        _renderer->EnablePainting();
+        _renderer->TriggerRedrawAll();
+    }
+
     // Method Description:
     // - When the control gains focus, it needs to tell ConPTY about this.
     //   Usually, these sequences are reserved for applications that
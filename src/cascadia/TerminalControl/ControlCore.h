@@ -24,6 +24,8 @@
 #include "../../cascadia/TerminalCore/Terminal.hpp"
 #include "../../renderer/inc/FontInfoDesired.hpp"
 
+#include <til/ticket_lock.h>
+
 namespace Microsoft::Console::Render::Atlas
 {
     class AtlasEngine;
@@ -124,6 +126,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void SendInput(std::wstring_view wstr);
         void PasteText(const winrt::hstring& hstr);
+        void CancelPaste();
         bool CopySelectionToClipboard(bool singleLine, bool withControlSequences, const CopyFormat formats);
         void SelectAll();
         void ClearSelection();
@@ -249,6 +252,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void AdjustOpacity(const float opacity, const bool relative);
 
         void WindowVisibilityChanged(const bool showOrHide);
+        void Hibernate();
+        void Resume();
 
         uint64_t OwningHwnd();
         void OwningHwnd(uint64_t owner);
@@ -294,6 +299,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         til::typed_event<IInspectable, Control::SearchMissingCommandEventArgs> SearchMissingCommand;
         til::typed_event<> RefreshQuickFixUI;
         til::typed_event<IInspectable, Control::WindowSizeChangedEventArgs> WindowSizeChanged;
+        til::typed_event<IInspectable, Control::PasteProgressEventArgs> PasteProgress;
 
         til::typed_event<> CloseTerminalRequested;
         til::typed_event<> RestartTerminalRequested;
@@ -319,7 +325,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         bool _shouldTryUpdateSelection(const WORD vkey);
 
         void _handleControlC();
-        void _sendInputToConnection(std::wstring_view wstr);
+        void _sendInput(std::wstring_view wstr, bool interrupt);
+        void _sendInputToConnection(std::wstring_view wstr, bool interrupt = false);
 
 #pragma region TerminalCoreCallbacks
         void _terminalWarningBell();
@@ -346,6 +353,24 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void _rendererEnteredErrorState();
 #pragma endregion
 
+        struct PendingInput
+        {
+            winrt::hstring text;
+            TerminalConnection::ITerminalConnection connection{ nullptr };
+            // false for regular input (key presses, VT responses, etc.) that was sent during a paste.
+            bool paste = false;
+            // Ctrl+C and Escape. They cancel the paste and skip ahead of regular input.
+            bool interrupt = false;
+            bool bracketed = false;
+            uint64_t generation = 0;
+        };
+
+        bool _tryQueuePaste(const winrt::hstring& hstr);
+        void _cancelPasteUnderLock();
+        safe_void_coroutine _pasteInBackground();
+        void _streamPaste(const PendingInput& paste);
+        void _writeToConnection(const TerminalConnection::ITerminalConnection& connection, std::wstring_view wstr);
+
         void _raiseReadOnlyWarning();
         void _updateAntiAliasingMode();
         void _connectionOutputHandler(winrt::array_view<const char16_t> str);
@@ -384,6 +409,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Caches responses generated by our VT parser (= improved batching).
         std::wstring _pendingResponses;
 
+        // Large pastes are streamed to the connection from a background thread. Any input
+        // sent while that's going on, including other pastes, is queued up behind it, so that
+        // it can't end up in the middle of the paste. Ctrl+C and Escape cancel the paste instead.
+        // CancelPaste() bumps the generation, which aborts all pastes started before it.
+        std::mutex _pasteLock;
+        std::deque<PendingInput> _inputQueue;
+        bool _pasteRunning = false;
+        std::atomic<uint64_t> _pasteGeneration{ 0 };
+        // Serializes all calls to ITerminalConnection::WriteInput(). Most connections
+        // don't expect to be called from multiple threads at the same time.
+        til::ticket_lock _connectionWriteLock;
+
         // Font stuff.
         FontInfoDesired _desiredFont;
         FontInfo _actualFont;
@@ -421,6 +458,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         std::atomic<bool> _initializedTerminal{ false };
         bool _isReadOnly{ false };
         bool _closing{ false };
+        bool _hibernated{ false };
 
         struct StashedColorScheme
         {
@@ -21,6 +21,7 @@
 #include "StringSentEventArgs.g.h"
 #include "SearchMissingCommandEventArgs.g.h"
 #include "WindowSizeChangedEventArgs.g.h"
+#include "PasteProgressEventArgs.g.h"
 
 namespace winrt::Microsoft::Terminal::Control::implementation
 {
@@ -265,6 +266,23 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         WINRT_PROPERTY(int32_t, Width);
         WINRT_PROPERTY(int32_t, Height);
     };
+
+    struct PasteProgressEventArgs : public PasteProgressEventArgsT<PasteProgressEventArgs>
+    {
+    public:
+        PasteProgressEventArgs(uint64_t written,
+                               uint64_t total,
+                               bool completed) :
+            _Written(written),
+            _Total(total),
+            _Completed(completed)
+        {
+        }
+
+        WINRT_PROPERTY(uint64_t, Written);
+        WINRT_PROPERTY(uint64_t, Total);
+        WINRT_PROPERTY(bool, Completed);
+    };
 }
 
 namespace winrt::Microsoft::Terminal::Control::factory_implementation
@@ -312,6 +312,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _revokers.RaiseNotice = _core.RaiseNotice(winrt::auto_revoke, { get_weak(), &TermControl::_coreRaisedNotice });
         _revokers.HoveredHyperlinkChanged = _core.HoveredHyperlinkChanged(winrt::auto_revoke, { get_weak(), &TermControl::_hoveredHyperlinkChanged });
         _revokers.OutputIdle = _core.OutputIdle(winrt::auto_revoke, { get_weak(), &TermControl::_coreOutputIdle });
+        _revokers.PasteProgress = _core.PasteProgress(winrt::auto_revoke, { get_weak(), &TermControl::_corePasteProgress });
         _revokers.UpdateSelectionMarkers = _core.UpdateSelectionMarkers(winrt::auto_revoke, { get_weak(), &TermControl::_updateSelectionMarkers });
         _revokers.coreOpenHyperlink = _core.OpenHyperlink(winrt::auto_revoke, { get_weak(), &TermControl::_HyperlinkHandler });
         _revokers.interactivityOpenHyperlink = _interactivity.OpenHyperlink(winrt::auto_revoke, { get_weak(), &TermControl::_HyperlinkHandler });
@@ -394,6 +395,15 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _revokers.coreScrollPositionChanged = _core.ScrollPositionChanged(winrt::auto_revoke, { get_weak(), &TermControl::_ScrollPositionChanged });
         _revokers.WarningBell = _core.WarningBell(winrt::auto_revoke, { get_weak(), &TermControl::_coreWarningBell });
 
+        // Controls in background tabs may get hibernated by their owner (see Hibernate()).
+        // Being loaded into the tree again means that we're about to be shown.
+        Loaded([weakThis = get_weak()](auto&&, auto&&) {
+            if (auto control{ weakThis.get() }; control && !control->_IsClosing())
+            {
+                get_self<ControlCore>(control->_core)->Resume();
+            }
+        });
+
         static constexpr auto AutoScrollUpdateInterval = std::chrono::microseconds(static_cast<int>(1.0 / 30.0 * 1000000));
         _autoScrollTimer.Interval(AutoScrollUpdateInterval);
         _autoScrollTimer.Tick({ get_weak(), &TermControl::_UpdateAutoScroll });
@@ -2627,7 +2637,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // If we were supposed to be restored from a path, then we don't need to
         // do anything special here. We'll leave the original file untouched,
         // and the next time we actually are initialized, we'll just use that
-        // file then.
+        // file then. This is what allows restored tabs to stay unmaterialized
+        // until they're shown, across any number of restarts.
         if (_initializedTerminal)
         {
             winrt::get_self<ControlCore>(_core)->PersistTo(reinterpret_cast<HANDLE>(handle));
@@ -2949,6 +2960,30 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     void TermControl::WindowVisibilityChanged(const bool showOrHide)
     {
         _core.WindowVisibilityChanged(showOrHide);
+
+        // We may have been hibernated while the window was minimized. Controls in
+        // background tabs aren't loaded and resume once they're shown instead.
+        if (showOrHide && IsLoaded())
+        {
+            get_self<ControlCore>(_core)->Resume();
+        }
+    }
+
+    // Method Description:
+    // - Releases the renderer resources and unused buffer memory of a control that isn't
+    //   shown right now. The control resumes on its own once it's loaded into the tree again.
+    void TermControl::Hibernate()
+    {
+        if (!_initializedTerminal || _IsClosing())
+        {
+            return;
+        }
+
+        get_self<ControlCore>(_core)->Hibernate();
+
+        // The panel would otherwise keep the old swap chain and its buffers alive.
+        // A new one gets attached via RenderEngineSwapChainChanged once we render again.
+        _AttachDxgiSwapChainToXaml(nullptr);
     }
 
     // Method Description:
@@ -3358,6 +3393,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - The taskbar state of this control
     const uint64_t TermControl::TaskbarState() const noexcept
     {
+        if (_pasteProgress)
+        {
+            return static_cast<uint64_t>(::Microsoft::Console::VirtualTerminal::DispatchTypes::TaskbarState::Set);
+        }
         return _core.TaskbarState();
     }
 
@@ -3367,6 +3406,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - The taskbar progress of this control
     const uint64_t TermControl::TaskbarProgress() const noexcept
     {
+        if (_pasteProgress)
+        {
+            return *_pasteProgress;
+        }
         return _core.TaskbarProgress();
     }
 
@@ -3667,6 +3710,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
 
         _searchScrollOffset = _calculateSearchScrollOffset();
+
+        // The Pane needs to know about this, because its size snaps to our cells.
+        FontSizeChanged.raise(*this, args);
     }
 
     void TermControl::_coreRaisedNotice(const IInspectable& /*sender*/,
@@ -3845,6 +3891,33 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _refreshSearch();
     }
 
+    // Method Description:
+    // - Large pastes are written in the background. While that's going on, we show
+    //   their progress in place of the taskbar progress (and thus in the tab).
+    //   Ctrl+C and Escape cancel them (see ControlCore::_sendInputToConnection).
+    safe_void_coroutine TermControl::_corePasteProgress(IInspectable /*sender*/, Control::PasteProgressEventArgs args)
+    {
+        const auto weakThis{ get_weak() };
+
+        // This is raised on the background thread that writes the paste.
+        co_await wil::resume_foreground(Dispatcher());
+
+        if (const auto self{ weakThis.get() })
+        {
+            if (args.Completed())
+            {
+                _pasteProgress.reset();
+            }
+            else
+            {
+                const auto total = std::max<uint64_t>(1, args.Total());
+                _pasteProgress = args.Written() * 100 / total;
+            }
+
+            _SetTaskbarProgressHandlers(*this, nullptr);
+        }
+    }
+
     void TermControl::OwningHwnd(uint64_t owner)
     {
         _core.OwningHwnd(owner);
@@ -1531,7 +1531,77 @@ std::wstring Terminal::CurrentCommand() const
 
 void Terminal::SerializeMainBuffer(HANDLE handle) const
 {
-    _mainBuffer->SerializeTo(handle);
+    _mainBuffer->SerializeSnapshotTo(handle);
+}
+
+// Method Description:
+// - Gives memory back that the text buffers don't need to hold their current contents.
+//   See TextBuffer::TrimCommittedMemory(). Meant for terminals that aren't shown.
+void Terminal::TrimMemory() noexcept
+{
+    if (_mainBuffer)
+    {
+        _mainBuffer->TrimCommittedMemory();
+    }
+    if (_altBuffer)
+    {
+        _altBuffer->TrimCommittedMemory();
+    }
+}
+
+// Method Description:
+// - Replaces the main buffer with the contents of a snapshot that was written by
+//   SerializeMainBuffer(), reflowing it to the current width if necessary. This is
+//   only meant to be called during session restore, before any output was received.
+// - Afterwards the cursor is placed right after the last restored character.
+// Arguments:
+// - data: the contents of the snapshot file
+// Return Value:
+// - false if data isn't a valid snapshot, in which case the buffer is left untouched.
+bool Terminal::RestoreMainBufferSnapshot(std::string_view data)
+{
+    const auto snapshotSize = TextBuffer::GetSnapshotSize(data);
+    if (!snapshotSize || _inAltBuffer())
+    {
+        return false;
+    }
+
+    // The snapshot may have been taken at a different width, so we load it as-is into
+    // a scratch buffer and then let Reflow() do the work, just like UserResize() does.
+    // Reflow() would drop anything beyond our scrollback anyway, so we don't need to allocate more
+    // rows than that. This also limits the damage a corrupted row count can do.
+    const auto bufferSize = _mainBuffer->GetSize().Dimensions();
+    const til::size scratchSize{ snapshotSize->width, std::min(snapshotSize->height, bufferSize.height) };
+    TextBuffer snapshot{ scratchSize, TextAttribute{}, 0, false, _mainBuffer->GetRenderer() };
+    if (!snapshot.LoadSnapshot(data))
+    {
+        return false;
+    }
+    snapshot.CopyProperties(*_mainBuffer);
+    snapshot.GetCursor().SetSize(_mainBuffer->GetCursor().GetSize());
+
+    auto newTextBuffer = std::make_unique<TextBuffer>(bufferSize,
+                                                      TextAttribute{},
+                                                      0,
+                                                      _mainBuffer->IsActiveBuffer(),
+                                                      _mainBuffer->GetRenderer());
+    TextBuffer::Reflow(snapshot, *newTextBuffer.get());
+    newTextBuffer->SetCurrentAttributes(_mainBuffer->GetCurrentAttributes());
+
+    auto& cursor = newTextBuffer->GetCursor();
+    const auto lastRow = newTextBuffer->GetLastNonSpaceCharacter().y;
+    const auto lastColumn = newTextBuffer->GetRowByOffset(lastRow).MeasureRight();
+    cursor.SetPosition({ std::min(lastColumn, bufferSize.width - 1), lastRow });
+
+    const auto viewportSize = _mutableViewport.Dimensions();
+    const auto proposedTop = std::max(0, lastRow - viewportSize.height + 1);
+    _mutableViewport = Viewport::FromDimensions({ 0, proposedTop }, viewportSize);
+    _scrollOffset = 0;
+
+    _mainBuffer.swap(newTextBuffer);
+    _mainBuffer->TriggerRedrawAll();
+    _NotifyScrollEvent();
+    return true;
 }
 
 void Terminal::UnknownSequence() noexcept
@@ -129,6 +129,8 @@ public:
     std::wstring CurrentCommand() const;
 
     void SerializeMainBuffer(HANDLE handle) const;
+    void TrimMemory() noexcept;
+    bool RestoreMainBufferSnapshot(std::string_view data);
 
 #pragma region ITerminalApi
     // These methods are defined in TerminalApi.cpp
@@ -445,6 +445,77 @@ namespace winrt::Microsoft::Terminal::Settings
         table = winrt::com_array(span.begin(), span.end());
     }
 
+    // Most setting types compare by value already, but the WinRT references and maps
+    // compare by identity, which differs between two TerminalSettings built from the same profile.
+    template<typename T>
+    static bool settingEqual(const T& lhs, const T& rhs)
+    {
+        return lhs == rhs;
+    }
+
+    template<typename T>
+    static bool settingEqual(const Windows::Foundation::IReference<T>& lhs, const Windows::Foundation::IReference<T>& rhs)
+    {
+        return lhs == rhs || (lhs && rhs && lhs.Value() == rhs.Value());
+    }
+
+    template<typename K, typename V>
+    static bool settingEqual(const Windows::Foundation::Collections::IMapView<K, V>& lhs, const Windows::Foundation::Collections::IMapView<K, V>& rhs)
+    {
+        if (lhs == rhs)
+        {
+            return true;
+        }
+        if (!lhs || !rhs || lhs.Size() != rhs.Size())
+        {
+            return false;
+        }
+        for (const auto& pair : lhs)
+        {
+            if (!rhs.HasKey(pair.Key()) || rhs.Lookup(pair.Key()) != pair.Value())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename K, typename V>
+    static bool settingEqual(const Windows::Foundation::Collections::IMap<K, V>& lhs, const Windows::Foundation::Collections::IMap<K, V>& rhs)
+    {
+        return lhs == rhs || (lhs && rhs && settingEqual(lhs.GetView(), rhs.GetView()));
+    }
+
+    template<typename T>
+    static bool settingEqual(const std::optional<T>& lhs, const std::optional<T>& rhs)
+    {
+        return lhs.has_value() == rhs.has_value() && (!lhs || settingEqual(*lhs, *rhs));
+    }
+
+    // Method Description:
+    // - Returns true if this object and `other` specify the same values for all settings.
+    //   The parents aren't compared, as TerminalSettingsCache compares both halves of a
+    //   TerminalSettingsCreateResult individually.
+    bool TerminalSettings::SettingsEqual(const TerminalSettings& other) const
+    {
+#define SETTING_EQUAL(type, name, ...)         \
+    if (!settingEqual(_##name, other._##name)) \
+    {                                          \
+        return false;                          \
+    }
+
+        CORE_APPEARANCE_SETTINGS(SETTING_EQUAL)
+        CONTROL_APPEARANCE_SETTINGS(SETTING_EQUAL)
+        CORE_SETTINGS(SETTING_EQUAL)
+        CONTROL_SETTINGS(SETTING_EQUAL)
+        SETTING_EQUAL(bool, Elevate)
+        SETTING_EQUAL(IEnvironmentVariableMapView, EnvironmentVariables)
+        SETTING_EQUAL(bool, ReloadEnvironmentVariables)
+#undef SETTING_EQUAL
+
+        return settingEqual(_ColorTable, other._ColorTable);
+    }
+
     std::span<winrt::Microsoft::Terminal::Core::Color> TerminalSettings::_getColorTableImpl()
     {
         if (_ColorTable.has_value())
@@ -66,6 +66,7 @@ namespace winrt::Microsoft::Terminal::Settings
                                                                       const Model::NewTerminalArgs& newTerminalArgs);
 
         void ApplyColorScheme(const Model::ColorScheme& scheme);
+        bool SettingsEqual(const TerminalSettings& other) const;
 
         void GetColorTable(winrt::com_array<Microsoft::Terminal::Core::Color>& table) noexcept;
         void SetColorTable(const std::array<Microsoft::Terminal::Core::Color, 16>& colors);
@@ -238,21 +238,21 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         //    "action" in that object as the action name. We'll then pass
         //    the json object to the arg parser, for further parsing.
 
-        auto argsVal = Json::Value::null;
+        // Points into `json` instead of copying it, as the args may be arbitrarily large.
+        auto argsVal = &Json::Value::nullSingleton();
 
         // Only try to parse the action if it's actually a string value.
         // `null` will not pass this check.
         if (json.isString())
         {
-            auto commandString = json.asString();
-            action = GetActionFromString(commandString);
+            action = GetActionFromString(JsonUtils::Detail::GetStringView(json));
         }
         else if (json.isObject())
         {
             if (const auto actionString{ JsonUtils::GetValueForKey<std::optional<std::string>>(json, ActionKey) })
             {
                 action = GetActionFromString(*actionString);
-                argsVal = json;
+                argsVal = &json;
             }
         }
 
@@ -267,7 +267,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             auto pfn = deserializersIter->second.first;
             if (pfn)
             {
-                std::tie(args, parseWarnings) = pfn(argsVal);
+                std::tie(args, parseWarnings) = pfn(*argsVal);
             }
             warnings.insert(warnings.end(), parseWarnings.begin(), parseWarnings.end());
 
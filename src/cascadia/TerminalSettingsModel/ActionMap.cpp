@@ -345,6 +345,12 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         {
             _KeyMap.insert_or_assign(key, cmdID);
         }
+
+        // This is the last step of loading the settings, so it's the best time
+        // to compile the final set of key bindings for GetActionByKeyChord().
+        // The above may have modified this layer, which any children need to know about.
+        _InvalidateKeyDispatchTable();
+        _RefreshKeyDispatchTable();
     }
 
     bool ActionMap::FixupsAppliedDuringLoad() const
@@ -647,6 +653,90 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _AllCommandsCache = single_threaded_vector(std::move(allCommandsVector));
     }
 
+    // Method Description:
+    // - Compiles the key bindings of all layers into _KeyDispatchTableCache.
+    //   Every key press goes through GetActionByKeyChord(), which can then
+    //   resolve it with a single binary search over a contiguous array instead of
+    //   walking our parents and their hstring-keyed maps.
+    // - KeyChord::Hash() is a bijective mix of the modifiers and the vkey (or scan code),
+    //   which are exactly the fields KeyChord::Equals() compares. Two chords thus have
+    //   the same hash if and only if they're equal, so the hash alone is a sufficient key.
+    void ActionMap::_RefreshKeyDispatchTable()
+    {
+        _RefreshKeyBindingCaches();
+
+        std::vector<std::pair<uint64_t, Model::Command>> table;
+        table.reserve(_CumulativeKeyToActionMapCache.size());
+
+        for (const auto& [keys, cmdID] : _CumulativeKeyToActionMapCache)
+        {
+            // Just like _GetActionByKeyChordInternal(), we treat keys
+            // with an empty or unknown ID as explicitly unbound.
+            Model::Command cmd{ nullptr };
+            if (const auto idCmdPair = _CumulativeIDToActionMapCache.find(cmdID); idCmdPair != _CumulativeIDToActionMapCache.end())
+            {
+                cmd = idCmdPair->second;
+            }
+            table.emplace_back(keys.Hash(), std::move(cmd));
+        }
+
+        std::ranges::sort(table, {}, &std::pair<uint64_t, Model::Command>::first);
+        _KeyDispatchTableCache = std::move(table);
+
+        _KeyDispatchTableRevisions.clear();
+        _CollectRevisions(_KeyDispatchTableRevisions);
+    }
+
+    // Method Description:
+    // - Discards _KeyDispatchTableCache and gives this layer a new revision. The latter
+    //   invalidates the dispatch tables of all the layers that inherit from this one.
+    //   This needs to be called whenever the key bindings or commands of this layer change.
+    void ActionMap::_InvalidateKeyDispatchTable() noexcept
+    {
+        _KeyDispatchTableCache.reset();
+        _revision = _NextRevision();
+    }
+
+    // Method Description:
+    // - Appends the revisions of this layer and all of its parents, depth-first.
+    void ActionMap::_CollectRevisions(std::vector<uint64_t>& revisions) const
+    {
+        revisions.emplace_back(_revision);
+        for (const auto& parent : _parents)
+        {
+            parent->_CollectRevisions(revisions);
+        }
+    }
+
+    // Method Description:
+    // - The counterpart to _CollectRevisions(). Consumes the revisions of this layer and
+    //   all of its parents from the front of the given span.
+    // Return Value:
+    // - false if any of them doesn't match, or if there are fewer layers than revisions.
+    bool ActionMap::_MatchesRevisions(std::span<const uint64_t>& revisions) const noexcept
+    {
+        if (revisions.empty() || revisions.front() != _revision)
+        {
+            return false;
+        }
+
+        revisions = revisions.subspan(1);
+        for (const auto& parent : _parents)
+        {
+            if (!parent->_MatchesRevisions(revisions))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint64_t ActionMap::_NextRevision() noexcept
+    {
+        static std::atomic<uint64_t> revision{ 0 };
+        return revision.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
     com_ptr<ActionMap> ActionMap::Copy() const
     {
         auto actionMap{ make_self<ActionMap>() };
@@ -697,6 +787,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         }
 
         // invalidate caches
+        _InvalidateKeyDispatchTable();
         _CumulativeKeyToActionMapCache.clear();
         _CumulativeIDToActionMapCache.clear();
         _CumulativeActionToKeyMapCache.clear();
@@ -884,6 +975,20 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     // - nullopt if it is not bound
     std::optional<Model::Command> ActionMap::_GetActionByKeyChordInternal(const Control::KeyChord& keys) const
     {
+        // The dispatch table is only valid as long as neither this layer nor any of its parents have changed.
+        std::span<const uint64_t> revisions{ _KeyDispatchTableRevisions };
+        if (_KeyDispatchTableCache && _MatchesRevisions(revisions) && revisions.empty())
+        {
+            const auto hash = keys.Hash();
+            const auto& table = *_KeyDispatchTableCache;
+            const auto it = std::ranges::lower_bound(table, hash, {}, &std::pair<uint64_t, Model::Command>::first);
+            if (it != table.end() && it->first == hash)
+            {
+                return it->second;
+            }
+            return std::nullopt;
+        }
+
         if (const auto actionIDOptional = _GetActionIdByKeyChordInternal(keys))
         {
             if (!actionIDOptional->empty())
@@ -958,6 +1063,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             return false;
         }
 
+        _InvalidateKeyDispatchTable();
         if (auto oldKeyPair = _KeyMap.find(oldKeys); oldKeyPair != _KeyMap.end())
         {
             // oldKeys is bound in our layer, replace it with newKeys
@@ -982,6 +1088,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     // - <none>
     void ActionMap::DeleteKeyBinding(const KeyChord& keys)
     {
+        _InvalidateKeyDispatchTable();
         if (auto keyPair = _KeyMap.find(keys); keyPair != _KeyMap.end())
         {
             // this keychord is bound in our layer, delete it
@@ -999,6 +1106,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
     void ActionMap::AddKeyBinding(Control::KeyChord keys, const winrt::hstring& cmdID)
     {
+        _InvalidateKeyDispatchTable();
         _KeyMap.insert_or_assign(keys, cmdID);
         _changeLog.emplace(KeysKey);
         _RefreshKeyBindingCaches();
@@ -1022,6 +1130,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
     void ActionMap::DeleteUserCommand(const winrt::hstring& cmdID)
     {
+        _InvalidateKeyDispatchTable();
         _ActionMap.erase(cmdID);
         _RefreshKeyBindingCaches();
     }
@@ -1211,6 +1320,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         }
         if (newID != oldID)
         {
+            _InvalidateKeyDispatchTable();
             if (const auto foundCmd{ _GetActionByID(newID) })
             {
                 const auto foundCmdActionAndArgs = foundCmd.ActionAndArgs();
@@ -1273,9 +1383,9 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         }
 
         std::unordered_map<hstring, Model::Command> result;
-        if (auto actions{ root[JsonKey("snippets")] })
+        if (const auto actions = JsonUtils::FindMember(root, "snippets"))
         {
-            for (const auto& json : actions)
+            for (const auto& json : *actions)
             {
                 const auto snippet = Command::FromSnippetJson(json);
                 result.insert_or_assign(snippet->Name(), *snippet);
@@ -111,6 +111,11 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         std::optional<Model::Command> _GetActionByKeyChordInternal(const Control::KeyChord& keys) const;
 
         void _RefreshKeyBindingCaches();
+        void _RefreshKeyDispatchTable();
+        void _InvalidateKeyDispatchTable() noexcept;
+        void _CollectRevisions(std::vector<uint64_t>& revisions) const;
+        bool _MatchesRevisions(std::span<const uint64_t>& revisions) const noexcept;
+        static uint64_t _NextRevision() noexcept;
         void _PopulateAvailableActionsWithStandardCommands(std::unordered_map<hstring, Model::ActionAndArgs>& availableActions, std::unordered_set<InternalActionID>& visitedActionIDs) const;
         void _PopulateNameMapWithSpecialCommands(std::unordered_map<hstring, Model::Command>& nameMap) const;
         void _PopulateNameMapWithStandardCommands(std::unordered_map<hstring, Model::Command>& nameMap) const;
@@ -156,6 +161,16 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         Windows::Foundation::Collections::IMap<Control::KeyChord, Model::Command> _ResolvedKeyToActionMapCache{ nullptr };
         Windows::Foundation::Collections::IVector<Model::Command> _AllCommandsCache{ nullptr };
 
+        // _KeyDispatchTableCache is _ResolvedKeyToActionMapCache flattened into a vector of (KeyChord::Hash(), command) pairs,
+        // sorted by hash. Explicitly unbound key chords map to nullptr. It's built once when inheritance is finalized and
+        // discarded whenever this layer is modified, in which case lookups resolve the layers one by one again.
+        std::optional<std::vector<std::pair<uint64_t, Model::Command>>> _KeyDispatchTableCache;
+        // Every modification gives a layer a new, globally unique _revision. _KeyDispatchTableRevisions holds the
+        // revisions of this layer and all of its parents (depth-first) at the time the table was built. If any of them
+        // has changed since, for instance because the settings UI modified a parent, the table is stale and isn't used.
+        std::vector<uint64_t> _KeyDispatchTableRevisions;
+        uint64_t _revision{ _NextRevision() };
+
         til::shared_mutex<std::unordered_map<std::filesystem::path, std::unordered_map<hstring, Model::Command>>> _cwdLocalSnippetsCache{};
 
         std::set<std::string> _changeLog;
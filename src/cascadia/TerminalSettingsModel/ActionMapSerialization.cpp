@@ -62,10 +62,10 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
             // if there are keys, extract them first
             Control::KeyChord keys{ nullptr };
-            if (withKeybindings && jsonBlock.isMember(JsonKey(KeysKey)))
+            const auto keysJson = JsonUtils::FindMember(jsonBlock, KeysKey);
+            if (withKeybindings && keysJson)
             {
-                const auto keysJson{ jsonBlock[JsonKey(KeysKey)] };
-                if (keysJson.isArray() && keysJson.size() > 1)
+                if (keysJson->isArray() && keysJson->size() > 1)
                 {
                     warnings.push_back(SettingsLoadWarnings::TooManyKeysForChord);
                 }
@@ -76,14 +76,15 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             }
 
             // Now check if this is a command block
-            if (jsonBlock.isMember(JsonKey(CommandsKey)) || jsonBlock.isMember(JsonKey(ActionKey)))
+            const auto hasAction = JsonUtils::FindMember(jsonBlock, ActionKey) != nullptr;
+            if (hasAction || JsonUtils::FindMember(jsonBlock, CommandsKey))
             {
                 auto command = Command::FromJson(jsonBlock, warnings, origin);
                 command->LogSettingChanges(_changeLog);
                 AddAction(*command, keys);
 
-                if (jsonBlock.isMember(JsonKey(ActionKey)) && !jsonBlock.isMember(JsonKey(IterateOnKey)) && origin == OriginTag::User &&
-                    (!jsonBlock.isMember(JsonKey(IDKey)) || jsonBlock.isMember(JsonKey(KeysKey))))
+                if (hasAction && !JsonUtils::FindMember(jsonBlock, IterateOnKey) && origin == OriginTag::User &&
+                    (!JsonUtils::FindMember(jsonBlock, IDKey) || keysJson))
                 {
                     // for non-nested non-iterable commands,
                     // if there's no ID in the command block we will generate one for the user,
@@ -101,6 +102,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
                 JsonUtils::GetValueForKey(jsonBlock, IDKey, idJson);
 
                 // any existing keybinding with the same keychord in this layer will get overwritten
+                _InvalidateKeyDispatchTable();
                 _KeyMap.insert_or_assign(keys, idJson);
 
                 if (!_changeLog.contains(KeysKey.data()))
@@ -112,8 +114,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
                     bool isUserDefaultKbd = false;
                     for (const auto& [id, kbd] : userDefaultKbds)
                     {
-                        const auto keyJson{ jsonBlock.find(&*KeysKey.cbegin(), (&*KeysKey.cbegin()) + KeysKey.size()) };
-                        if (idJson == id && keyJson->asString() == kbd)
+                        if (idJson == id && keysJson->asString() == kbd)
                         {
                             isUserDefaultKbd = true;
                             break;
@@ -96,6 +96,9 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         bool AddDynamicProfileFolders();
         bool RemapColorSchemeForProfile(const winrt::com_ptr<winrt::Microsoft::Terminal::Settings::Model::implementation::Profile>& profile);
         bool FixupUserSettings();
+        void LoadFragmentCache(const std::string_view& data);
+        bool FragmentCacheChanged() const noexcept;
+        std::string SerializeFragmentCache() const;
 
         ParsedSettings inboxSettings;
         ParsedSettings userSettings;
@@ -117,6 +120,14 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             std::wstring_view jsonFilename;
             FragmentScope scope;
         };
+        struct CachedFragment
+        {
+            int64_t lastWriteTime = 0;
+            uint64_t size = 0;
+            std::string content;
+            bool used = false;
+            bool stale = false;
+        };
         SettingsLoader() = default;
 
         static std::pair<size_t, size_t> _lineAndColumnFromPosition(const std::string_view& string, const size_t position);
@@ -125,13 +136,16 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         static const Json::Value& _getJSONValue(const Json::Value& json, const std::string_view& key) noexcept;
         std::span<const winrt::com_ptr<implementation::Profile>> _getNonUserOriginProfiles() const;
         void _parse(const OriginTag origin, const winrt::hstring& source, const std::string_view& content, ParsedSettings& settings);
-        void _parseFragment(const winrt::hstring& source, const winrt::hstring& sourceBasePath, const std::string_view& content, ParsedSettings& settings, const std::optional<ParseFragmentMetadata>& fragmentMeta);
+        void _parseFragment(const winrt::hstring& source, const winrt::hstring& sourceBasePath, JsonSettings&& json, ParsedSettings& settings, const std::optional<ParseFragmentMetadata>& fragmentMeta);
         static JsonSettings _parseJson(const std::string_view& content);
         static winrt::com_ptr<implementation::Profile> _parseProfile(const OriginTag origin, const winrt::hstring& source, const Json::Value& profileJson);
         void _appendProfile(winrt::com_ptr<Profile>&& profile, const winrt::guid& guid, ParsedSettings& settings);
         void _addUserProfileParent(const winrt::com_ptr<implementation::Profile>& profile);
         bool _addOrMergeUserColorScheme(const winrt::com_ptr<implementation::ColorScheme>& colorScheme);
+        void _generateProfiles(std::span<const IDynamicProfileGenerator* const> generators);
         static void _executeGenerator(const IDynamicProfileGenerator& generator, std::vector<winrt::com_ptr<implementation::Profile>>& profilesList);
+        CachedFragment& _findCachedFragment(const std::filesystem::directory_entry& entry);
+        static void _refreshCachedFragment(const std::filesystem::path& path, CachedFragment& fragment);
         winrt::com_ptr<implementation::ExtensionPackage> _registerFragment(const winrt::Microsoft::Terminal::Settings::Model::FragmentSettings& fragment, FragmentScope scope);
         Json::StreamWriterBuilder _getJsonStyledWriter();
 
@@ -139,6 +153,11 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         std::set<std::string> themesChangeLog;
         // See _getNonUserOriginProfiles().
         size_t _userProfileCount = 0;
+        // Fragment files by path. See LoadFragmentCache().
+        std::unordered_map<std::wstring, CachedFragment> _fragmentCache;
+        bool _fragmentCacheChanged = false;
+
+        friend class SettingsModelUnitTests::DeserializationTests;
     };
 
     struct CascadiaSettings : CascadiaSettingsT<CascadiaSettings>
@@ -201,6 +220,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     private:
         static const std::filesystem::path& _settingsPath();
         static const std::filesystem::path& _releaseSettingsPath();
+        static const std::filesystem::path& _fragmentCachePath();
         static winrt::hstring _calculateHash(std::string_view settings, const FILETIME& lastWriteTime);
 
         winrt::com_ptr<implementation::Profile> _createNewProfile(const std::wstring_view& name) const;
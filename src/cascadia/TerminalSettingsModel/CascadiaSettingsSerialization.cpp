@@ -8,8 +8,11 @@
 #include <shlobj.h>
 #include <til/latch.h>
 #include <til/io.h>
+#include <til/parallel.h>
 
 #include "resource.h"
+#include "../../buffer/out/BinarySnapshot.hpp"
+#include "../../types/inc/utils.hpp"
 
 #include "AzureCloudShellGenerator.h"
 #include "PowershellCoreProfileGenerator.h"
@@ -33,6 +36,7 @@ using namespace winrt::Microsoft::Terminal::Settings::Model::implementation;
 
 static constexpr std::wstring_view SettingsFilename{ L"settings.json" };
 static constexpr std::wstring_view DefaultsFilename{ L"defaults.json" };
+static constexpr std::wstring_view FragmentCacheFilename{ L"fragments.cache" };
 
 static constexpr std::string_view ProfilesKey{ "profiles" };
 static constexpr std::string_view DefaultSettingsKey{ "defaults" };
@@ -207,25 +211,61 @@ Json::StreamWriterBuilder SettingsLoader::_getJsonStyledWriter()
 // (meaning profiles specified by the application rather by the user).
 void SettingsLoader::GenerateProfiles()
 {
-    auto generateProfiles = [&](const IDynamicProfileGenerator& generator) {
-        if (!_ignoredNamespaces.contains(generator.GetNamespace()))
-        {
-            const auto oldProfileCount = inboxSettings.profiles.size();
-            _executeGenerator(generator, inboxSettings.profiles);
-            return oldProfileCount != inboxSettings.profiles.size();
-        }
-        return false;
-    };
+    const PowershellCoreProfileGenerator powershellCoreGenerator;
+    const WslDistroGenerator wslDistroGenerator;
+    const AzureCloudShellGenerator azureCloudShellGenerator;
+    const VisualStudioGenerator visualStudioGenerator;
+    const SshHostGenerator sshHostGenerator;
 
     // Generate profiles for each generator and add them to the inbox settings.
     // Be sure to update the same list below.
-    generateProfiles(PowershellCoreProfileGenerator{});
-    generateProfiles(WslDistroGenerator{});
-    generateProfiles(AzureCloudShellGenerator{});
-    generateProfiles(VisualStudioGenerator{});
+    std::vector<const IDynamicProfileGenerator*> generators{
+        &powershellCoreGenerator,
+        &wslDistroGenerator,
+        &azureCloudShellGenerator,
+        &visualStudioGenerator,
+    };
+    if constexpr (Feature_DynamicSSHProfiles::IsEnabled())
+    {
+        generators.emplace_back(&sshHostGenerator);
+    }
+
+    _generateProfiles(generators);
+
     if constexpr (Feature_DynamicSSHProfiles::IsEnabled())
     {
-        sshProfilesGenerated = generateProfiles(SshHostGenerator{});
+        const auto sshNamespace = sshHostGenerator.GetNamespace();
+        sshProfilesGenerated = std::any_of(inboxSettings.profiles.begin(), inboxSettings.profiles.end(), [&](const auto& profile) {
+            return profile->Origin() == OriginTag::Generated && profile->Source() == sshNamespace;
+        });
+    }
+}
+
+// Runs the given generators and adds their profiles to .inboxSettings.
+// The generators are independent of each other, but many of them hit the file system or the registry.
+// We run them concurrently, each into its own list, and then append the lists in the given order.
+// This makes the result identical to running them one after another.
+void SettingsLoader::_generateProfiles(std::span<const IDynamicProfileGenerator* const> generators)
+{
+    std::vector<std::vector<winrt::com_ptr<implementation::Profile>>> generatedProfiles(generators.size());
+    til::parallel_for(generators.size(), [&](const size_t i) noexcept {
+        if (_ignoredNamespaces.contains(generators[i]->GetNamespace()))
+        {
+            return;
+        }
+
+        // Some of the generators rely on COM, but thread pool threads aren't initialized for it.
+        const auto hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        _executeGenerator(*generators[i], generatedProfiles[i]);
+        if (SUCCEEDED(hr))
+        {
+            CoUninitialize();
+        }
+    });
+
+    for (auto& profiles : generatedProfiles)
+    {
+        inboxSettings.profiles.insert(inboxSettings.profiles.end(), std::make_move_iterator(profiles.begin()), std::make_move_iterator(profiles.end()));
     }
 }
 
@@ -326,30 +366,35 @@ void SettingsLoader::MergeInboxIntoUserSettings()
 // merge them. Unfortunately however the "updates" key in fragment profiles make this impossible:
 // The targeted profile might be one that got created as part of SettingsLoader::MergeInboxIntoUserSettings.
 // Additionally the GUID in "updates" will conflict with existing GUIDs in .inboxSettings.
+//
+// The fragment files are collected first, then read and parsed concurrently, and finally layered onto the user
+// settings one after another in the order they were found. The last step must remain sequential,
+// because a fragment may "update" a profile created by a preceding one.
 void SettingsLoader::FindFragmentsAndMergeIntoUserSettings(bool generateExtensionPackages)
 {
-    ParsedSettings fragmentSettings;
+    struct FragmentFile
+    {
+        std::filesystem::path path;
+        winrt::hstring source;
+        winrt::hstring sourceBasePath;
+        FragmentScope scope;
+        CachedFragment* cached;
+        std::optional<JsonSettings> json;
+    };
 
-    const auto parseAndLayerFragmentFiles = [&](const std::filesystem::path& path, const winrt::hstring& source, FragmentScope scope) {
+    std::vector<FragmentFile> fragmentFiles;
+    std::vector<winrt::Windows::ApplicationModel::Package> extensionPackages;
+
+    const auto findFragmentFiles = [&](const std::filesystem::path& path, const winrt::hstring& source, FragmentScope scope) {
         const winrt::hstring sourceBasePath{ path.native() };
         for (const auto& fragmentExt : std::filesystem::directory_iterator{ path })
         {
-            const auto fragExtPath = fragmentExt.path();
-            if (fragExtPath.extension() == jsonExtension)
+            if (fragmentExt.path().extension() == jsonExtension)
             {
                 try
                 {
-                    const auto content = til::io::read_file_as_utf8_string_if_exists(fragExtPath);
-                    if (!content.empty())
-                    {
-                        _parseFragment(source,
-                                       sourceBasePath,
-                                       content,
-                                       fragmentSettings,
-                                       generateExtensionPackages ?
-                                           static_cast<std::optional<ParseFragmentMetadata>>(ParseFragmentMetadata{ fragExtPath.filename().wstring(), scope }) :
-                                           std::nullopt);
-                    }
+                    auto& cached = _findCachedFragment(fragmentExt);
+                    fragmentFiles.push_back(FragmentFile{ fragmentExt.path(), source, sourceBasePath, scope, &cached });
                 }
                 CATCH_LOG();
             }
@@ -372,9 +417,9 @@ void SettingsLoader::FindFragmentsAndMergeIntoUserSettings(bool generateExtensio
 
                 if (fragmentExtFolder.is_directory())
                 {
-                    parseAndLayerFragmentFiles(fragmentExtFolder.path(),
-                                               winrt::hstring{ source },
-                                               rfid == FOLDERID_LocalAppData ? FragmentScope::User : FragmentScope::Machine); // scope
+                    findFragmentFiles(fragmentExtFolder.path(),
+                                      winrt::hstring{ source },
+                                      rfid == FOLDERID_LocalAppData ? FragmentScope::User : FragmentScope::Machine); // scope
                 }
             }
         }
@@ -399,53 +444,90 @@ void SettingsLoader::FindFragmentsAndMergeIntoUserSettings(bool generateExtensio
     }
     CATCH_LOG();
 
-    if (!extensions)
+    if (extensions)
     {
-        return;
-    }
+        for (const auto& ext : extensions)
+        {
+            const auto& package = ext.Package();
+            const auto packageName = package.Id().FamilyName();
 
-    for (const auto& ext : extensions)
-    {
-        const auto& package = ext.Package();
-        const auto packageName = package.Id().FamilyName();
+            // If the extension was explicitly disabled, skip over it early to avoid the async API!
+            // NOTE: only do this if we're NOT generating extension packages. If we are, we need to get all the
+            //       package metadata anyway to display in the settings UI later.
+            if (!generateExtensionPackages && _ignoredNamespaces.contains(std::wstring_view{ packageName }))
+            {
+                continue;
+            }
+
+            // Likewise, getting the public folder from an extension is an async operation.
+            auto foundFolder = extractValueFromTaskWithoutMainThreadAwait(ext.GetPublicFolderAsync());
+            if (!foundFolder)
+            {
+                continue;
+            }
+
+            // the StorageFolder class has its own methods for obtaining the files within the folder
+            // however, all those methods are Async methods
+            // you may have noticed that we need to resort to clunky implementations for async operations
+            // (they are in extractValueFromTaskWithoutMainThreadAwait)
+            // so for now we will just take the folder path and access the files that way
+            const auto path = buildPath(foundFolder.Path(), FragmentsSubDirectory);
+
+            if (std::filesystem::is_directory(path))
+            {
+                // MSIX does not support machine-wide scope
+                // See https://github.com/microsoft/winget-cli/discussions/1983
+                findFragmentFiles(path,
+                                  packageName,
+                                  FragmentScope::User);
+
+                if (generateExtensionPackages)
+                {
+                    extensionPackages.emplace_back(package);
+                }
+            }
+        }
+    }
 
-        // If the extension was explicitly disabled, skip over it early to avoid the async API!
-        // NOTE: only do this if we're NOT generating extension packages. If we are, we need to get all the
-        //       package metadata anyway to display in the settings UI later.
-        if (!generateExtensionPackages && _ignoredNamespaces.contains(std::wstring_view{ packageName }))
+    til::parallel_for(fragmentFiles.size(), [&](const size_t i) noexcept {
+        auto& file = fragmentFiles[i];
+        try
         {
-            continue;
+            _refreshCachedFragment(file.path, *file.cached);
+            if (!file.cached->content.empty())
+            {
+                file.json.emplace(_parseJson(file.cached->content));
+            }
         }
+        CATCH_LOG();
+    });
 
-        // Likewise, getting the public folder from an extension is an async operation.
-        auto foundFolder = extractValueFromTaskWithoutMainThreadAwait(ext.GetPublicFolderAsync());
-        if (!foundFolder)
+    ParsedSettings fragmentSettings;
+    for (auto& file : fragmentFiles)
+    {
+        if (!file.json)
         {
             continue;
         }
 
-        // the StorageFolder class has its own methods for obtaining the files within the folder
-        // however, all those methods are Async methods
-        // you may have noticed that we need to resort to clunky implementations for async operations
-        // (they are in extractValueFromTaskWithoutMainThreadAwait)
-        // so for now we will just take the folder path and access the files that way
-        const auto path = buildPath(foundFolder.Path(), FragmentsSubDirectory);
-
-        if (std::filesystem::is_directory(path))
+        try
         {
-            // MSIX does not support machine-wide scope
-            // See https://github.com/microsoft/winget-cli/discussions/1983
-            parseAndLayerFragmentFiles(path,
-                                       packageName,
-                                       FragmentScope::User);
-
-            if (generateExtensionPackages)
-            {
-                auto extPkg = extensionPackageMap[packageName];
-                extPkg->Icon(package.Logo().AbsoluteUri());
-                extPkg->DisplayName(package.DisplayName());
-            }
+            _parseFragment(file.source,
+                           file.sourceBasePath,
+                           std::move(*file.json),
+                           fragmentSettings,
+                           generateExtensionPackages ?
+                               static_cast<std::optional<ParseFragmentMetadata>>(ParseFragmentMetadata{ file.path.filename().wstring(), file.scope }) :
+                               std::nullopt);
         }
+        CATCH_LOG();
+    }
+
+    for (const auto& package : extensionPackages)
+    {
+        auto extPkg = extensionPackageMap[package.Id().FamilyName()];
+        extPkg->Icon(package.Logo().AbsoluteUri());
+        extPkg->DisplayName(package.DisplayName());
     }
 }
 
@@ -455,7 +537,144 @@ void SettingsLoader::FindFragmentsAndMergeIntoUserSettings(bool generateExtensio
 void SettingsLoader::MergeFragmentIntoUserSettings(const winrt::hstring& source, const winrt::hstring& basePath, const std::string_view& content)
 {
     ParsedSettings fragmentSettings;
-    _parseFragment(source, basePath, content, fragmentSettings, std::nullopt);
+    _parseFragment(source, basePath, _parseJson(content), fragmentSettings, std::nullopt);
+}
+
+// The fragment cache is a binary file next to settings.json, which holds the contents of all fragment files
+// found during the previous load. FindFragmentsAndMergeIntoUserSettings() still enumerates the fragment
+// directories, but only reads those files whose timestamp or size differ from the cached entry.
+// It consists of:
+// * FragmentCacheHeader
+// * entryCount-many entries, each consisting of:
+//   * int64_t lastWriteTime, uint64_t size
+//   * uint32_t length, wchar_t path[length]
+//   * uint32_t length, char content[length]
+struct FragmentCacheHeader
+{
+    static constexpr uint32_t Magic = 0x46535457; // "WTSF" in little-endian
+    // Increment this whenever the layout changes.
+    static constexpr uint32_t Version = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+};
+
+// Populates the fragment cache with the data written by SerializeFragmentCache().
+// Invalid or corrupted data is ignored, which simply results in all fragment files being read from disk.
+void SettingsLoader::LoadFragmentCache(const std::string_view& data)
+{
+    auto in = data;
+    std::unordered_map<std::wstring, CachedFragment> cache;
+
+    const auto readString = [&](auto& str) {
+        uint32_t length = 0;
+        if (!BinarySnapshot::Read(in, length) || length > in.size() / sizeof(str[0]))
+        {
+            return false;
+        }
+        str.resize(length);
+        return BinarySnapshot::Read(in, str.data(), length);
+    };
+
+    FragmentCacheHeader header;
+    if (!BinarySnapshot::Read(in, header) ||
+        header.magic != FragmentCacheHeader::Magic ||
+        header.version != FragmentCacheHeader::Version)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        CachedFragment fragment;
+        std::wstring path;
+        if (!BinarySnapshot::Read(in, fragment.lastWriteTime) ||
+            !BinarySnapshot::Read(in, fragment.size) ||
+            !readString(path) ||
+            !readString(fragment.content))
+        {
+            return;
+        }
+        cache.insert_or_assign(std::move(path), std::move(fragment));
+    }
+
+    _fragmentCache = std::move(cache);
+}
+
+// Returns true if the fragments found during this load differ from those passed to LoadFragmentCache(),
+// in which case the cache should be written back to disk.
+bool SettingsLoader::FragmentCacheChanged() const noexcept
+{
+    return _fragmentCacheChanged || std::any_of(_fragmentCache.begin(), _fragmentCache.end(), [](const auto& pair) { return !pair.second.used; });
+}
+
+// Serializes all fragment files that were found during this load. See LoadFragmentCache().
+std::string SettingsLoader::SerializeFragmentCache() const
+{
+    std::string buffer;
+    const auto entryCount = std::count_if(_fragmentCache.begin(), _fragmentCache.end(), [](const auto& pair) { return pair.second.used; });
+
+    BinarySnapshot::Append(buffer, FragmentCacheHeader{
+                                       .magic = FragmentCacheHeader::Magic,
+                                       .version = FragmentCacheHeader::Version,
+                                       .entryCount = gsl::narrow<uint32_t>(entryCount),
+                                   });
+
+    for (const auto& [path, fragment] : _fragmentCache)
+    {
+        if (!fragment.used)
+        {
+            continue;
+        }
+
+        BinarySnapshot::Append(buffer, fragment.lastWriteTime);
+        BinarySnapshot::Append(buffer, fragment.size);
+        BinarySnapshot::Append(buffer, gsl::narrow<uint32_t>(path.size()));
+        BinarySnapshot::Append(buffer, path.data(), path.size());
+        BinarySnapshot::Append(buffer, gsl::narrow<uint32_t>(fragment.content.size()));
+        BinarySnapshot::Append(buffer, fragment.content.data(), fragment.content.size());
+    }
+
+    return buffer;
+}
+
+// Returns the fragment cache entry for the given fragment file. If the file changed since the cache was
+// written, the entry is marked as stale and _refreshCachedFragment() will read the file from disk.
+// The timestamp and size come from the directory enumeration and don't require opening the file.
+SettingsLoader::CachedFragment& SettingsLoader::_findCachedFragment(const std::filesystem::directory_entry& entry)
+{
+    const auto lastWriteTime = entry.last_write_time().time_since_epoch().count();
+    const auto size = static_cast<uint64_t>(entry.file_size());
+    auto& fragment = _fragmentCache[entry.path().native()];
+
+    if (!fragment.used && (fragment.lastWriteTime != lastWriteTime || fragment.size != size))
+    {
+        fragment.content.clear();
+        fragment.lastWriteTime = lastWriteTime;
+        fragment.size = size;
+        fragment.stale = true;
+        _fragmentCacheChanged = true;
+    }
+
+    fragment.used = true;
+    return fragment;
+}
+
+// Reads a fragment file marked as stale by _findCachedFragment(). Unlike the former,
+// this function only touches the given entry and may be called concurrently for different entries.
+void SettingsLoader::_refreshCachedFragment(const std::filesystem::path& path, CachedFragment& fragment)
+{
+    if (!fragment.stale)
+    {
+        return;
+    }
+
+    // If reading fails, the entry is left with a timestamp that never matches, so that the next load retries.
+    const auto lastWriteTime = std::exchange(fragment.lastWriteTime, 0);
+    fragment.content = til::io::read_file_as_utf8_string_if_exists(path);
+    fragment.lastWriteTime = lastWriteTime;
+    fragment.stale = false;
 }
 
 // Call this method before passing SettingsLoader to the CascadiaSettings constructor.
@@ -758,9 +977,12 @@ void SettingsLoader::_rethrowSerializationExceptionWithLocationInfo(const JsonUt
 // Simply parses the given content to a Json::Value.
 Json::Value SettingsLoader::_parseJSON(const std::string_view& content)
 {
+    // The builder holds its configuration in a Json::Value, which is surprisingly costly to set up.
+    // newCharReader() is const and may be called concurrently (see FindFragmentsAndMergeIntoUserSettings).
+    static const Json::CharReaderBuilder builder;
     Json::Value json;
     std::string errs;
-    const std::unique_ptr<Json::CharReader> reader{ Json::CharReaderBuilder{}.newCharReader() };
+    const std::unique_ptr<Json::CharReader> reader{ builder.newCharReader() };
 
     if (!reader->parse(content.data(), content.data() + content.size(), &json, &errs))
     {
@@ -878,10 +1100,8 @@ void SettingsLoader::_parse(const OriginTag origin, const winrt::hstring& source
 // schemes and profiles. Additionally this function supports profiles which specify an "updates" key.
 // - fragmentMeta: If set, construct and register FragmentSettings objects. Provides metadata necessary for doing so.
 //                 Otherwise, completely skip over that extra work and apply parsed settings to the user settings, if allowed by disabledProfileSources ("_ignoredNamespaces").
-void SettingsLoader::_parseFragment(const winrt::hstring& source, const winrt::hstring& sourceBasePath, const std::string_view& content, ParsedSettings& settings, const std::optional<ParseFragmentMetadata>& fragmentMeta)
+void SettingsLoader::_parseFragment(const winrt::hstring& source, const winrt::hstring& sourceBasePath, JsonSettings&& json, ParsedSettings& settings, const std::optional<ParseFragmentMetadata>& fragmentMeta)
 {
-    auto json = _parseJson(content);
-
     const bool buildFragmentSettings = fragmentMeta.has_value();
     const bool applyToUserSettings = !buildFragmentSettings && !_ignoredNamespaces.contains(std::wstring_view{ source });
     winrt::com_ptr<implementation::FragmentSettings> fragmentSettings = buildFragmentSettings ?
@@ -1142,17 +1362,28 @@ bool SettingsLoader::_addOrMergeUserColorScheme(const winrt::com_ptr<implementat
 }
 
 // As the name implies it executes a generator.
-// Generated profiles are added to .inboxSettings. Used by GenerateProfiles().
+// Generated profiles are added to .inboxSettings. Used by _generateProfiles().
 void SettingsLoader::_executeGenerator(const IDynamicProfileGenerator& generator, std::vector<winrt::com_ptr<implementation::Profile>>& profilesList)
 {
     const auto generatorNamespace = generator.GetNamespace();
     const auto previousSize = profilesList.size();
+    const auto start = std::chrono::steady_clock::now();
     try
     {
         generator.GenerateProfiles(profilesList);
     }
     CATCH_LOG_MSG("Dynamic Profile Namespace: \"%.*s\"", gsl::narrow<int>(generatorNamespace.size()), generatorNamespace.data())
 
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    TraceLoggingWrite(g_hSettingsModelProvider,
+                      "DynamicProfileGeneratorExecuted",
+                      TraceLoggingDescription("Event emitted after a dynamic profile generator ran"),
+                      TraceLoggingCountedWideString(generatorNamespace.data(), gsl::narrow_cast<ULONG>(generatorNamespace.size()), "Namespace", "The namespace of the generator"),
+                      TraceLoggingUInt64(gsl::narrow_cast<uint64_t>(duration.count()), "DurationUs", "The time the generator took in microseconds"),
+                      TraceLoggingUInt64(profilesList.size() - previousSize, "ProfileCount", "The number of profiles the generator created"),
+                      TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+
     // If the generator produced some profiles we're going to give them default attributes.
     // By setting the Origin/Source/etc. here, we deduplicate some code and ensure they aren't missing accidentally.
     if (profilesList.size() > previousSize)
@@ -1264,12 +1495,33 @@ try
         loader.ApplyRuntimeInitialSettings();
     }
 
+    // The fragment cache lives in the user's settings directory, which is writable by unelevated processes.
+    // An elevated instance shouldn't trust it and reads all fragment files instead.
+    const auto useFragmentCache = !::Microsoft::Console::Utils::IsRunningElevated();
+    if (useFragmentCache)
+    {
+        try
+        {
+            loader.LoadFragmentCache(til::io::read_file_as_utf8_string_if_exists(_fragmentCachePath()));
+        }
+        CATCH_LOG();
+    }
+
     loader.MergeInboxIntoUserSettings();
     // Fragments might reference user profiles created by a generator.
     // --> FindFragmentsAndMergeIntoUserSettings must be called after MergeInboxIntoUserSettings.
     loader.FindFragmentsAndMergeIntoUserSettings(false /*generateExtensionPackages*/);
     loader.FinalizeLayering();
 
+    if (useFragmentCache && loader.FragmentCacheChanged())
+    {
+        try
+        {
+            til::io::write_utf8_string_to_file_atomic(_fragmentCachePath(), loader.SerializeFragmentCache());
+        }
+        CATCH_LOG();
+    }
+
     // DisableDeletedProfiles returns true whenever we encountered any new generated/dynamic profiles.
     // Similarly FixupUserSettings returns true, when it encountered settings that were patched up.
     mustWriteToDisk |= loader.DisableDeletedProfiles();
@@ -1509,6 +1761,13 @@ const std::filesystem::path& CascadiaSettings::_releaseSettingsPath()
     return path;
 }
 
+// Returns the path of the fragment cache. See SettingsLoader::LoadFragmentCache().
+const std::filesystem::path& CascadiaSettings::_fragmentCachePath()
+{
+    static const auto path = GetBaseSettingsPath() / FragmentCacheFilename;
+    return path;
+}
+
 // Returns a has (approximately) uniquely identifying the settings.json contents on disk.
 winrt::hstring CascadiaSettings::_calculateHash(std::string_view settings, const FILETIME& lastWriteTime)
 {
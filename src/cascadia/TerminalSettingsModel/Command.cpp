@@ -289,12 +289,13 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         // For iterable commands, we'll make another pass at parsing them once
         // the json is patched. So ignore parsing sub-commands for now. Commands
         // will only be marked iterable on the first pass.
-        if (const auto nestedCommandsJson{ json[JsonKey(CommandsKey)] })
+        const auto nestedCommandsJson = JsonUtils::FindMember(json, CommandsKey);
+        if (nestedCommandsJson && !nestedCommandsJson->isNull())
         {
             // Initialize our list of subcommands.
             result->_subcommands = winrt::single_threaded_map<winrt::hstring, Model::Command>();
             result->_nestedCommand = true;
-            auto nestedWarnings = Command::LayerJson(result->_subcommands, nestedCommandsJson, origin);
+            auto nestedWarnings = Command::LayerJson(result->_subcommands, *nestedCommandsJson, origin);
             // It's possible that the nested commands have some warnings
             warnings.insert(warnings.end(), nestedWarnings.begin(), nestedWarnings.end());
 
@@ -306,7 +307,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
             nested = true;
         }
-        else if (json.isMember(JsonKey(CommandsKey)))
+        else if (nestedCommandsJson)
         {
             // { "name": "foo", "commands": null } will land in this case, which
             // should also be used for unbinding.
@@ -321,9 +322,9 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         // If we're a nested command, we can ignore the current action.
         if (!nested)
         {
-            if (const auto actionJson{ json[JsonKey(ActionKey)] })
+            if (const auto actionJson = JsonUtils::FindMember(json, ActionKey); actionJson && !actionJson->isNull())
             {
-                result->_ActionAndArgs = *ActionAndArgs::FromJson(actionJson, warnings);
+                result->_ActionAndArgs = *ActionAndArgs::FromJson(*actionJson, warnings);
             }
             else
             {
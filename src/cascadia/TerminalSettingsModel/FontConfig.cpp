@@ -79,12 +79,11 @@ void FontConfig::LayerJson(const Json::Value& json)
 {
     // Legacy users may not have a font object defined in their profile,
     // so check for that before we decide how to parse this
-    if (json.isMember(JsonKey(FontInfoKey)))
+    if (const auto fontInfoJson = JsonUtils::FindMember(json, FontInfoKey))
     {
         // A font object is defined, use that
-        const auto fontInfoJson = json[JsonKey(FontInfoKey)];
-#define FONT_SETTINGS_LAYER_JSON(type, name, jsonKey, ...)     \
-    JsonUtils::GetValueForKey(fontInfoJson, jsonKey, _##name); \
+#define FONT_SETTINGS_LAYER_JSON(type, name, jsonKey, ...)      \
+    JsonUtils::GetValueForKey(*fontInfoJson, jsonKey, _##name); \
     _logSettingIfSet(jsonKey, _##name.has_value());
 
         MTSM_FONT_SETTINGS(FONT_SETTINGS_LAYER_JSON)
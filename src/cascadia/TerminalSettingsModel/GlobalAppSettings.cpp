@@ -207,9 +207,9 @@ void GlobalAppSettings::LayerJson(const Json::Value& json, const OriginTag origi
 
     // GLOBAL_SETTINGS_LAYER_JSON above should have already loaded this value properly.
     // We just need to detect if the legacy value was used and mark it for fixup, if so.
-    if (const auto firstWindowPreferenceValue = json[FirstWindowPreferenceKey.data()])
+    if (const auto firstWindowPreferenceValue = JsonUtils::FindMember(json, FirstWindowPreferenceKey))
     {
-        _fixupsAppliedDuringLoad |= firstWindowPreferenceValue == LegacyPersistedWindowLayout.data();
+        _fixupsAppliedDuringLoad |= *firstWindowPreferenceValue == LegacyPersistedWindowLayout.data();
     }
 
     // Remove settings included in userDefaults
@@ -235,9 +235,9 @@ void GlobalAppSettings::LayerActionsFrom(const Json::Value& json, const OriginTa
     static constexpr std::array bindingsKeys{ ActionsKey, KeybindingsKey };
     for (const auto& jsonKey : bindingsKeys)
     {
-        if (auto bindings{ json[JsonKey(jsonKey)] })
+        if (const auto bindings = JsonUtils::FindMember(json, jsonKey); bindings && !bindings->isNull())
         {
-            auto warnings = _actionMap->LayerJson(bindings, origin, withKeybindings);
+            auto warnings = _actionMap->LayerJson(*bindings, origin, withKeybindings);
 
             // It's possible that the user provided keybindings have some warnings
             // in them - problems that we should alert the user to, but we can
@@ -161,6 +161,20 @@ namespace Microsoft::Terminal::Settings::Model::JsonUtils
         return local; // returns zero-initialized or value
     }
 
+    // Method Description:
+    // - Looks up a member of a json object by reference. Unlike Json::Value::operator[]
+    //   together with JsonKey(), this neither allocates a std::string for the key,
+    //   nor tempts the caller into copying the (potentially large) member with `auto`.
+    // Arguments:
+    // - json: the json object to search
+    // - key: the name of the member
+    // Return Value:
+    // - a pointer to the member, or nullptr if json isn't an object or has no such member
+    inline const Json::Value* FindMember(const Json::Value& json, std::string_view key)
+    {
+        return json.isObject() ? json.find(key.data(), key.data() + key.size()) : nullptr;
+    }
+
     // GetValueForKey, type-deduced, manual converter
     template<typename T, typename Converter>
     bool GetValueForKey(const Json::Value& json, std::string_view key, T& target, Converter&& conv)
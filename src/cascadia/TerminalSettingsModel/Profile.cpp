@@ -208,7 +208,7 @@ void Profile::LayerJson(const Json::Value& json)
     MTSM_PROFILE_SETTINGS(PROFILE_SETTINGS_LAYER_JSON)
 #undef PROFILE_SETTINGS_LAYER_JSON
 
-    if (json.isMember(JsonKey(UnfocusedAppearanceKey)))
+    if (const auto unfocusedAppearanceJson = JsonUtils::FindMember(json, UnfocusedAppearanceKey))
     {
         auto unfocusedAppearance{ winrt::make_self<implementation::AppearanceConfig>(weak_ref<Model::Profile>(*this)) };
 
@@ -218,7 +218,7 @@ void Profile::LayerJson(const Json::Value& json)
         parentCom.copy_from(defaultAppearanceImpl);
         unfocusedAppearance->AddLeastImportantParent(parentCom);
 
-        unfocusedAppearance->LayerJson(json[JsonKey(UnfocusedAppearanceKey)]);
+        unfocusedAppearance->LayerJson(*unfocusedAppearanceJson);
         _UnfocusedAppearance = *unfocusedAppearance;
 
         _logSettingSet(UnfocusedAppearanceKey);
@@ -48,6 +48,11 @@ namespace ControlUnitTests
 
         TEST_METHOD(TestSimpleClickSelection);
 
+        TEST_METHOD(TestLargePasteIsStreamed);
+        TEST_METHOD(TestInputIsQueuedBehindPaste);
+        TEST_METHOD(TestCancelPaste);
+        TEST_METHOD(TestInterruptKeyCancelsPaste);
+
         TEST_CLASS_SETUP(ModuleSetup)
         {
             winrt::init_apartment(winrt::apartment_type::single_threaded);
@@ -810,4 +815,98 @@ namespace ControlUnitTests
         }
         VERIFY_IS_TRUE(gotSelectionUpdate);
     }
+    void ControlCoreTests::TestLargePasteIsStreamed()
+    {
+        auto settings = winrt::make_self<MockControlSettings>();
+        auto conn = winrt::make_self<RecordingConnection>();
+        auto core = createCore(*settings, *conn);
+        VERIFY_IS_NOT_NULL(core);
+        _standardInit(core);
+
+        Log::Comment(L"Enable bracketed paste");
+        conn->TerminalOutput.raise(winrt_wstring_to_array_view(L"\x1b[?2004h"));
+        VERIFY_IS_TRUE(core->BracketedPasteEnabled());
+
+        Log::Comment(L"A large paste is written in several chunks, but only bracketed once");
+        const std::wstring text(300 * 1024, L'a');
+        core->PasteText(winrt::hstring{ text });
+
+        const auto expected = L"\x1b[200~" + text + L"\x1b[201~";
+        VERIFY_ARE_EQUAL(expected, conn->WaitForInput(expected.size()));
+        VERIFY_IS_GREATER_THAN(conn->WriteCount(), 1u);
+    }
+
+    void ControlCoreTests::TestInputIsQueuedBehindPaste()
+    {
+        auto settings = winrt::make_self<MockControlSettings>();
+        auto conn = winrt::make_self<RecordingConnection>();
+        auto core = createCore(*settings, *conn);
+        VERIFY_IS_NOT_NULL(core);
+        _standardInit(core);
+
+        Log::Comment(L"Hold up the writes of a large paste");
+        conn->writesAllowed.ResetEvent();
+        const std::wstring text(100 * 1024, L'a');
+        core->PasteText(winrt::hstring{ text });
+        VERIFY_IS_TRUE(conn->writeStarted.wait(5000));
+
+        Log::Comment(L"Typing during the paste must neither block, nor end up inside the paste");
+        core->SendInput(L"x");
+        conn->writesAllowed.SetEvent();
+
+        const auto expected = text + L"x";
+        VERIFY_ARE_EQUAL(expected, conn->WaitForInput(expected.size()));
+    }
+
+    void ControlCoreTests::TestCancelPaste()
+    {
+        auto settings = winrt::make_self<MockControlSettings>();
+        auto conn = winrt::make_self<RecordingConnection>();
+        auto core = createCore(*settings, *conn);
+        VERIFY_IS_NOT_NULL(core);
+        _standardInit(core);
+
+        conn->TerminalOutput.raise(winrt_wstring_to_array_view(L"\x1b[?2004h"));
+        VERIFY_IS_TRUE(core->BracketedPasteEnabled());
+
+        Log::Comment(L"Cancel a large paste while its first chunk is being written");
+        conn->writesAllowed.ResetEvent();
+        const std::wstring text(300 * 1024, L'a');
+        core->PasteText(winrt::hstring{ text });
+        VERIFY_IS_TRUE(conn->writeStarted.wait(5000));
+
+        core->SendInput(L"x");
+        core->CancelPaste();
+        conn->writesAllowed.SetEvent();
+
+        Log::Comment(L"The paste stops after the first chunk, is still terminated, and regular input isn't lost");
+        const auto expected = L"\x1b[200~" + text.substr(0, 64 * 1024) + L"\x1b[201~x";
+        VERIFY_ARE_EQUAL(expected, conn->WaitForInput(expected.size()));
+    }
+
+    void ControlCoreTests::TestInterruptKeyCancelsPaste()
+    {
+        auto settings = winrt::make_self<MockControlSettings>();
+        auto conn = winrt::make_self<RecordingConnection>();
+        auto core = createCore(*settings, *conn);
+        VERIFY_IS_NOT_NULL(core);
+        _standardInit(core);
+
+        conn->TerminalOutput.raise(winrt_wstring_to_array_view(L"\x1b[?2004h"));
+        VERIFY_IS_TRUE(core->BracketedPasteEnabled());
+
+        Log::Comment(L"Press Escape while the first chunk of a large paste is being written");
+        conn->writesAllowed.ResetEvent();
+        const std::wstring text(300 * 1024, L'a');
+        core->PasteText(winrt::hstring{ text });
+        VERIFY_IS_TRUE(conn->writeStarted.wait(5000));
+
+        core->SendInput(L"x");
+        VERIFY_IS_TRUE(core->TrySendKeyEvent(VK_ESCAPE, 0, {}, true));
+        conn->writesAllowed.SetEvent();
+
+        Log::Comment(L"The paste stops after the first chunk and the Escape is sent right after it, ahead of the queued input");
+        const auto expected = L"\x1b[200~" + text.substr(0, 64 * 1024) + L"\x1b[201~\x1bx";
+        VERIFY_ARE_EQUAL(expected, conn->WaitForInput(expected.size()));
+    }
 }
@@ -29,4 +29,65 @@ namespace ControlUnitTests
         til::event<winrt::Microsoft::Terminal::TerminalConnection::TerminalOutputHandler> TerminalOutput;
         til::typed_event<winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection, IInspectable> StateChanged;
     };
+
+    // Unlike MockConnection, this one records the input written to it instead of echoing
+    // it back. Writes can be held up with writesAllowed, just like a slow reader would.
+    class RecordingConnection : public winrt::implements<RecordingConnection, winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection>
+    {
+    public:
+        RecordingConnection() noexcept = default;
+
+        void Initialize(const winrt::Windows::Foundation::Collections::ValueSet& /*settings*/) {};
+        void Start() noexcept {};
+        void WriteInput(const winrt::array_view<const char16_t> data)
+        {
+            writeStarted.SetEvent();
+            writesAllowed.wait();
+
+            const std::lock_guard guard{ _lock };
+            _input.append(winrt_array_to_wstring_view(data));
+            _writes++;
+        }
+        void Resize(uint32_t /*rows*/, uint32_t /*columns*/) noexcept {}
+        void Close() noexcept {}
+
+        winrt::guid SessionId() const noexcept { return {}; }
+        winrt::Microsoft::Terminal::TerminalConnection::ConnectionState State() const noexcept { return winrt::Microsoft::Terminal::TerminalConnection::ConnectionState::Connected; }
+
+        // Waits up to 5s for at least `length` characters to be written and returns them.
+        std::wstring WaitForInput(size_t length)
+        {
+            for (auto i = 0; i < 500; ++i)
+            {
+                {
+                    const std::lock_guard guard{ _lock };
+                    if (_input.size() >= length)
+                    {
+                        break;
+                    }
+                }
+                Sleep(10);
+            }
+
+            const std::lock_guard guard{ _lock };
+            return _input;
+        }
+
+        size_t WriteCount()
+        {
+            const std::lock_guard guard{ _lock };
+            return _writes;
+        }
+
+        wil::unique_event writeStarted{ wil::EventOptions::None };
+        wil::unique_event writesAllowed{ wil::EventOptions::ManualReset | wil::EventOptions::Signaled };
+
+        til::event<winrt::Microsoft::Terminal::TerminalConnection::TerminalOutputHandler> TerminalOutput;
+        til::typed_event<winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection, IInspectable> StateChanged;
+
+    private:
+        std::mutex _lock;
+        std::wstring _input;
+        size_t _writes = 0;
+    };
 }
@@ -5,7 +5,9 @@
 
 #include "../TerminalSettingsModel/ColorScheme.h"
 #include "../TerminalSettingsModel/CascadiaSettings.h"
+#include "../TerminalSettingsModel/IDynamicProfileGenerator.h"
 #include "../TerminalSettingsModel/resource.h"
+#include <til/io.h>
 #include "JsonTestClass.h"
 #include "TestUtils.h"
 
@@ -19,6 +21,38 @@ using VirtualKeyModifiers = winrt::Windows::System::VirtualKeyModifiers;
 
 namespace SettingsModelUnitTests
 {
+    // Generates `count` profiles named "<namespace> <index>" after sleeping for `delay`.
+    class FakeProfileGenerator final : public IDynamicProfileGenerator
+    {
+    public:
+        FakeProfileGenerator(std::wstring_view ns, size_t count, std::chrono::milliseconds delay) noexcept :
+            _namespace{ ns },
+            _count{ count },
+            _delay{ delay }
+        {
+        }
+
+        std::wstring_view GetNamespace() const noexcept override { return _namespace; }
+        std::wstring_view GetDisplayName() const noexcept override { return _namespace; }
+        std::wstring_view GetIcon() const noexcept override { return {}; }
+
+        void GenerateProfiles(std::vector<winrt::com_ptr<implementation::Profile>>& profiles) const override
+        {
+            std::this_thread::sleep_for(_delay);
+            for (size_t i = 0; i < _count; ++i)
+            {
+                auto profile = winrt::make_self<implementation::Profile>();
+                profile->Name(winrt::hstring{ std::wstring{ _namespace } + L' ' + std::to_wstring(i) });
+                profiles.emplace_back(std::move(profile));
+            }
+        }
+
+    private:
+        std::wstring_view _namespace;
+        size_t _count;
+        std::chrono::milliseconds _delay;
+    };
+
     class DeserializationTests : public JsonTestClass
     {
         TEST_CLASS(DeserializationTests);
@@ -68,6 +102,10 @@ namespace SettingsModelUnitTests
 
         TEST_METHOD(MigrateReloadEnvVars);
 
+        TEST_METHOD(GenerateProfilesInGeneratorOrder);
+        TEST_METHOD(FragmentCacheRoundtrip);
+        TEST_METHOD(FragmentCacheInvalidation);
+
     private:
         static winrt::com_ptr<implementation::CascadiaSettings> createSettings(const std::string_view& userJSON)
         {
@@ -124,6 +162,14 @@ namespace SettingsModelUnitTests
                 }
             }
         }
+
+        // Looks up the given fragment file in the loader's cache like FindFragmentsAndMergeIntoUserSettings() does.
+        static std::string_view _findFragment(implementation::SettingsLoader& loader, const std::filesystem::path& path)
+        {
+            auto& fragment = loader._findCachedFragment(std::filesystem::directory_entry{ path });
+            implementation::SettingsLoader::_refreshCachedFragment(path, fragment);
+            return fragment.content;
+        }
     };
 
     void DeserializationTests::ValidateProfilesExist()
@@ -2337,4 +2383,158 @@ namespace SettingsModelUnitTests
         VERIFY_IS_TRUE(settings->ProfileDefaults().HasReloadEnvironmentVariables());
         VERIFY_IS_FALSE(settings->ProfileDefaults().ReloadEnvironmentVariables());
     }
+
+    void DeserializationTests::GenerateProfilesInGeneratorOrder()
+    {
+        static constexpr std::string_view userJson{ R"({
+            "disabledProfileSources": [ "Test.Disabled" ]
+        })" };
+
+        // The generators run concurrently and the first one finishes last. The resulting
+        // profiles must nonetheless be in the same order as if they had run one after another.
+        const FakeProfileGenerator slow{ L"Test.Slow", 2, std::chrono::milliseconds{ 100 } };
+        const FakeProfileGenerator disabled{ L"Test.Disabled", 1, {} };
+        const FakeProfileGenerator fast{ L"Test.Fast", 1, {} };
+        const FakeProfileGenerator empty{ L"Test.Empty", 0, {} };
+        const FakeProfileGenerator medium{ L"Test.Medium", 2, std::chrono::milliseconds{ 50 } };
+        const std::array<const IDynamicProfileGenerator*, 5> generators{ &slow, &disabled, &fast, &empty, &medium };
+
+        implementation::SettingsLoader loader{ userJson, implementation::LoadStringResource(IDR_DEFAULTS) };
+        const auto previousCount = loader.inboxSettings.profiles.size();
+        loader._generateProfiles(generators);
+
+        static constexpr std::array<std::pair<std::wstring_view, std::wstring_view>, 5> expected{ {
+            { L"Test.Slow", L"Test.Slow 0" },
+            { L"Test.Slow", L"Test.Slow 1" },
+            { L"Test.Fast", L"Test.Fast 0" },
+            { L"Test.Medium", L"Test.Medium 0" },
+            { L"Test.Medium", L"Test.Medium 1" },
+        } };
+
+        const auto& profiles = loader.inboxSettings.profiles;
+        VERIFY_ARE_EQUAL(previousCount + expected.size(), profiles.size());
+
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            const auto& profile = profiles[previousCount + i];
+            VERIFY_ARE_EQUAL(OriginTag::Generated, profile->Origin());
+            VERIFY_ARE_EQUAL(winrt::hstring{ expected[i].first }, profile->Source());
+            VERIFY_ARE_EQUAL(winrt::hstring{ expected[i].second }, profile->Name());
+        }
+    }
+
+    void DeserializationTests::FragmentCacheRoundtrip()
+    {
+        static constexpr std::string_view fragment1{ R"({ "profiles": [ { "name": "fragment 1" } ] })" };
+        static constexpr std::string_view fragment2{ R"({ "profiles": [ { "name": "fragment 2" } ] })" };
+
+        const auto dir = std::filesystem::canonical(std::filesystem::temp_directory_path()) / L"FragmentCacheRoundtrip";
+        const auto path1 = dir / L"fragment1.json";
+        const auto path2 = dir / L"fragment2.json";
+
+        const auto cleanup = wil::scope_exit([&]() {
+            std::error_code ec;
+            remove_all(dir, ec);
+        });
+
+        create_directories(dir);
+        til::io::write_utf8_string_to_file(path1, fragment1);
+        til::io::write_utf8_string_to_file(path2, fragment2);
+
+        std::string cache;
+        {
+            Log::Comment(L"Without a cache, all fragments are read from disk.");
+            implementation::SettingsLoader loader{ std::string_view{}, implementation::LoadStringResource(IDR_DEFAULTS) };
+            VERIFY_ARE_EQUAL(fragment1, _findFragment(loader, path1));
+            VERIFY_ARE_EQUAL(fragment2, _findFragment(loader, path2));
+            VERIFY_IS_TRUE(loader.FragmentCacheChanged());
+            cache = loader.SerializeFragmentCache();
+        }
+
+        // Change the contents of the file, but not its size or timestamp. If the cache is
+        // used, as it should, we get the old contents and not the new ones from disk.
+        const auto lastWriteTime = std::filesystem::last_write_time(path1);
+        til::io::write_utf8_string_to_file(path1, R"({ "profiles": [ { "name": "fragment X" } ] })");
+        std::filesystem::last_write_time(path1, lastWriteTime);
+
+        {
+            Log::Comment(L"With an up-to-date cache, no fragments are read from disk.");
+            implementation::SettingsLoader loader{ std::string_view{}, implementation::LoadStringResource(IDR_DEFAULTS) };
+            loader.LoadFragmentCache(cache);
+            VERIFY_ARE_EQUAL(fragment1, _findFragment(loader, path1));
+            VERIFY_ARE_EQUAL(fragment2, _findFragment(loader, path2));
+            VERIFY_IS_FALSE(loader.FragmentCacheChanged());
+            VERIFY_ARE_EQUAL(cache.size(), loader.SerializeFragmentCache().size());
+        }
+    }
+
+    void DeserializationTests::FragmentCacheInvalidation()
+    {
+        static constexpr std::string_view fragment1{ R"({ "profiles": [ { "name": "fragment 1" } ] })" };
+        static constexpr std::string_view fragment2{ R"({ "profiles": [ { "name": "fragment 2" } ] })" };
+        static constexpr std::string_view fragment2Modified{ R"({ "profiles": [ { "name": "fragment 2 modified" } ] })" };
+
+        const auto dir = std::filesystem::canonical(std::filesystem::temp_directory_path()) / L"FragmentCacheInvalidation";
+        const auto path1 = dir / L"fragment1.json";
+        const auto path2 = dir / L"fragment2.json";
+
+        const auto cleanup = wil::scope_exit([&]() {
+            std::error_code ec;
+            remove_all(dir, ec);
+        });
+
+        create_directories(dir);
+        til::io::write_utf8_string_to_file(path1, fragment1);
+        til::io::write_utf8_string_to_file(path2, fragment2);
+
+        std::string cache;
+        {
+            implementation::SettingsLoader loader{ std::string_view{}, implementation::LoadStringResource(IDR_DEFAULTS) };
+            _findFragment(loader, path1);
+            _findFragment(loader, path2);
+            cache = loader.SerializeFragmentCache();
+        }
+
+        {
+            Log::Comment(L"Corrupted caches are ignored and all fragments are read from disk.");
+            for (const auto& data : { std::string{ "garbage" }, cache.substr(0, cache.size() - 1) })
+            {
+                implementation::SettingsLoader loader{ std::string_view{}, implementation::LoadStringResource(IDR_DEFAULTS) };
+                loader.LoadFragmentCache(data);
+                VERIFY_ARE_EQUAL(fragment1, _findFragment(loader, path1));
+                VERIFY_ARE_EQUAL(fragment2, _findFragment(loader, path2));
+                VERIFY_IS_TRUE(loader.FragmentCacheChanged());
+            }
+        }
+
+        {
+            Log::Comment(L"Removed fragments are dropped from the cache.");
+            implementation::SettingsLoader loader{ std::string_view{}, implementation::LoadStringResource(IDR_DEFAULTS) };
+            loader.LoadFragmentCache(cache);
+            VERIFY_ARE_EQUAL(fragment1, _findFragment(loader, path1));
+            VERIFY_IS_TRUE(loader.FragmentCacheChanged());
+
+            implementation::SettingsLoader next{ std::string_view{}, implementation::LoadStringResource(IDR_DEFAULTS) };
+            next.LoadFragmentCache(loader.SerializeFragmentCache());
+            VERIFY_ARE_EQUAL(fragment1, _findFragment(next, path1));
+            VERIFY_IS_FALSE(next.FragmentCacheChanged());
+        }
+
+        til::io::write_utf8_string_to_file(path2, fragment2Modified);
+
+        {
+            Log::Comment(L"Modified fragments are read from disk again.");
+            implementation::SettingsLoader loader{ std::string_view{}, implementation::LoadStringResource(IDR_DEFAULTS) };
+            loader.LoadFragmentCache(cache);
+            VERIFY_ARE_EQUAL(fragment1, _findFragment(loader, path1));
+            VERIFY_ARE_EQUAL(fragment2Modified, _findFragment(loader, path2));
+            VERIFY_IS_TRUE(loader.FragmentCacheChanged());
+
+            implementation::SettingsLoader next{ std::string_view{}, implementation::LoadStringResource(IDR_DEFAULTS) };
+            next.LoadFragmentCache(loader.SerializeFragmentCache());
+            VERIFY_ARE_EQUAL(fragment1, _findFragment(next, path1));
+            VERIFY_ARE_EQUAL(fragment2Modified, _findFragment(next, path2));
+            VERIFY_IS_FALSE(next.FragmentCacheChanged());
+        }
+    }
 }
@@ -40,6 +40,7 @@ namespace SettingsModelUnitTests
         TEST_METHOD(TestMoveTabArgs);
         TEST_METHOD(TestGetKeyBindingForAction);
         TEST_METHOD(KeybindingsWithoutVkey);
+        TEST_METHOD(KeyDispatchTable);
     };
 
     void KeyBindingsTests::KeyChords()
@@ -808,4 +809,74 @@ namespace SettingsModelUnitTests
         const auto action = actionMap->GetActionByKeyChord({ VirtualKeyModifiers::Shift, 0, 255 });
         VERIFY_IS_NOT_NULL(action);
     }
+
+    void KeyBindingsTests::KeyDispatchTable()
+    {
+        const auto parentJson = VerifyParseSucceeded(R"!([
+            { "command": "copy", "id": "Test.Copy", "keys": "ctrl+c" },
+            { "command": "paste", "id": "Test.Paste", "keys": "ctrl+v" },
+            { "command": "quakeMode", "id": "Test.NoVKey", "keys": "shift+sc(255)" }
+        ])!");
+        const auto childJson = VerifyParseSucceeded(R"!([
+            { "command": "closePane", "id": "Test.ClosePane", "keys": "ctrl+c" },
+            { "command": "unbound", "keys": "ctrl+v" }
+        ])!");
+
+        const auto parent = winrt::make_self<implementation::ActionMap>();
+        parent->LayerJson(parentJson, OriginTag::InBox);
+        const auto child = winrt::make_self<implementation::ActionMap>();
+        child->LayerJson(childJson, OriginTag::User);
+        child->AddLeastImportantParent(parent);
+
+        const KeyChord ctrlC{ VirtualKeyModifiers::Control, static_cast<int32_t>('C'), 0 };
+        const KeyChord ctrlV{ VirtualKeyModifiers::Control, static_cast<int32_t>('V'), 0 };
+        const KeyChord ctrlX{ VirtualKeyModifiers::Control, static_cast<int32_t>('X'), 0 };
+        const KeyChord shiftSc255{ VirtualKeyModifiers::Shift, 0, 255 };
+
+        const auto verify = [&]() {
+            VERIFY_ARE_EQUAL(L"Test.ClosePane", child->GetActionByKeyChord(ctrlC).ID());
+            VERIFY_IS_NULL(child->GetActionByKeyChord(ctrlV));
+            VERIFY_IS_TRUE(child->IsKeyChordExplicitlyUnbound(ctrlV));
+            VERIFY_IS_NULL(child->GetActionByKeyChord(ctrlX));
+            VERIFY_IS_FALSE(child->IsKeyChordExplicitlyUnbound(ctrlX));
+            VERIFY_ARE_EQUAL(L"Test.NoVKey", child->GetActionByKeyChord(shiftSc255).ID());
+        };
+
+        Log::Comment(L"Lookups without a dispatch table resolve the layers");
+        VERIFY_IS_FALSE(child->_KeyDispatchTableCache.has_value());
+        verify();
+
+        Log::Comment(L"Finalizing compiles the dispatch table, which must give identical results");
+        child->_FinalizeInheritance();
+        VERIFY_IS_TRUE(child->_KeyDispatchTableCache.has_value());
+        VERIFY_ARE_EQUAL(3u, child->_KeyDispatchTableCache->size());
+        verify();
+
+        Log::Comment(L"Modifying a parent invalidates the table of the child");
+        const KeyChord ctrlZ{ VirtualKeyModifiers::Control, static_cast<int32_t>('Z'), 0 };
+        parent->AddKeyBinding(ctrlZ, L"Test.Paste");
+        parent->DeleteKeyBinding(shiftSc255);
+        VERIFY_IS_TRUE(child->_KeyDispatchTableCache.has_value());
+        VERIFY_ARE_EQUAL(L"Test.Paste", child->GetActionByKeyChord(ctrlZ).ID());
+        VERIFY_IS_NULL(child->GetActionByKeyChord(shiftSc255));
+        VERIFY_ARE_EQUAL(L"Test.ClosePane", child->GetActionByKeyChord(ctrlC).ID());
+
+        Log::Comment(L"So does adding another parent");
+        child->_FinalizeInheritance();
+        const auto other = winrt::make_self<implementation::ActionMap>();
+        other->AddKeyBinding(shiftSc255, L"Test.Copy");
+        child->AddLeastImportantParent(other);
+        VERIFY_ARE_EQUAL(L"Test.Copy", child->GetActionByKeyChord(shiftSc255).ID());
+
+        Log::Comment(L"Finalizing again compiles a valid table");
+        child->_FinalizeInheritance();
+        VERIFY_ARE_EQUAL(L"Test.Paste", child->GetActionByKeyChord(ctrlZ).ID());
+        VERIFY_ARE_EQUAL(L"Test.Copy", child->GetActionByKeyChord(shiftSc255).ID());
+
+        Log::Comment(L"Modifying the layer discards the table");
+        VERIFY_IS_TRUE(child->RebindKeys(ctrlC, ctrlX));
+        VERIFY_IS_FALSE(child->_KeyDispatchTableCache.has_value());
+        VERIFY_ARE_EQUAL(L"Test.ClosePane", child->GetActionByKeyChord(ctrlX).ID());
+        VERIFY_ARE_EQUAL(L"Test.Copy", child->GetActionByKeyChord(ctrlC).ID());
+    }
 }
@@ -54,6 +54,7 @@ namespace SettingsModelUnitTests
         TEST_METHOD(TestLayerProfileOnColorScheme);
         TEST_METHOD(TestCommandlineToTitlePromotion);
         TEST_METHOD(TestInitialPositionParsing);
+        TEST_METHOD(SettingsEqualAcrossReloads);
     };
 
     // CascadiaSettings::_normalizeCommandLine abuses some aspects from CommandLineToArgvW
@@ -938,4 +939,51 @@ namespace SettingsModelUnitTests
             VERIFY_IS_TRUE(pos.Y == nullptr);
         }
     }
+
+    void TerminalSettingsTests::SettingsEqualAcrossReloads()
+    {
+        static constexpr std::string_view settingsTemplate{ R"(
+        {
+            "defaultProfile": "{6239a42c-1111-49a3-80bd-e8fdd045185c}",
+            "profiles": [
+                {
+                    "name" : "profile0",
+                    "guid": "{6239a42c-1111-49a3-80bd-e8fdd045185c}",
+                    "tabColor": "#112233",
+                    "environment": { "FOO": "bar" },
+                    "font": { "size": 12, "features": { "calt": 0 } },
+                    "unfocusedAppearance": { "opacity": 50 }
+                },
+                {
+                    "name" : "profile1",
+                    "guid": "{6239a42c-2222-49a3-80bd-e8fdd045185c}",
+                    "historySize": %HISTORY%
+                }
+            ]
+        })" };
+
+        const auto makeSettings = [](const std::string_view& historySize, const std::string_view& fontSize = "12") {
+            auto json = std::string{ settingsTemplate };
+            json.replace(json.find("%HISTORY%"), 9, historySize);
+            json.replace(json.find("\"size\": 12"), 10, fmt::format("\"size\": {}", fontSize));
+            return winrt::make_self<implementation::CascadiaSettings>(json);
+        };
+        const auto guid1 = ::Microsoft::Console::Utils::GuidFromString(L"{6239a42c-1111-49a3-80bd-e8fdd045185c}");
+        const auto create = [&](const auto& settings) {
+            return TerminalSettings::CreateWithProfile(*settings, settings->FindProfile(guid1));
+        };
+
+        const auto before = create(makeSettings("1"));
+
+        // Reloading the same settings, or changing an unrelated profile, must compare equal,
+        // even though the maps and references are new objects.
+        for (const auto& after : { create(makeSettings("1")), create(makeSettings("2")) })
+        {
+            VERIFY_IS_TRUE(after.DefaultSettings()->SettingsEqual(*before.DefaultSettings()));
+            VERIFY_IS_TRUE(after.UnfocusedSettings()->SettingsEqual(*before.UnfocusedSettings()));
+        }
+
+        const auto changed = create(makeSettings("1", "13"));
+        VERIFY_IS_FALSE(changed.DefaultSettings()->SettingsEqual(*before.DefaultSettings()));
+    }
 }
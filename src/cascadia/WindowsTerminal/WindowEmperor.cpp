@@ -1335,7 +1335,10 @@ void WindowEmperor::_finalizeSessionPersistence() const
                     auto filename = fmt::format(FMT_COMPILE(L"{}{}.txt"), filenamePrefix, sessionId);
                     const auto path = settingsDirectory / filename;
 
-                    if (wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, &sa, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) })
+                    // OPEN_ALWAYS instead of CREATE_ALWAYS: Restored panes that were never shown haven't
+                    // loaded their buffer yet and won't write anything. Their file must survive as is.
+                    // Everyone else truncates the file after writing their snapshot.
+                    if (wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, &sa, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) })
                     {
                         control.PersistTo(reinterpret_cast<int64_t>(file.get()));
                         bufferFilenames.emplace(std::move(filename));
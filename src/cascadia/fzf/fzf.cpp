@@ -1,4 +1,7 @@
-#include "pch.h"
+// This file is shared between several projects with different precompiled headers
+// (including conhost, which uses it for the command history), so it doesn't use any of them.
+#include <LibraryIncludes.h>
+#include <til/unicode.h>
 #include "fzf.h"
 
 #undef CharLower
@@ -24,32 +27,101 @@ enum class CharClass : uint8_t
     Digit = 3,
 };
 
-static std::vector<UChar32> utf16ToUtf32(std::wstring_view text)
+// Buffers that are reused across calls instead of being allocated for every candidate.
+// Each thread gets its own set, because the command palette scores candidates concurrently.
+struct Scratch
 {
+    std::vector<int16_t> initialScores;
+    std::vector<int16_t> consecutiveScores;
+    std::vector<int16_t> bonuses;
+    std::vector<size_t> firstOccurrenceOfEachChar;
+    std::vector<size_t> lastOccurrenceOfEachChar;
+    std::vector<int16_t> scoreMatrix;
+    std::vector<int16_t> consecutiveCharMatrix;
+    std::vector<size_t> firstIndexOfEachTerm;
+    std::vector<size_t> allUtf32Pos;
+    PreparedText text;
+};
+
+static thread_local Scratch s_scratch;
+
+// Returns the first `size` items of `vec`, growing it if needed. The contents are unspecified.
+template<typename T>
+static std::span<T> scratchSpan(std::vector<T>& vec, size_t size)
+{
+    if (vec.size() < size)
+    {
+        vec.resize(size);
+    }
+    return { vec.data(), size };
+}
+
+static void utf16ToUtf32(std::wstring_view text, std::vector<UChar32>& out)
+{
+    // The vast majority of haystacks don't contain any surrogate pairs and can simply be widened.
+    if (std::ranges::none_of(text, [](const wchar_t ch) { return til::is_surrogate(ch); }))
+    {
+        out.assign(text.begin(), text.end());
+        return;
+    }
+
     const UChar* data = reinterpret_cast<const UChar*>(text.data());
     int32_t dataLen = static_cast<int32_t>(text.size());
     int32_t cpCount = u_countChar32(data, dataLen);
 
-    std::vector<UChar32> out(cpCount);
+    out.resize(cpCount);
 
     UErrorCode status = U_ZERO_ERROR;
     u_strToUTF32(out.data(), static_cast<int32_t>(out.size()), nullptr, data, dataLen, &status);
     THROW_HR_IF(E_UNEXPECTED, status > U_ZERO_ERROR);
-
-    return out;
 }
 
 static void foldStringUtf32(std::vector<UChar32>& str)
 {
     for (auto& cp : str)
     {
-        cp = u_foldCase(cp, U_FOLD_CASE_DEFAULT);
+        // For ASCII u_foldCase() is equivalent to mapping A-Z to a-z, but a lot slower.
+        if (cp < 0x80)
+        {
+            cp |= cp >= 'A' && cp <= 'Z' ? 0x20 : 0;
+        }
+        else
+        {
+            cp = u_foldCase(cp, U_FOLD_CASE_DEFAULT);
+        }
     }
 }
 
+static void prepareText(std::wstring_view text, PreparedText& prepared)
+{
+    utf16ToUtf32(text, prepared.codePoints);
+    prepared.folded.assign(prepared.codePoints.begin(), prepared.codePoints.end());
+    foldStringUtf32(prepared.folded);
+}
+
 static size_t trySkip(const std::vector<UChar32>& input, const UChar32 searchChar, size_t startIndex)
 {
-    for (size_t i = startIndex; i < input.size(); ++i)
+    auto i = startIndex;
+
+#if defined(TIL_SSE_INTRINSICS)
+
+    // Compare 4 code points at a time and find the first match (if any) via the movemask.
+    const auto needle = _mm_set1_epi32(searchChar);
+    for (const auto end = i + ((input.size() - i) & ~size_t{ 3 }); i < end; i += 4)
+    {
+        const auto haystack = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + i));
+        const auto mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(haystack, needle)));
+        if (mask)
+        {
+            unsigned long offset;
+            _BitScanForward(&offset, mask);
+            return i + offset;
+        }
+    }
+
+#endif
+
+    for (; i < input.size(); ++i)
     {
         if (input[i] == searchChar)
         {
@@ -111,31 +183,48 @@ static constexpr auto s_charClassLut = []() {
     return lut;
 }();
 
+// The same as s_charClassLut[u_charType(ch)] for ASCII, without calling into ICU.
+static constexpr auto s_asciiCharClassLut = []() {
+    std::array<CharClass, 128> lut{};
+    lut.fill(CharClass::NonWord);
+    for (auto ch = 'a'; ch <= 'z'; ++ch)
+    {
+        lut[ch] = CharClass::CharLower;
+    }
+    for (auto ch = 'A'; ch <= 'Z'; ++ch)
+    {
+        lut[ch] = CharClass::CharUpper;
+    }
+    for (auto ch = '0'; ch <= '9'; ++ch)
+    {
+        lut[ch] = CharClass::Digit;
+    }
+    return lut;
+}();
+
 static CharClass classOf(UChar32 ch)
 {
+    if (ch >= 0 && ch < 0x80)
+    {
+        return s_asciiCharClassLut[ch];
+    }
     return s_charClassLut[u_charType(ch)];
 }
 
-static int32_t fzfFuzzyMatchV2(const std::vector<UChar32>& text, const std::vector<UChar32>& pattern, std::vector<size_t>* pos)
+// firstIndexOf is the result of asciiFuzzyIndex(foldedText, pattern) and must not be npos.
+static int32_t fzfFuzzyMatchV2(const std::vector<UChar32>& text, const std::vector<UChar32>& foldedText, const std::vector<UChar32>& pattern, size_t firstIndexOf, std::vector<size_t>* pos)
 {
     if (pattern.size() == 0)
     {
         return 0;
     }
 
-    auto foldedText = text;
-    foldStringUtf32(foldedText);
-
-    size_t firstIndexOf = asciiFuzzyIndex(foldedText, pattern);
-    if (firstIndexOf == npos)
-    {
-        return 0;
-    }
-
-    auto initialScores = std::vector<int16_t>(text.size());
-    auto consecutiveScores = std::vector<int16_t>(text.size());
-    auto firstOccurrenceOfEachChar = std::vector<size_t>(pattern.size());
-    auto bonusesSpan = std::vector<int16_t>(text.size());
+    auto& scratch = s_scratch;
+    const auto initialScores = scratchSpan(scratch.initialScores, text.size());
+    const auto consecutiveScores = scratchSpan(scratch.consecutiveScores, text.size());
+    const auto firstOccurrenceOfEachChar = scratchSpan(scratch.firstOccurrenceOfEachChar, pattern.size());
+    const auto lastOccurrenceOfEachChar = scratchSpan(scratch.lastOccurrenceOfEachChar, pattern.size());
+    const auto bonusesSpan = scratchSpan(scratch.bonuses, text.size());
 
     int16_t maxScore = 0;
     size_t maxScorePos = 0;
@@ -149,9 +238,9 @@ static int32_t fzfFuzzyMatchV2(const std::vector<UChar32>& text, const std::vect
 
     std::span<const UChar32> lowerText(foldedText);
     auto lowerTextSlice = lowerText.subspan(firstIndexOf);
-    auto initialScoresSlice = std::span(initialScores).subspan(firstIndexOf);
-    auto consecutiveScoresSlice = std::span(consecutiveScores).subspan(firstIndexOf);
-    auto bonusesSlice = std::span(bonusesSpan).subspan(firstIndexOf, text.size() - firstIndexOf);
+    auto initialScoresSlice = initialScores.subspan(firstIndexOf);
+    auto consecutiveScoresSlice = consecutiveScores.subspan(firstIndexOf);
+    auto bonusesSlice = bonusesSpan.subspan(firstIndexOf, text.size() - firstIndexOf);
 
     for (size_t i = 0; i < lowerTextSlice.size(); i++)
     {
@@ -219,31 +308,49 @@ static int32_t fzfFuzzyMatchV2(const std::vector<UChar32>& text, const std::vect
     const auto rows = pattern.size();
     auto consecutiveCharMatrixSize = width * pattern.size();
 
-    std::vector<int16_t> scoreMatrix(width * rows);
+    // The backtrace below relies on the cells outside of the computed band being 0.
+    const auto scoreMatrix = scratchSpan(scratch.scoreMatrix, width * rows);
+    std::fill(scoreMatrix.begin(), scoreMatrix.end(), int16_t{ 0 });
     std::copy_n(initialScores.begin() + firstOccurrenceOfFirstChar, width, scoreMatrix.begin());
-    std::span scoreSpan(scoreMatrix);
 
-    std::vector<int16_t> consecutiveCharMatrix(width * rows);
+    const auto consecutiveCharMatrix = scratchSpan(scratch.consecutiveCharMatrix, width * rows);
+    std::fill(consecutiveCharMatrix.begin(), consecutiveCharMatrix.end(), int16_t{ 0 });
     std::copy_n(consecutiveScores.begin() + firstOccurrenceOfFirstChar, width, consecutiveCharMatrix.begin());
-    std::span consecutiveCharMatrixSpan(consecutiveCharMatrix);
+
+    // firstOccurrenceOfEachChar[i] is the earliest column in which pattern[i] can be matched.
+    // Similarly, lastOccurrenceOfEachChar[i] is the latest column in which pattern[i] can be
+    // matched so that the rest of the pattern still fits after it. Row i of the matrix is only
+    // ever read by row i+1 for a match of pattern[i+1] and by the backtrace, which both stay
+    // left of lastOccurrenceOfEachChar[i+1]. We can thus skip computing anything right of it.
+    lastOccurrenceOfEachChar[rows - 1] = lastIndex;
+    for (auto i = rows - 1; i-- > 0;)
+    {
+        auto column = lastOccurrenceOfEachChar[i + 1];
+        do
+        {
+            column--;
+        } while (foldedText[column] != pattern[i]);
+        lastOccurrenceOfEachChar[i] = column;
+    }
 
     auto patternSliceStr = std::span(pattern).subspan(1);
 
     for (size_t off = 0; off < pattern.size() - 1; off++)
     {
         auto patternCharOffset = firstOccurrenceOfEachChar[off + 1];
-        auto sliceLen = lastIndex - patternCharOffset + 1;
+        auto rowEnd = off + 2 < rows ? lastOccurrenceOfEachChar[off + 2] - 1 : lastIndex;
+        auto sliceLen = rowEnd - patternCharOffset + 1;
         currentPatternChar = patternSliceStr[off];
         patternIndex = off + 1;
         auto row = patternIndex * width;
         inGap = false;
         std::span<const UChar32> textSlice = lowerText.subspan(patternCharOffset, sliceLen);
         std::span bonusSlice(bonusesSpan.begin() + patternCharOffset, textSlice.size());
-        std::span<int16_t> consecutiveCharMatrixSlice = consecutiveCharMatrixSpan.subspan(row + patternCharOffset - firstOccurrenceOfFirstChar, textSlice.size());
-        std::span<int16_t> consecutiveCharMatrixDiagonalSlice = consecutiveCharMatrixSpan.subspan(row + patternCharOffset - firstOccurrenceOfFirstChar - 1 - width, textSlice.size());
-        std::span<int16_t> scoreMatrixSlice = scoreSpan.subspan(row + patternCharOffset - firstOccurrenceOfFirstChar, textSlice.size());
-        std::span<int16_t> scoreMatrixDiagonalSlice = scoreSpan.subspan(row + patternCharOffset - firstOccurrenceOfFirstChar - 1 - width, textSlice.size());
-        std::span<int16_t> scoreMatrixLeftSlice = scoreSpan.subspan(row + patternCharOffset - firstOccurrenceOfFirstChar - 1, textSlice.size());
+        std::span<int16_t> consecutiveCharMatrixSlice = consecutiveCharMatrix.subspan(row + patternCharOffset - firstOccurrenceOfFirstChar, textSlice.size());
+        std::span<int16_t> consecutiveCharMatrixDiagonalSlice = consecutiveCharMatrix.subspan(row + patternCharOffset - firstOccurrenceOfFirstChar - 1 - width, textSlice.size());
+        std::span<int16_t> scoreMatrixSlice = scoreMatrix.subspan(row + patternCharOffset - firstOccurrenceOfFirstChar, textSlice.size());
+        std::span<int16_t> scoreMatrixDiagonalSlice = scoreMatrix.subspan(row + patternCharOffset - firstOccurrenceOfFirstChar - 1 - width, textSlice.size());
+        std::span<int16_t> scoreMatrixLeftSlice = scoreMatrix.subspan(row + patternCharOffset - firstOccurrenceOfFirstChar - 1, textSlice.size());
 
         if (!scoreMatrixLeftSlice.empty())
         {
@@ -355,7 +462,8 @@ Pattern fzf::matcher::ParsePattern(const std::wstring_view patternStr)
 
         const auto end = std::min(patternStr.size(), patternStr.find_first_of(L' ', beg));
         const auto word = patternStr.substr(beg, end - beg);
-        auto codePoints = utf16ToUtf32(word);
+        std::vector<UChar32> codePoints;
+        utf16ToUtf32(word, codePoints);
         foldStringUtf32(codePoints);
         patObj.terms.push_back(std::move(codePoints));
         pos = end;
@@ -364,6 +472,13 @@ Pattern fzf::matcher::ParsePattern(const std::wstring_view patternStr)
     return patObj;
 }
 
+PreparedText fzf::matcher::PrepareText(const std::wstring_view text)
+{
+    PreparedText prepared;
+    prepareText(text, prepared);
+    return prepared;
+}
+
 std::optional<MatchResult> fzf::matcher::Match(std::wstring_view text, const Pattern& pattern)
 {
     if (pattern.terms.empty())
@@ -371,22 +486,46 @@ std::optional<MatchResult> fzf::matcher::Match(std::wstring_view text, const Pat
         return MatchResult{};
     }
 
-    const auto textCodePoints = utf16ToUtf32(text);
+    auto& prepared = s_scratch.text;
+    prepareText(text, prepared);
+    return Match(prepared, pattern);
+}
+
+std::optional<MatchResult> fzf::matcher::Match(const PreparedText& text, const Pattern& pattern)
+{
+    if (pattern.terms.empty())
+    {
+        return MatchResult{};
+    }
+
+    const auto& textCodePoints = text.codePoints;
+
+    // Most candidates don't match at all. Check that every term can be found
+    // before scoring any of them, which is a lot more expensive.
+    const auto firstIndexOfEachTerm = scratchSpan(s_scratch.firstIndexOfEachTerm, pattern.terms.size());
+    for (size_t i = 0; i < pattern.terms.size(); ++i)
+    {
+        firstIndexOfEachTerm[i] = asciiFuzzyIndex(text.folded, pattern.terms[i]);
+        if (firstIndexOfEachTerm[i] == npos)
+        {
+            return std::nullopt;
+        }
+    }
 
     int32_t totalScore = 0;
-    std::vector<size_t> allUtf32Pos;
+    auto& allUtf32Pos = s_scratch.allUtf32Pos;
+    allUtf32Pos.clear();
 
-    for (const auto& term : pattern.terms)
+    for (size_t i = 0; i < pattern.terms.size(); ++i)
     {
-        std::vector<size_t> termPos;
-        auto score = fzfFuzzyMatchV2(textCodePoints, term, &termPos);
+        // fzfFuzzyMatchV2 only ever appends to the positions.
+        auto score = fzfFuzzyMatchV2(textCodePoints, text.folded, pattern.terms[i], firstIndexOfEachTerm[i], &allUtf32Pos);
         if (score <= 0)
         {
             return std::nullopt;
         }
 
         totalScore += score;
-        allUtf32Pos.insert(allUtf32Pos.end(), termPos.begin(), termPos.end());
     }
 
     std::ranges::sort(allUtf32Pos);
@@ -22,6 +22,17 @@ namespace fzf::matcher
         std::vector<std::vector<UChar32>> terms;
     };
 
+    // A haystack that has already been converted to UTF-32 and case folded.
+    // Callers that match the same text against many patterns can hold on to
+    // one of these instead of paying for the conversion on every Match() call.
+    struct PreparedText
+    {
+        std::vector<UChar32> codePoints;
+        std::vector<UChar32> folded;
+    };
+
     Pattern ParsePattern(std::wstring_view patternStr);
+    PreparedText PrepareText(std::wstring_view text);
     std::optional<MatchResult> Match(std::wstring_view text, const Pattern& pattern);
+    std::optional<MatchResult> Match(const PreparedText& text, const Pattern& pattern);
 }
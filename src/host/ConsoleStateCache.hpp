@@ -0,0 +1,120 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ConsoleStateCache.hpp
+
+Abstract:
+- Caches the results of frequently polled, read-only console APIs like GetConsoleMode()
+  or GetConsoleScreenBufferInfoEx(). Build tools with many child processes call them all the
+  time and would otherwise queue up behind the console lock, held by output writes, the
+  renderer, the VT input thread and so on.
+- Entries are published while holding the console lock and are valid until the lock gets
+  released by anyone else, because the state might have changed then. API calls that are
+  known to be read-only (see ApiSorter) don't invalidate the cache when they release the
+  lock, which keeps it warm while several clients are polling.
+- Entries may only be published and served by the outermost lock owner (recursion depth 1).
+  A nested caller may have changed the state itself and the entry would only be invalidated
+  once the outermost lock is released, so it must neither read nor publish a cached value.
+
+--*/
+
+#pragma once
+
+#include <til/mutex.h>
+
+class ConsoleStateCache
+{
+public:
+    template<typename T>
+    struct Entry
+    {
+        const void* object = nullptr;
+        uint64_t generation = 0;
+        T value{};
+    };
+
+    struct Entries
+    {
+        Entry<ULONG> inputMode;
+        Entry<ULONG> outputMode;
+        Entry<CONSOLE_SCREEN_BUFFER_INFOEX> screenBufferInfo;
+    };
+
+    // Marks the current thread as executing a read-only API call for as long as it exists.
+    class ReadOnlyScope
+    {
+    public:
+        ReadOnlyScope(ConsoleStateCache& cache) noexcept :
+            _cache{ cache },
+            _previous{ cache._readOnlyThread.exchange(GetCurrentThreadId(), std::memory_order_relaxed) }
+        {
+        }
+
+        ~ReadOnlyScope()
+        {
+            _cache._readOnlyThread.store(_previous, std::memory_order_relaxed);
+        }
+
+        ReadOnlyScope(const ReadOnlyScope&) = delete;
+        ReadOnlyScope& operator=(const ReadOnlyScope&) = delete;
+        ReadOnlyScope(ReadOnlyScope&&) = delete;
+        ReadOnlyScope& operator=(ReadOnlyScope&&) = delete;
+
+    private:
+        ConsoleStateCache& _cache;
+        DWORD _previous;
+    };
+
+    // Must be called by the console lock owner right before releasing it.
+    void Invalidate() noexcept
+    {
+        if (!_isReadOnlyThread())
+        {
+            _generation.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    // Must be called without holding the console lock.
+    template<typename T>
+    [[nodiscard]] bool TryGet(Entry<T> Entries::*entry, const void* object, T& value) const noexcept
+    {
+        const auto generation = _generation.load(std::memory_order_acquire);
+        const auto entries = _entries.lock_shared();
+        const auto& e = (*entries).*entry;
+
+        if (e.object != object || e.generation != generation)
+        {
+            return false;
+        }
+
+        value = e.value;
+        return true;
+    }
+
+    // Must be called while holding the console lock exactly once.
+    template<typename T>
+    void Publish(Entry<T> Entries::*entry, const void* object, const T& value) noexcept
+    {
+        // Unless we're in a read-only API call, releasing the lock
+        // will increment the generation. The entry is valid after that.
+        const auto generation = _generation.load(std::memory_order_relaxed) + (_isReadOnlyThread() ? 0 : 1);
+        auto entries = _entries.lock();
+        auto& e = (*entries).*entry;
+
+        e.object = object;
+        e.generation = generation;
+        e.value = value;
+    }
+
+private:
+    bool _isReadOnlyThread() const noexcept
+    {
+        return _readOnlyThread.load(std::memory_order_relaxed) == GetCurrentThreadId();
+    }
+
+    til::shared_mutex<Entries> _entries;
+    std::atomic<uint64_t> _generation{ 1 };
+    std::atomic<DWORD> _readOnlyThread{ 0 };
+};
@@ -101,6 +101,8 @@ using namespace Microsoft::Console::Interactivity;
         {
             _overlappedBuf.hEvent = _overlappedEvent.get();
             _overlapped = &_overlappedBuf;
+            // Without the threadpool wait, _flushNow() simply won't coalesce writes.
+            _flushWait.reset(CreateThreadpoolWait(&_flushDeferredCallback, this, nullptr));
         }
     }
 
@@ -249,6 +251,9 @@ void VtIo::Shutdown() noexcept
     // The reverse of what we did in StartIfNeeded.
     try
     {
+        // We're going away. Anything that's still held back must be written out now.
+        _cancelDeferredFlush();
+
         Writer writer{ this };
 
         writer.WriteUTF8(
@@ -467,17 +472,66 @@ void VtIo::_uncork()
     }
 }
 
+// The most output _flushNow() holds back while the previous write is still in flight.
+// Beyond this it blocks on that write like it used to, so that a terminal that stopped
+// reading can't make us buffer without bound. It matches the 128KiB pipe buffer that
+// the Windows Terminal creates for ConPTY, which means a single write can usually
+// hand all of it over to the pipe without blocking.
+static constexpr size_t maxCoalescedOutput = 128 * 1024;
+
 void VtIo::_flushNow()
 {
-    size_t minSize = 0;
+    // Anything before _backCommitted was submitted by a previous Writer, but its flush was deferred.
+    auto minSize = _backCommitted;
 
     if (_writerRestoreCursor)
     {
-        minSize = 4;
+        minSize += 4;
         _writerRestoreCursor = false;
         _back.append("\x1b\x38"); // DECRC: DEC Restore Cursor (+ attributes)
     }
 
+    // We encountered an exception and shouldn't flush the broken pieces.
+    // If all the Writer added is DECSC/DECRC that was added by BackupCursor & us, we can drop it as well.
+    // In either case we must retain the output of previous Writers that's still waiting to be flushed.
+    if (std::exchange(_writerTainted, false) || _back.size() <= minSize)
+    {
+        _back.resize(_backCommitted);
+    }
+
+    _backCommitted = _back.size();
+
+    // If _back is empty, we can return early.
+    if (_backCommitted == 0)
+    {
+        return;
+    }
+
+    // No point in calling WriteFile if we already encountered ERROR_BROKEN_PIPE.
+    // We do this after the above, so that _back doesn't grow indefinitely.
+    if (!_hOutput)
+    {
+        _back.clear();
+        _backCommitted = 0;
+        return;
+    }
+
+    // If the terminal hasn't finished reading our previous write yet, blocking on it
+    // would only stall the client application. Instead, we keep accumulating output in
+    // _back and flush it all at once as soon as the pipe is writable again. This turns
+    // bursts of tiny API calls (progress bars, etc.) into a few large writes.
+    if (_overlappedPending && _flushWait && _backCommitted < maxCoalescedOutput && !HasOverlappedIoCompleted(_overlapped))
+    {
+        if (!_flushDeferred)
+        {
+            _flushDeferred = true;
+            SetThreadpoolWait(_flushWait.get(), _overlappedEvent.get(), nullptr);
+        }
+        return;
+    }
+
+    _flushDeferred = false;
+
     if (_overlappedPending)
     {
         _overlappedPending = false;
@@ -488,11 +542,15 @@ void VtIo::_flushNow()
             // Not much we can do here. Let's treat this like a ERROR_BROKEN_PIPE.
             _hOutput.reset();
             SendCloseEvent();
+            _back.clear();
+            _backCommitted = 0;
+            return;
         }
     }
 
     _front.clear();
     _front.swap(_back);
+    _backCommitted = 0;
 
     // If it's >128KiB large and twice as large as the previous buffer, free the memory.
     // This ensures that there's a pathway for shrinking the buffer from large sizes.
@@ -501,27 +559,6 @@ void VtIo::_flushNow()
         _back = std::string{};
     }
 
-    // We encountered an exception and shouldn't flush the broken pieces.
-    if (_writerTainted)
-    {
-        _writerTainted = false;
-        return;
-    }
-
-    // If _back (now _front) was empty, we can return early. If all _front contains is
-    // DECSC/DECRC that was added by BackupCursor & us, we can also return early.
-    if (_front.size() <= minSize)
-    {
-        return;
-    }
-
-    // No point in calling WriteFile if we already encountered ERROR_BROKEN_PIPE.
-    // We do this after the above, so that _back doesn't grow indefinitely.
-    if (!_hOutput)
-    {
-        return;
-    }
-
     const auto write = gsl::narrow_cast<DWORD>(_front.size());
 
     TraceLoggingWrite(
@@ -554,6 +591,52 @@ void VtIo::_flushNow()
     }
 }
 
+// Stops coalescing output and makes sure that _flushDeferredCallback() isn't running and won't run anymore.
+// Whatever it didn't get to flush remains in _back and is written by the next _flushNow().
+void VtIo::_cancelDeferredFlush() noexcept
+{
+    if (!_flushWait)
+    {
+        return;
+    }
+
+    SetThreadpoolWait(_flushWait.get(), nullptr, nullptr);
+
+    {
+        // The callback may already be running and be waiting for the console lock, which we're
+        // usually holding. We must let it have the lock while waiting for it, or we'd deadlock.
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto suspension = gci.SuspendLock();
+        WaitForThreadpoolWaitCallbacks(_flushWait.get(), FALSE);
+    }
+
+    // Without _flushWait, _flushNow() won't defer anymore.
+    _flushWait.reset();
+    _flushDeferred = false;
+}
+
+// Called on the threadpool once the overlapped write that caused _flushNow() to defer has completed.
+void NTAPI VtIo::_flushDeferredCallback(PTP_CALLBACK_INSTANCE, PVOID context, PTP_WAIT, TP_WAIT_RESULT) noexcept
+try
+{
+    const auto self = static_cast<VtIo*>(context);
+
+    LockConsole();
+    const auto unlock = wil::scope_exit([] { UnlockConsole(); });
+
+    if (!std::exchange(self->_flushDeferred, false))
+    {
+        return;
+    }
+
+    // If a Writer is currently active, its Submit() will flush for us.
+    if (self->_corked <= 0)
+    {
+        self->_flushNow();
+    }
+}
+CATCH_LOG()
+
 void VtIo::Writer::BackupCursor() const
 {
     if (!_io->_writerRestoreCursor)
@@ -770,6 +853,8 @@ void VtIo::Writer::WriteInfos(til::point target, std::span<const CHAR_INFO> info
     const auto beg = infos.begin();
     const auto end = infos.end();
     const auto last = end - 1;
+    // Only the colors and reverse video get translated, just like in FormatAttributes().
+    static constexpr WORD translatedAttributes = FG_ATTRS | BG_ATTRS | COMMON_LVB_REVERSE_VIDEO;
     WORD attributes = 0xffff;
 
     WriteCUP(target);
@@ -809,10 +894,19 @@ void VtIo::Writer::WriteInfos(til::point target, std::span<const CHAR_INFO> info
             }
         }
 
-        if (attributes != ci.Attributes)
+        if (const auto next = static_cast<WORD>(ci.Attributes & translatedAttributes); attributes != next)
         {
-            attributes = ci.Attributes;
-            WriteAttributes(TextAttribute{ attributes });
+            // The first attribute of the run must reset whatever VT attributes the client may have set.
+            // After that we know the state of the terminal and only need to emit what changed.
+            if (attributes == 0xffff)
+            {
+                _io->_sgr.AppendReset(_io->_back, TextAttribute{ next });
+            }
+            else
+            {
+                _io->_sgr.AppendTransition(_io->_back, TextAttribute{ attributes }, TextAttribute{ next });
+            }
+            attributes = next;
         }
 
         int repeat = 1;
@@ -5,6 +5,7 @@
 
 #include "VtInputThread.hpp"
 #include "PtySignalInputThread.hpp"
+#include "../buffer/out/SgrEncoder.hpp"
 
 class ConsoleArguments;
 
@@ -79,8 +80,11 @@ namespace Microsoft::Console::VirtualTerminal
 
         [[nodiscard]] HRESULT _Initialize(const HANDLE InHandle, const HANDLE OutHandle, _In_opt_ const HANDLE SignalHandle);
 
+        static void NTAPI _flushDeferredCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WAIT wait, TP_WAIT_RESULT waitResult) noexcept;
+
         void _uncork();
         void _flushNow();
+        void _cancelDeferredFlush() noexcept;
 
         // After CreateIoHandlers is called, these will be invalid.
         wil::unique_hfile _hInput;
@@ -97,10 +101,17 @@ namespace Microsoft::Console::VirtualTerminal
         // The back buffer is the one we're concurrently writing to.
         std::string _front;
         std::string _back;
+        SgrEncoder _sgr;
         OVERLAPPED* _overlapped = nullptr;
         OVERLAPPED _overlappedBuf{};
         wil::unique_event _overlappedEvent;
         bool _overlappedPending = false;
+        // While an overlapped write is in flight, submitted output accumulates in _back (see maxCoalescedOutput)
+        // instead of blocking the caller. _backCommitted is the length of that submitted prefix and
+        // _flushWait flushes it once the pipe becomes writable again.
+        wil::unique_threadpool_wait _flushWait;
+        size_t _backCommitted = 0;
+        bool _flushDeferred = false;
         bool _writerRestoreCursor = false;
         bool _writerTainted = false;
 
@@ -225,32 +225,59 @@ static FillConsoleResult FillConsoleImpl(SCREEN_INFORMATION& screenInfo, FillCon
         auto attrs = static_cast<const uint16_t*>(data);
         auto chars = static_cast<const wchar_t*>(data);
 
-        OutputCellIterator it;
-
-        switch (mode)
+        // Uniform fills don't need to go through OutputCellIterator one cell at a time.
+        // Wide glyphs are rare in fills and are left to the OutputCellIterator below.
+        if (mode == FillConsoleMode::FillAttribute || (mode == FillConsoleMode::FillCharacter && !IsGlyphFullWidth(*chars)))
         {
-        case FillConsoleMode::WriteAttribute:
-            it = OutputCellIterator({ attrs, lengthToWrite });
-            break;
-        case FillConsoleMode::WriteCharacter:
-            it = OutputCellIterator({ chars, lengthToWrite });
-            break;
-        case FillConsoleMode::FillAttribute:
-            it = OutputCellIterator(TextAttribute(*attrs), lengthToWrite);
-            break;
-        case FillConsoleMode::FillCharacter:
-            it = OutputCellIterator(*chars, lengthToWrite);
-            break;
-        default:
-            __assume(false);
+            auto& textBuffer = screenBuffer.GetTextBuffer();
+            const auto cellsAvailable = bufferSize.Dimensions().area<size_t>() - (gsl::narrow_cast<size_t>(startingCoordinate.y) * bufferSize.Width() + startingCoordinate.x);
+            const auto length = std::min(lengthToWrite, cellsAvailable);
+
+            if (mode == FillConsoleMode::FillAttribute)
+            {
+                const TextAttribute attr{ *attrs };
+                textBuffer.FillCells(startingCoordinate, length, nullptr, &attr);
+            }
+            else
+            {
+                textBuffer.FillCells(startingCoordinate, length, chars, nullptr);
+            }
+
+            result.lengthRead = length;
+            result.cellsModified = gsl::narrow_cast<til::CoordType>(length);
+
+            // If we've overwritten image content, it needs to be erased.
+            ImageSlice::EraseCells(screenInfo.GetTextBuffer(), startingCoordinate, result.cellsModified);
         }
+        else
+        {
+            OutputCellIterator it;
+
+            switch (mode)
+            {
+            case FillConsoleMode::WriteAttribute:
+                it = OutputCellIterator({ attrs, lengthToWrite });
+                break;
+            case FillConsoleMode::WriteCharacter:
+                it = OutputCellIterator({ chars, lengthToWrite });
+                break;
+            case FillConsoleMode::FillAttribute:
+                it = OutputCellIterator(TextAttribute(*attrs), lengthToWrite);
+                break;
+            case FillConsoleMode::FillCharacter:
+                it = OutputCellIterator(*chars, lengthToWrite);
+                break;
+            default:
+                __assume(false);
+            }
 
-        const auto done = screenBuffer.Write(it, startingCoordinate, false);
-        result.lengthRead = done.GetInputDistance(it);
-        result.cellsModified = done.GetCellDistance(it);
+            const auto done = screenBuffer.Write(it, startingCoordinate, false);
+            result.lengthRead = done.GetInputDistance(it);
+            result.cellsModified = done.GetCellDistance(it);
 
-        // If we've overwritten image content, it needs to be erased.
-        ImageSlice::EraseCells(screenInfo.GetTextBuffer(), startingCoordinate, result.cellsModified);
+            // If we've overwritten image content, it needs to be erased.
+            ImageSlice::EraseCells(screenInfo.GetTextBuffer(), startingCoordinate, result.cellsModified);
+        }
     }
 
     if (result.cellsModified > 0)
@@ -44,9 +44,96 @@ struct case_insensitive_equality
     }
 };
 
+// An alias target, compiled into a sequence of literal text runs and argument references when it's added.
+// This way s_MatchAndCopyAlias() doesn't need to parse the $ escape sequences on every single line the user enters.
+struct AliasMacro
+{
+    static constexpr uint8_t NoArgument = 0;
+    static constexpr uint8_t AllArguments = 10;
+
+    struct Segment
+    {
+        // The number of characters in `literals` that precede the argument.
+        uint32_t literalLength = 0;
+        // 1-9 for $1-$9, AllArguments for $*, or NoArgument for the trailing literal text.
+        uint8_t argument = NoArgument;
+    };
+
+    explicit AliasMacro(std::wstring text) :
+        target{ std::move(text) }
+    {
+        const auto beg = target.begin();
+        const auto end = target.end();
+        size_t literalBeg = 0;
+
+        const auto pushSegment = [&](const uint8_t argument) {
+            segments.push_back({ gsl::narrow<uint32_t>(literals.size() - literalBeg), argument });
+            literalBeg = literals.size();
+        };
+
+        for (auto it = beg; it != end;)
+        {
+            auto ch = *it++;
+            if (ch != L'$' || it == end)
+            {
+                literals.push_back(ch);
+                continue;
+            }
+
+            // $ is our "escape character" and this code handles the escape
+            // sequence consisting of a single subsequent character.
+            ch = *it++;
+            const auto chLower = til::tolower_ascii(ch);
+            if (chLower >= L'1' && chLower <= L'9')
+            {
+                // $1-9 = append the given parameter
+                pushSegment(gsl::narrow_cast<uint8_t>(chLower - L'0'));
+            }
+            else if (chLower == L'*')
+            {
+                // $* = append all parameters
+                pushSegment(AllArguments);
+            }
+            else if (chLower == L'l')
+            {
+                literals.push_back(L'<');
+            }
+            else if (chLower == L'g')
+            {
+                literals.push_back(L'>');
+            }
+            else if (chLower == L'b')
+            {
+                literals.push_back(L'|');
+            }
+            else if (chLower == L't')
+            {
+                literals.append(L"\r\n");
+                lines++;
+            }
+            else
+            {
+                literals.push_back(L'$');
+                literals.push_back(ch);
+            }
+        }
+
+        literals.append(L"\r\n");
+        pushSegment(NoArgument);
+    }
+
+    // The target as it was given to AddConsoleAlias(). This is what GetConsoleAlias() returns.
+    std::wstring target;
+    // The literal text of the expansion (including the trailing newline), with $L, $G, $B and $T already substituted.
+    std::wstring literals;
+    std::vector<Segment> segments;
+    // The number of lines the expansion consists of.
+    size_t lines = 1;
+};
+
 std::unordered_map<std::wstring,
                    std::unordered_map<std::wstring,
-                                      std::wstring,
+                                      AliasMacro,
                                       case_insensitive_hash,
                                       case_insensitive_equality>,
                    case_insensitive_hash,
@@ -118,7 +205,7 @@ std::unordered_map<std::wstring,
         else
         {
             // Map will auto-create each level as necessary
-            g_aliasData[exeNameString][sourceString] = targetString;
+            g_aliasData[exeNameString].insert_or_assign(std::move(sourceString), AliasMacro{ std::move(targetString) });
         }
     }
     CATCH_RETURN();
@@ -153,17 +240,14 @@ std::unordered_map<std::wstring,
         til::at(*target, 0) = UNICODE_NULL;
     }
 
-    std::wstring exeNameString(exeName);
-    std::wstring sourceString(source);
-
     // For compatibility, return ERROR_GEN_FAILURE for any result where the alias can't be found.
     // We use .find for the iterators then dereference to search without creating entries.
-    const auto exeIter = g_aliasData.find(exeNameString);
+    const auto exeIter = g_aliasData.find(exeName);
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), exeIter == g_aliasData.end());
     const auto& exeData = exeIter->second;
-    const auto sourceIter = exeData.find(sourceString);
+    const auto sourceIter = exeData.find(source);
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), sourceIter == exeData.end());
-    const auto& targetString = sourceIter->second;
+    const auto& targetString = sourceIter->second.target;
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), targetString.size() == 0);
 
     // TargetLength is a byte count, convert to characters.
@@ -342,13 +426,13 @@ static std::wstring aliasesSeparator(L"=");
             {
                 // Alias stores lengths in bytes.
                 auto cchSource = pair.first.size();
-                auto cchTarget = pair.second.size();
+                auto cchTarget = pair.second.target.size();
 
                 // If we're counting how much multibyte space will be needed, trial convert the source and target strings before we add.
                 if (!countInUnicode)
                 {
                     cchSource = GetALengthFromW(codepage, pair.first);
-                    cchTarget = GetALengthFromW(codepage, pair.second);
+                    cchTarget = GetALengthFromW(codepage, pair.second.target);
                 }
 
                 // Accumulate all sizes to the final string count.
@@ -473,7 +557,7 @@ void Alias::s_ClearCmdExeAliases()
         {
             // Alias stores lengths in bytes.
             const auto cchSource = pair.first.size();
-            const auto cchTarget = pair.second.size();
+            const auto cchTarget = pair.second.target.size();
 
             // Add up how many characters we will need for the full alias data.
             size_t cchNeeded = 0;
@@ -503,7 +587,7 @@ void Alias::s_ClearCmdExeAliases()
                 RETURN_IF_FAILED(SizeTSub(cchAliasBufferRemaining, aliasesSeparator.size(), &cchAliasBufferRemaining));
                 AliasesBufferPtrW += aliasesSeparator.size();
 
-                RETURN_IF_FAILED(StringCchCopyNW(AliasesBufferPtrW, cchAliasBufferRemaining, pair.second.data(), cchTarget));
+                RETURN_IF_FAILED(StringCchCopyNW(AliasesBufferPtrW, cchAliasBufferRemaining, pair.second.target.data(), cchTarget));
                 RETURN_IF_FAILED(SizeTSub(cchAliasBufferRemaining, cchTarget, &cchAliasBufferRemaining));
                 AliasesBufferPtrW += cchTarget;
 
@@ -892,81 +976,44 @@ std::wstring Alias::s_MatchAndCopyAlias(std::wstring_view sourceText, std::wstri
         return {};
     }
 
-    const auto& target = aliasIter->second;
-    if (target.size() == 0)
+    const auto& macro = aliasIter->second;
+    if (macro.target.size() == 0)
     {
         return {};
     }
 
+    // args[] is an array of slices into the source text. $* expands to the text
+    // starting at first argument up to the end of the source.
+    const std::wstring_view allArgs = argc > 1 ? std::wstring_view{ args[1].data(), sourceText.data() + sourceText.size() } : std::wstring_view{};
+
     std::wstring buffer;
-    size_t lines = 0;
+    buffer.reserve(macro.literals.size() + sourceText.size());
 
-    for (auto it = target.begin(), end = target.end(); it != end;)
+    const std::wstring_view literals{ macro.literals };
+    size_t literalBeg = 0;
+
+    for (const auto& segment : macro.segments)
     {
-        auto ch = *it++;
-        if (ch != L'$' || it == end)
-        {
-            buffer.push_back(ch);
-            continue;
-        }
+        buffer.append(literals.substr(literalBeg, segment.literalLength));
+        literalBeg += segment.literalLength;
 
-        // $ is our "escape character" and this code handles the escape
-        // sequence consisting of a single subsequent character.
-        ch = *it++;
-        const auto chLower = til::tolower_ascii(ch);
-        if (chLower >= L'1' && chLower <= L'9')
-        {
-            // $1-9 = append the given parameter
-            const size_t idx = chLower - L'0';
-            if (idx < argc)
-            {
-                buffer.append(args[idx]);
-            }
-        }
-        else if (chLower == L'*')
-        {
-            // $* = append all parameters
-            if (argc > 1)
-            {
-                // args[] is an array of slices into the source text. This appends the text
-                // starting at first argument up to the end of the source to the buffer.
-                buffer.append(args[1].data(), sourceText.data() + sourceText.size());
-            }
-        }
-        else if (chLower == L'l')
-        {
-            buffer.push_back(L'<');
-        }
-        else if (chLower == L'g')
+        if (segment.argument == AliasMacro::AllArguments)
         {
-            buffer.push_back(L'>');
+            buffer.append(allArgs);
         }
-        else if (chLower == L'b')
+        else if (segment.argument != AliasMacro::NoArgument && segment.argument < argc)
         {
-            buffer.push_back(L'|');
-        }
-        else if (chLower == L't')
-        {
-            buffer.append(L"\r\n");
-            lines++;
-        }
-        else
-        {
-            buffer.push_back(L'$');
-            buffer.push_back(ch);
+            buffer.append(til::at(args, segment.argument));
         }
     }
 
-    buffer.append(L"\r\n");
-    lines++;
-
-    lineCount = lines;
+    lineCount = macro.lines;
     return buffer;
 }
 
 void Alias::s_TestAddAlias(std::wstring exe, std::wstring alias, std::wstring target)
 {
-    g_aliasData[std::move(exe)][std::move(alias)] = std::move(target);
+    g_aliasData[std::move(exe)].insert_or_assign(std::move(alias), AliasMacro{ std::move(target) });
 }
 
 void Alias::s_TestClearAliases()
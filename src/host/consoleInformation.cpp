@@ -33,11 +33,17 @@ void CONSOLE_INFORMATION::LockConsole() noexcept
 #pragma prefast(suppress : 26135, "Adding lock annotation spills into entire project. Future work.")
 void CONSOLE_INFORMATION::UnlockConsole() noexcept
 {
+    StateCache.Invalidate();
     _lock.unlock();
 }
 
 til::recursive_ticket_lock_suspension CONSOLE_INFORMATION::SuspendLock() noexcept
 {
+    // Others can acquire the lock while it's suspended and must not see what we cached so far.
+    if (_lock.is_locked())
+    {
+        StateCache.Invalidate();
+    }
     return _lock.suspend();
 }
 
@@ -418,7 +418,6 @@ CATCH_RETURN();
 {
     try
     {
-        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
         auto& storageBuffer = context.GetActiveBuffer();
         const auto storageRectangle = storageBuffer.GetBufferSize();
         const auto clippedRectangle = storageRectangle.Clamp(requestRectangle);
@@ -444,16 +443,11 @@ CATCH_RETURN();
             return E_INVALIDARG;
         }
 
+        const auto& textBuffer = storageBuffer.GetTextBuffer();
+
         for (til::CoordType y = clippedRectangle.Top(); y <= clippedRectangle.BottomInclusive(); y++)
         {
-            auto it = storageBuffer.GetCellDataAt({ clippedRectangle.Left(), y });
-
-            for (size_t i = 0; i < width; i++)
-            {
-                targetBuffer[totalOffset + i] = gci.AsCharInfo(*it);
-                ++it;
-            }
-
+            textBuffer.GetRowByOffset(y).ExportCharInfos(clippedRectangle.Left(), targetBuffer.subspan(totalOffset, width));
             totalOffset += bufferStride;
         }
 
@@ -545,8 +539,7 @@ CATCH_RETURN();
             const auto charInfos = buffer.subspan(totalOffset, width);
             const til::point target{ clippedRectangle.Left(), y };
 
-            // Make the iterator and write to the target position.
-            storageBuffer.Write(OutputCellIterator(charInfos), target);
+            storageBuffer.GetTextBuffer().WriteCharInfos(target, charInfos);
 
             if (writer)
             {
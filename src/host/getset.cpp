@@ -38,7 +38,12 @@ void ApiRoutines::GetConsoleInputModeImpl(InputBuffer& context, ULONG& mode) noe
 {
     try
     {
-        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        if (gci.GetCSRecursionCount() == 0 && gci.StateCache.TryGet(&ConsoleStateCache::Entries::inputMode, &context, mode))
+        {
+            return;
+        }
+
         LockConsole();
         auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
@@ -51,6 +56,11 @@ void ApiRoutines::GetConsoleInputModeImpl(InputBuffer& context, ULONG& mode) noe
             WI_SetFlagIf(mode, ENABLE_QUICK_EDIT_MODE, WI_IsFlagSet(gci.Flags, CONSOLE_QUICK_EDIT_MODE));
             WI_SetFlagIf(mode, ENABLE_AUTO_POSITION, WI_IsFlagSet(gci.Flags, CONSOLE_AUTO_POSITION));
         }
+
+        if (gci.GetCSRecursionCount() == 1)
+        {
+            gci.StateCache.Publish(&ConsoleStateCache::Entries::inputMode, &context, mode);
+        }
     }
     CATCH_LOG();
 }
@@ -64,10 +74,21 @@ void ApiRoutines::GetConsoleOutputModeImpl(SCREEN_INFORMATION& context, ULONG& m
 {
     try
     {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        if (gci.GetCSRecursionCount() == 0 && gci.StateCache.TryGet(&ConsoleStateCache::Entries::outputMode, &context, mode))
+        {
+            return;
+        }
+
         LockConsole();
         auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
         mode = context.GetActiveBuffer().OutputMode;
+
+        if (gci.GetCSRecursionCount() == 1)
+        {
+            gci.StateCache.Publish(&ConsoleStateCache::Entries::outputMode, &context, mode);
+        }
     }
     CATCH_LOG();
 }
@@ -104,6 +125,14 @@ void ApiRoutines::GetConsoleScreenBufferInfoExImpl(const SCREEN_INFORMATION& con
 {
     try
     {
+        // Polled a lot by progress bars and build tools. Those
+        // shouldn't have to wait for the console lock every time.
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        if (gci.GetCSRecursionCount() == 0 && gci.StateCache.TryGet(&ConsoleStateCache::Entries::screenBufferInfo, &context, data))
+        {
+            return;
+        }
+
         LockConsole();
         auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
@@ -142,6 +171,11 @@ void ApiRoutines::GetConsoleScreenBufferInfoExImpl(const SCREEN_INFORMATION& con
         data.dwCursorPosition = til::unwrap_coord(dwCursorPosition);
         data.srWindow = til::unwrap_small_rect(srWindow);
         data.dwMaximumWindowSize = til::unwrap_coord_size(dwMaximumWindowSize);
+
+        if (gci.GetCSRecursionCount() == 1)
+        {
+            gci.StateCache.Publish(&ConsoleStateCache::Entries::screenBufferInfo, &context, data);
+        }
     }
     CATCH_LOG();
 }
@@ -18,6 +18,7 @@
 
 #include "ApiRoutines.h"
 
+#include "../cascadia/fzf/fzf.h"
 #include "../interactivity/inc/ServiceLocator.hpp"
 
 #pragma hdrstop
@@ -120,7 +121,7 @@ void CommandHistory::_Reset()
             // find free record.  if all records are used, free the lru one.
             if (GetNumberOfCommands() == _maxCommands)
             {
-                _commands.erase(_commands.cbegin());
+                _EraseAt(0);
                 // move LastDisplayed back one in order to stay synced with the
                 // command it referred to before erasing the lru one
                 --LastDisplayed;
@@ -135,6 +136,7 @@ void CommandHistory::_Reset()
             {
                 _commands.emplace_back(newCommand);
             }
+            _IndexInsert(GetNumberOfCommands() - 1);
 
             if (LastDisplayed == -1 ||
                 _commands.at(LastDisplayed).size() != newCommand.size() ||
@@ -211,6 +213,7 @@ std::wstring_view CommandHistory::GetLastCommand() const
 void CommandHistory::Empty()
 {
     _commands.clear();
+    _prefixIndex.clear();
     LastDisplayed = -1;
     WI_SetFlag(Flags, CLE_RESET);
 }
@@ -244,6 +247,7 @@ void CommandHistory::Realloc(const Index commands)
     }
 
     _commands.resize(std::min(_commands.size(), gsl::narrow_cast<size_t>(std::max(0, commands))));
+    _IndexRebuild();
 
     WI_SetFlag(Flags, CLE_RESET);
     LastDisplayed = GetNumberOfCommands() - 1;
@@ -349,6 +353,7 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
         if (!SameApp)
         {
             BestCandidate->_commands.clear();
+            BestCandidate->_prefixIndex.clear();
             BestCandidate->LastDisplayed = -1;
             BestCandidate->_appName = appName;
         }
@@ -412,8 +417,7 @@ std::wstring CommandHistory::Remove(const Index iDel)
         return {};
     }
 
-    const auto str = std::move(_commands.at(iDel));
-    _commands.erase(_commands.begin() + iDel);
+    auto str = _EraseAt(iDel);
 
     if (LastDisplayed == iDel)
     {
@@ -455,25 +459,141 @@ std::wstring CommandHistory::Remove(const Index iDel)
         return true;
     }
 
-    try
+    const auto count = GetNumberOfCommands();
+    if (indexFound < 0 || indexFound >= count)
+    {
+        return false;
+    }
+
+    // Out of all matching commands pick the one that's the closest to indexFound when going backwards
+    // (with wrap-around), because that's the one a linear search via _Prev() would find first.
+    const auto [beg, end] = _IndexRange(givenCommand, WI_IsFlagSet(options, MatchOptions::ExactMatch));
+    auto bestDistance = IndexMax;
+
+    for (auto it = beg; it != end; ++it)
     {
-        for (size_t i = 0; i < _commands.size(); i++)
+        auto distance = indexFound - *it;
+        if (distance < 0)
         {
-            const auto& storedCommand = _commands.at(indexFound);
-            if ((WI_IsFlagClear(options, MatchOptions::ExactMatch) && (givenCommand.size() <= storedCommand.size())) || (givenCommand.size() == storedCommand.size()))
-            {
-                if (til::starts_with(storedCommand, givenCommand))
-                {
-                    return true;
-                }
-            }
+            distance += count;
+        }
+        bestDistance = std::min(bestDistance, distance);
+    }
+
+    if (bestDistance == IndexMax)
+    {
+        return false;
+    }
+
+    indexFound -= bestDistance;
+    if (indexFound < 0)
+    {
+        indexFound += count;
+    }
+    return true;
+}
+
+// Routine Description:
+// - Returns the indices of all commands that match the given fzf-style pattern, oldest first.
+std::vector<CommandHistory::Index> CommandHistory::FindFuzzyMatches(const std::wstring_view pattern) const
+{
+    std::vector<Index> indices(_commands.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    FilterFuzzyMatches(pattern, indices);
+    return indices;
+}
+
+// Routine Description:
+// - Removes all indices from the list whose command doesn't match the given fzf-style pattern.
+//   Extending a pattern can only ever remove matches, so callers can narrow down the result of
+//   a previous search while the user is typing, instead of testing every command again.
+void CommandHistory::FilterFuzzyMatches(const std::wstring_view pattern, std::vector<Index>& indices) const
+{
+    const auto parsed = fzf::matcher::ParsePattern(pattern);
+    if (parsed.terms.empty())
+    {
+        return;
+    }
+
+    std::erase_if(indices, [&](const Index index) {
+        return !fzf::matcher::Match(GetNth(index), parsed).has_value();
+    });
+}
+
+bool CommandHistory::_IndexLess(const Index a, const Index b) const noexcept
+{
+    const auto cmp = til::at(_commands, a).compare(til::at(_commands, b));
+    return cmp < 0 || (cmp == 0 && a < b);
+}
+
+// Routine Description:
+// - Returns the range of _prefixIndex entries whose command starts with (or is equal to, if exact is true) the given prefix.
+std::pair<std::vector<CommandHistory::Index>::const_iterator, std::vector<CommandHistory::Index>::const_iterator> CommandHistory::_IndexRange(const std::wstring_view prefix, const bool exact) const
+{
+    const auto beg = std::lower_bound(_prefixIndex.begin(), _prefixIndex.end(), prefix, [&](const Index index, const std::wstring_view& value) {
+        return std::wstring_view{ til::at(_commands, index) } < value;
+    });
+    const auto end = std::upper_bound(beg, _prefixIndex.end(), prefix, [&](const std::wstring_view& value, const Index index) {
+        std::wstring_view command{ til::at(_commands, index) };
+        if (!exact)
+        {
+            command = command.substr(0, value.size());
+        }
+        return value < command;
+    });
+    return { beg, end };
+}
+
+// Routine Description:
+// - Adds the command at the given index to _prefixIndex. The command must already be stored in _commands.
+void CommandHistory::_IndexInsert(const Index index)
+{
+    const auto it = std::upper_bound(_prefixIndex.begin(), _prefixIndex.end(), index, [this](const Index a, const Index b) {
+        return _IndexLess(a, b);
+    });
+    _prefixIndex.insert(it, index);
+}
 
-            _Prev(indexFound);
+// Routine Description:
+// - Removes the command at the given index from _prefixIndex. The command must still be stored in _commands.
+void CommandHistory::_IndexErase(const Index index)
+{
+    const auto it = std::lower_bound(_prefixIndex.begin(), _prefixIndex.end(), index, [this](const Index a, const Index b) {
+        return _IndexLess(a, b);
+    });
+    if (it != _prefixIndex.end() && *it == index)
+    {
+        _prefixIndex.erase(it);
+    }
+}
+
+void CommandHistory::_IndexRebuild()
+{
+    _prefixIndex.resize(_commands.size());
+    std::iota(_prefixIndex.begin(), _prefixIndex.end(), 0);
+    std::sort(_prefixIndex.begin(), _prefixIndex.end(), [this](const Index a, const Index b) {
+        return _IndexLess(a, b);
+    });
+}
+
+// Routine Description:
+// - Removes the command at the given index from _commands while keeping _prefixIndex in sync.
+// Return Value:
+// - The removed command.
+std::wstring CommandHistory::_EraseAt(const Index index)
+{
+    _IndexErase(index);
+    for (auto& i : _prefixIndex)
+    {
+        if (i > index)
+        {
+            --i;
         }
     }
-    CATCH_LOG();
 
-    return false;
+    auto str = std::move(_commands.at(index));
+    _commands.erase(_commands.begin() + index);
+    return str;
 }
 
 #ifdef UNIT_TESTING
@@ -495,7 +615,11 @@ void CommandHistory::Swap(const Index indexA, const Index indexB)
         indexA >= 0 && indexA < num &&
         indexB >= 0 && indexB < num)
     {
+        _IndexErase(indexA);
+        _IndexErase(indexB);
         std::swap(_commands.at(indexA), _commands.at(indexB));
+        _IndexInsert(indexA);
+        _IndexInsert(indexB);
     }
 }
 
@@ -38,6 +38,8 @@ public:
                              const Index startingIndex,
                              Index& indexFound,
                              const MatchOptions options);
+    std::vector<Index> FindFuzzyMatches(const std::wstring_view pattern) const;
+    void FilterFuzzyMatches(const std::wstring_view pattern, std::vector<Index>& indices) const;
     bool IsAppNameMatch(const std::wstring_view other) const;
 
     [[nodiscard]] HRESULT Add(const std::wstring_view command,
@@ -73,9 +75,21 @@ private:
     void _Dec(Index& ind) const;
     void _Inc(Index& ind) const;
 
+    bool _IndexLess(const Index a, const Index b) const noexcept;
+    std::pair<std::vector<Index>::const_iterator, std::vector<Index>::const_iterator> _IndexRange(const std::wstring_view prefix, const bool exact) const;
+    void _IndexInsert(const Index index);
+    void _IndexErase(const Index index);
+    void _IndexRebuild();
+    std::wstring _EraseAt(const Index index);
+
     // NOTE: In conhost v1 this used to be a circular buffer because removal at the
     // start is a very common operation. It seems this was lost in the C++ refactor.
     std::vector<std::wstring> _commands;
+    // The indices into _commands sorted by the command (ordinal) and then by index.
+    // This allows FindMatchingCommand() to find all commands with a given prefix with a binary
+    // search instead of comparing every single one, which matters for long histories.
+    // It's updated incrementally by every function that modifies _commands.
+    std::vector<Index> _prefixIndex;
     Index _maxCommands = 0;
 
     std::wstring _appName;
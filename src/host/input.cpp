@@ -180,6 +180,70 @@ void HandleGenericKeyEvent(INPUT_RECORD event, const bool generateBreak)
     }
 }
 
+// Routine Description:
+// - returns true if HandleGenericKeyEvent() may do more for this key than just writing it to the InputBuffer.
+static bool RequiresSpecialHandling(const KEY_EVENT_RECORD& keyEvent) noexcept
+{
+    if (!keyEvent.bKeyDown)
+    {
+        return false;
+    }
+
+    const auto vkey = keyEvent.wVirtualKeyCode;
+
+    if (WI_IsAnyFlagSet(keyEvent.dwControlKeyState, CTRL_PRESSED) &&
+        WI_AreAllFlagsClear(keyEvent.dwControlKeyState, ALT_PRESSED))
+    {
+        return vkey == 'C' || vkey == VK_CANCEL || vkey == VK_ESCAPE;
+    }
+
+    return WI_IsAnyFlagSet(keyEvent.dwControlKeyState, ALT_PRESSED) && vkey == VK_ESCAPE;
+}
+
+// Routine Description:
+// - handles many key events at once, as if HandleGenericKeyEvent() was called for each of them
+//   (without generating breaks). Consecutive keys that don't require special handling are
+//   written to the InputBuffer in a single call, which only wakes up waiting readers once.
+void HandleGenericKeyEvents(const std::span<const INPUT_RECORD> events)
+{
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+    const auto writeRun = [&](const std::span<const INPUT_RECORD> run) {
+        if (run.empty())
+        {
+            return;
+        }
+
+        gci.pInputBuffer->Write(run);
+
+        if (gci.HasActiveOutputBuffer())
+        {
+            auto& buffer = gci.GetActiveOutputBuffer();
+
+            if (WI_IsFlagSet(buffer.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING))
+            {
+                for (const auto& event : run)
+                {
+                    buffer.SnapOnInput(event.Event.KeyEvent.wVirtualKeyCode);
+                }
+            }
+        }
+    };
+
+    size_t beg = 0;
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const auto& event = til::at(events, i);
+        if (RequiresSpecialHandling(event.Event.KeyEvent))
+        {
+            writeRun(events.subspan(beg, i - beg));
+            HandleGenericKeyEvent(event, false);
+            beg = i + 1;
+        }
+    }
+    writeRun(events.subspan(beg));
+}
+
 #ifdef DBG
 // set to true with a debugger to temporarily disable focus events getting written to the InputBuffer
 volatile bool DisableFocusEvents = false;
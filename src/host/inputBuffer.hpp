@@ -12,6 +12,146 @@
 
 #include <deque>
 
+// A FIFO of INPUT_RECORDs stored in a single, growable ring buffer.
+// MSVC's std::deque allocates a separate block for every element larger than 8 bytes,
+// which made InputBuffer spend most of its time in the allocator when storing lots of input.
+class InputRecordRing
+{
+public:
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    INPUT_RECORD& operator[](size_t index) noexcept
+    {
+        assert(index < _size);
+        return _data[(_head + index) & (_capacity - 1)];
+    }
+
+    const INPUT_RECORD& operator[](size_t index) const noexcept
+    {
+        assert(index < _size);
+        return _data[(_head + index) & (_capacity - 1)];
+    }
+
+    INPUT_RECORD& front() noexcept
+    {
+        return (*this)[0];
+    }
+
+    INPUT_RECORD& back() noexcept
+    {
+        return (*this)[_size - 1];
+    }
+
+    void push_back(const INPUT_RECORD& record)
+    {
+        _reserve(_size + 1);
+        _data[(_head + _size) & (_capacity - 1)] = record;
+        _size++;
+    }
+
+    void append(const InputRecordRing& other)
+    {
+        _reserve(_size + other._size);
+        for (size_t i = 0; i < other._size; ++i)
+        {
+            _data[(_head + _size + i) & (_capacity - 1)] = other[i];
+        }
+        _size += other._size;
+    }
+
+    void pop_front(size_t count) noexcept
+    {
+        assert(count <= _size);
+        _head = (_head + count) & (_capacity - 1);
+        _size -= count;
+        if (_size == 0)
+        {
+            clear();
+        }
+    }
+
+    // Drops the allocation if it grew unusually large, so that a burst of input doesn't pin the memory forever.
+    void clear() noexcept
+    {
+        _head = 0;
+        _size = 0;
+        if (_capacity > ShrinkThreshold)
+        {
+            _data.reset();
+            _capacity = 0;
+        }
+    }
+
+    // Removes all records for which pred returns true, preserving the order of the remaining ones.
+    template<typename Pred>
+    void erase_if(Pred&& pred)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < _size; ++i)
+        {
+            if (!pred((*this)[i]))
+            {
+                (*this)[kept++] = (*this)[i];
+            }
+        }
+        _size = kept;
+        if (_size == 0)
+        {
+            clear();
+        }
+    }
+
+    void swap(InputRecordRing& other) noexcept
+    {
+        std::swap(_data, other._data);
+        std::swap(_capacity, other._capacity);
+        std::swap(_head, other._head);
+        std::swap(_size, other._size);
+    }
+
+private:
+    static constexpr size_t InitialCapacity = 16;
+    static constexpr size_t ShrinkThreshold = 4096;
+
+    void _reserve(size_t capacity)
+    {
+        if (capacity <= _capacity)
+        {
+            return;
+        }
+
+        // The capacity is kept at a power of 2 so that indices can be wrapped with a mask.
+        auto newCapacity = std::max(InitialCapacity, _capacity * 2);
+        while (newCapacity < capacity)
+        {
+            newCapacity *= 2;
+        }
+
+        auto data = std::make_unique_for_overwrite<INPUT_RECORD[]>(newCapacity);
+        for (size_t i = 0; i < _size; ++i)
+        {
+            data[i] = (*this)[i];
+        }
+
+        _data = std::move(data);
+        _capacity = newCapacity;
+        _head = 0;
+    }
+
+    std::unique_ptr<INPUT_RECORD[]> _data;
+    size_t _capacity = 0;
+    size_t _head = 0;
+    size_t _size = 0;
+};
+
 namespace Microsoft::Console::Render
 {
     class Renderer;
@@ -53,6 +193,9 @@ public:
                                 const bool Unicode,
                                 const bool Stream);
 
+    std::wstring_view PeekText() const noexcept;
+    void ConsumeText(size_t count) noexcept;
+
     size_t Prepend(const std::span<const INPUT_RECORD>& inEvents);
     size_t Write(const INPUT_RECORD& inEvent);
     size_t Write(const std::span<const INPUT_RECORD>& inEvents);
@@ -79,7 +222,17 @@ private:
     std::deque<INPUT_RECORD> _cachedInputEvents;
     ReadingMode _readingMode = ReadingMode::StringA;
 
-    std::deque<INPUT_RECORD> _storage;
+    // Text written via WriteString() is stored in _text instead of as one KEY_EVENT per character.
+    // Each contiguous piece of it is represented in _storage by a single PastedTextEvent record,
+    // whose Event.MenuEvent.dwCommandId holds the number of characters. Since _storage is a FIFO,
+    // these pieces of text are consumed in order starting at _textBegin.
+    // They're turned into KEY_EVENTs only when a client reads INPUT_RECORDs.
+    static constexpr WORD PastedTextEvent = 0x8000;
+
+    InputRecordRing _storage;
+    std::wstring _text;
+    size_t _textBegin = 0;
+    size_t _textSegments = 0;
     INPUT_RECORD _writePartialByteSequence{};
     bool _writePartialByteSequenceAvailable = false;
     Microsoft::Console::VirtualTerminal::TerminalInput _termInput;
@@ -99,6 +252,8 @@ private:
     void _WriteBuffer(const std::span<const INPUT_RECORD>& inRecords, _Out_ size_t& eventsWritten);
     bool _CoalesceEvent(const INPUT_RECORD& inEvent) noexcept;
     void _writeString(const std::wstring_view& text);
+    void _writeText(const std::wstring_view& text);
+    void _trimText() noexcept;
 
 #ifdef UNIT_TESTING
     friend class InputBufferTests;
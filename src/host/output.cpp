@@ -117,6 +117,34 @@ static void _CopyRectangle(SCREEN_INFORMATION& screenInfo,
     }
 }
 
+// Routine Description:
+// - Calls func(info, index) for the CHAR_INFO of each of the amountToRead cells starting at coordRead,
+//   continuing in the following rows up to the end of the buffer. Rows are exported in bulk via ROW::ExportCharInfos.
+// Arguments:
+// - screenInfo - reference to screen buffer information.
+// - coordRead - Screen buffer coordinate to begin reading from. Must be in bounds.
+// - amountToRead - the number of cells to read
+// - func - the callback
+template<typename Func>
+static void _ForEachCharInfo(const SCREEN_INFORMATION& screenInfo, const til::point coordRead, const size_t amountToRead, Func&& func)
+{
+    const auto& textBuffer = screenInfo.GetTextBuffer();
+    const auto size = textBuffer.GetSize();
+    til::small_vector<CHAR_INFO, 256> infos;
+    size_t amountRead = 0;
+
+    for (auto pos = coordRead; amountRead < amountToRead && pos.y < size.Height(); pos = { 0, pos.y + 1 })
+    {
+        infos.resize(std::min<size_t>(amountToRead - amountRead, size.Width() - pos.x));
+        textBuffer.GetRowByOffset(pos.y).ExportCharInfos(pos.x, { infos.data(), infos.size() });
+
+        for (const auto& info : infos)
+        {
+            func(info, amountRead++);
+        }
+    }
+}
+
 // Routine Description:
 // - This routine reads a sequence of attributes from the screen buffer.
 // Arguments:
@@ -141,35 +169,24 @@ std::vector<WORD> ReadOutputAttributes(const SCREEN_INFORMATION& screenInfo,
         return {};
     }
 
-    // Get iterator to the position we should start reading at.
-    auto it = screenInfo.GetCellDataAt(coordRead);
-    // Count up the number of cells we've attempted to read.
-    ULONG amountRead = 0;
     // Prepare the return value string.
     std::vector<WORD> retVal;
     // Reserve the number of cells. If we have >U+FFFF, it will auto-grow later and that's OK.
     retVal.reserve(amountToRead);
 
-    // While we haven't read enough cells yet and the iterator is still valid (hasn't reached end of buffer)
-    while (amountRead < amountToRead && it)
-    {
-        const auto legacyAttributes = it->TextAttr().GetLegacyAttributes();
+    _ForEachCharInfo(screenInfo, coordRead, amountToRead, [&](const CHAR_INFO& info, const size_t amountRead) {
+        auto attributes = info.Attributes;
 
         // If the first thing we read is trailing, pad with a space.
         // OR If the last thing we read is leading, pad with a space.
-        if ((amountRead == 0 && it->DbcsAttr() == DbcsAttribute::Trailing) ||
-            (amountRead == (amountToRead - 1) && it->DbcsAttr() == DbcsAttribute::Leading))
+        if ((amountRead == 0 && WI_IsFlagSet(attributes, COMMON_LVB_TRAILING_BYTE)) ||
+            (amountRead == (amountToRead - 1) && WI_IsFlagSet(attributes, COMMON_LVB_LEADING_BYTE)))
         {
-            retVal.push_back(legacyAttributes);
-        }
-        else
-        {
-            retVal.push_back(legacyAttributes | GeneratePublicApiAttributeFormat(it->DbcsAttr()));
+            WI_ClearAllFlags(attributes, COMMON_LVB_SBCSDBCS);
         }
 
-        amountRead++;
-        it++;
-    }
+        retVal.push_back(attributes);
+    });
 
     return retVal;
 }
@@ -198,43 +215,25 @@ std::wstring ReadOutputStringW(const SCREEN_INFORMATION& screenInfo,
         return {};
     }
 
-    // Get iterator to the position we should start reading at.
-    auto it = screenInfo.GetCellDataAt(coordRead);
-
-    // Count up the number of cells we've attempted to read.
-    ULONG amountRead = 0;
-
     // Prepare the return value string.
     std::wstring retVal;
     retVal.reserve(amountToRead); // Reserve the number of cells. If we have >U+FFFF, it will auto-grow later and that's OK.
 
-    // While we haven't read enough cells yet and the iterator is still valid (hasn't reached end of buffer)
-    while (amountRead < amountToRead && it)
-    {
+    _ForEachCharInfo(screenInfo, coordRead, amountToRead, [&](const CHAR_INFO& info, const size_t amountRead) {
         // If the first thing we read is trailing, pad with a space.
         // OR If the last thing we read is leading, pad with a space.
-        if ((amountRead == 0 && it->DbcsAttr() == DbcsAttribute::Trailing) ||
-            (amountRead == (amountToRead - 1) && it->DbcsAttr() == DbcsAttribute::Leading))
+        if ((amountRead == 0 && WI_IsFlagSet(info.Attributes, COMMON_LVB_TRAILING_BYTE)) ||
+            (amountRead == (amountToRead - 1) && WI_IsFlagSet(info.Attributes, COMMON_LVB_LEADING_BYTE)))
         {
             retVal += UNICODE_SPACE;
         }
-        else
+        // Otherwise, add anything that isn't a trailing cell. (Trailings are duplicate copies of the leading.)
+        // Glyphs longer than a single wchar_t have already been replaced with U+FFFD.
+        else if (WI_IsFlagClear(info.Attributes, COMMON_LVB_TRAILING_BYTE))
         {
-            // Otherwise, add anything that isn't a trailing cell. (Trailings are duplicate copies of the leading.)
-            if (it->DbcsAttr() != DbcsAttribute::Trailing)
-            {
-                auto chars = it->Chars();
-                if (chars.size() > 1)
-                {
-                    chars = { &UNICODE_REPLACEMENT, 1 };
-                }
-                retVal += chars;
-            }
+            retVal += info.Char.UnicodeChar;
         }
-
-        amountRead++;
-        it++;
-    }
+    });
 
     return retVal;
 }
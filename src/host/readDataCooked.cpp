@@ -917,22 +917,49 @@ void COOKED_READ_DATA::_redisplay()
     til::point cursorPositionFinal;
     til::point pagerPromptEnd;
     std::vector<Line> lines;
+    std::vector<size_t> lineStarts;
+    size_t layoutValidEnd = 0;
+    size_t skippedLines = 0;
 
     // FYI: This loop does not loop. It exists because goto is considered evil
     // and if MSVC says that then that must be true.
     for (;;)
     {
-        cursorPositionFinal = { originInViewport.x, 0 };
+        layoutValidEnd = std::min(_bufferDirtyBeg, _bufferCursor);
+
+        // The lines in front of the dirty part of the buffer look exactly like they did during the last call.
+        // We skip laying them out and resume at the start of the last one of them. They're added to `lines`
+        // as clean, empty placeholders and only get their text if they get scrolled into view further below.
+        // This keeps the cost of typing at the end of a very long prompt independent of its length.
+        skippedLines = 0;
+        if (_layoutOriginX == originInViewport.x && _layoutWidth == size.width)
+        {
+            const auto validEnd = std::min(layoutValidEnd, _layoutValidEnd);
+            const auto it = std::lower_bound(_layoutLineStarts.begin(), _layoutLineStarts.end(), validEnd);
+            skippedLines = gsl::narrow_cast<size_t>(std::max<ptrdiff_t>(0, it - _layoutLineStarts.begin() - 1));
+        }
+
+        const auto layoutBeg = skippedLines ? til::at(_layoutLineStarts, skippedLines) : 0;
+        const auto layoutColumn = skippedLines ? 0 : originInViewport.x;
+
+        for (size_t i = 0; i < skippedLines; ++i)
+        {
+            lines.emplace_back(std::wstring{}, 0, size.width, size.width);
+        }
+        lineStarts.assign(_layoutLineStarts.begin(), _layoutLineStarts.begin() + skippedLines);
+
+        cursorPositionFinal = { layoutColumn, gsl::narrow_cast<til::CoordType>(skippedLines) };
 
         // Construct the first line manually so that it starts at the correct horizontal position.
-        LayoutResult res{ .column = cursorPositionFinal.x };
-        lines.emplace_back(std::wstring{}, 0, cursorPositionFinal.x, cursorPositionFinal.x);
+        LayoutResult res{ .column = layoutColumn };
+        lines.emplace_back(std::wstring{}, 0, layoutColumn, layoutColumn);
+        lineStarts.emplace_back(layoutBeg);
 
         // Split the buffer into 3 segments, so that we can find the row/column coordinates of
         // the cursor within the buffer, as well as the start of the dirty parts of the buffer.
         const size_t offsets[]{
-            0,
-            std::min(_bufferDirtyBeg, _bufferCursor),
+            layoutBeg,
+            layoutValidEnd,
             std::max(_bufferDirtyBeg, _bufferCursor),
             npos,
         };
@@ -953,6 +980,7 @@ void COOKED_READ_DATA::_redisplay()
                 if (res.column >= size.width)
                 {
                     lines.emplace_back();
+                    lineStarts.emplace_back(offsets[i] + beg);
                 }
 
                 auto& line = lines.back();
@@ -1085,6 +1113,7 @@ void COOKED_READ_DATA::_redisplay()
         if (gsl::narrow_cast<til::CoordType>(lines.size()) > size.height && originInViewportFinal.x != 0)
         {
             lines.clear();
+            lineStarts.clear();
             _bufferDirtyBeg = 0;
             originInViewport.x = 0;
             originInViewportFinal = {};
@@ -1154,6 +1183,17 @@ void COOKED_READ_DATA::_redisplay()
         _popupOpened = popupOpened;
     }
 
+    // Lays out the text of a line that was skipped above, because it didn't change.
+    const auto layoutSkippedLine = [&](const til::CoordType index) {
+        auto& line = lines.at(index);
+        if (gsl::narrow_cast<size_t>(index) < skippedLines && line.text.empty())
+        {
+            _layoutLine(line.text, _buffer, lineStarts.at(index), index == 0 ? originInViewport.x : 0, size.width);
+            line.dirtyBegOffset = line.text.size();
+        }
+        return &line;
+    };
+
     // If we have so much text that it doesn't fit into the viewport (origin == {0,0}),
     // then we can scroll the existing contents of the pager and only write what got newly uncovered.
     //
@@ -1189,19 +1229,19 @@ void COOKED_READ_DATA::_redisplay()
         {
             // We may not be scrolling with VT, because we're scrolling by more rows than the pagerHeight.
             // Since no one is now clearing the scrolled in rows for us anymore, we need to do it ourselves.
-            auto& lastLine = lines.at(pagerHeight - 1 + pagerContentTop);
-            if (lastLine.columns < size.width)
+            const auto lastLine = layoutSkippedLine(pagerHeight - 1 + pagerContentTop);
+            if (lastLine->columns < size.width)
             {
-                lastLine.text.append(L"\x1b[K");
+                lastLine->text.append(L"\x1b[K");
             }
         }
 
         // Mark each row that has been uncovered by the scroll as dirty.
         for (auto i = beg; i < end; i++)
         {
-            auto& line = lines.at(i + pagerContentTop);
-            line.dirtyBegOffset = 0;
-            line.dirtyBegColumn = 0;
+            const auto line = layoutSkippedLine(i + pagerContentTop);
+            line->dirtyBegOffset = 0;
+            line->dirtyBegColumn = 0;
         }
     }
 
@@ -1290,6 +1330,10 @@ void COOKED_READ_DATA::_redisplay()
     _pagerPromptEnd = pagerPromptEnd;
     _pagerContentTop = pagerContentTop;
     _pagerHeight = pagerHeight;
+    _layoutLineStarts = std::move(lineStarts);
+    _layoutValidEnd = layoutValidEnd;
+    _layoutOriginX = originInViewport.x;
+    _layoutWidth = size.width;
     _bufferDirtyBeg = _buffer.size();
     _dirty = false;
 }
@@ -1418,6 +1462,8 @@ try
         popup.commandList.top = -1;
         popup.commandList.height = 10;
         popup.commandList.selected = _history->LastDisplayed;
+        _commandListFilter.clear();
+        _commandListMatches.clear();
         break;
     default:
         break;
@@ -1557,12 +1603,35 @@ void COOKED_READ_DATA::_popupHandleCommandListInput(Popup& popup, const wchar_t
 
     if (wch == UNICODE_CARRIAGERETURN)
     {
-        _replace(_history->RetrieveNth(cl.selected));
+        if (_commandListCount() > 0)
+        {
+            _replace(_history->RetrieveNth(_commandListAt(cl.selected)));
+        }
         _popupsDone();
         _handleChar(UNICODE_CARRIAGERETURN, modifiers);
         return;
     }
 
+    // Any other text filters the list down to the commands that fuzzy-match it.
+    if (!vkey)
+    {
+        if (wch == UNICODE_BACKSPACE)
+        {
+            if (_commandListFilter.empty())
+            {
+                return;
+            }
+            _commandListFilter.pop_back();
+            _commandListFilterUpdate(popup, false);
+        }
+        else if (wch >= L' ')
+        {
+            _commandListFilter.push_back(wch);
+            _commandListFilterUpdate(popup, true);
+        }
+        return;
+    }
+
     switch (vkey)
     {
     case VK_ESCAPE:
@@ -1572,20 +1641,33 @@ void COOKED_READ_DATA::_popupHandleCommandListInput(Popup& popup, const wchar_t
         _popupPush(PopupKind::CommandNumber);
         return;
     case VK_DELETE:
-        _history->Remove(cl.selected);
+        if (_commandListCount() <= 0)
+        {
+            return;
+        }
+        _history->Remove(_commandListAt(cl.selected));
         if (_history->GetNumberOfCommands() <= 0)
         {
             _popupsDone();
             return;
         }
+        if (!_commandListFilter.empty())
+        {
+            // The indices of all commands after the removed one have changed.
+            _commandListMatches = _history->FindFuzzyMatches(_commandListFilter);
+        }
         break;
     case VK_LEFT:
     case VK_RIGHT:
-        _replace(_history->RetrieveNth(cl.selected));
+        if (_commandListCount() > 0)
+        {
+            _replace(_history->RetrieveNth(_commandListAt(cl.selected)));
+        }
         _popupsDone();
         return;
     case VK_UP:
-        if (WI_IsFlagSet(modifiers, SHIFT_PRESSED))
+        // Reordering commands only makes sense when all of them are shown.
+        if (WI_IsFlagSet(modifiers, SHIFT_PRESSED) && _commandListFilter.empty())
         {
             _history->Swap(cl.selected, cl.selected - 1);
         }
@@ -1593,7 +1675,7 @@ void COOKED_READ_DATA::_popupHandleCommandListInput(Popup& popup, const wchar_t
         cl.selected--;
         break;
     case VK_DOWN:
-        if (WI_IsFlagSet(modifiers, SHIFT_PRESSED))
+        if (WI_IsFlagSet(modifiers, SHIFT_PRESSED) && _commandListFilter.empty())
         {
             _history->Swap(cl.selected, cl.selected + 1);
         }
@@ -1622,6 +1704,53 @@ void COOKED_READ_DATA::_popupHandleCommandListInput(Popup& popup, const wchar_t
     _dirty = true;
 }
 
+// Updates _commandListMatches after _commandListFilter changed and selects the most recent match.
+// If `narrow` is true, the filter was extended, which allows us to only test the previous matches.
+void COOKED_READ_DATA::_commandListFilterUpdate(Popup& popup, const bool narrow)
+{
+    if (_commandListFilter.empty())
+    {
+        _commandListMatches.clear();
+    }
+    else if (narrow && _commandListFilter.size() > 1)
+    {
+        _history->FilterFuzzyMatches(_commandListFilter, _commandListMatches);
+    }
+    else
+    {
+        _commandListMatches = _history->FindFuzzyMatches(_commandListFilter);
+    }
+
+    // _popupDrawCommandList() clamps all values to valid ranges in `cl`.
+    popup.commandList.selected = INT_MAX;
+    popup.commandList.top = -1;
+    _dirty = true;
+}
+
+// Returns the number of rows in the F7 popup.
+CommandHistory::Index COOKED_READ_DATA::_commandListCount() const
+{
+    if (_commandListFilter.empty())
+    {
+        return _history->GetNumberOfCommands();
+    }
+    return gsl::narrow_cast<CommandHistory::Index>(_commandListMatches.size());
+}
+
+// Returns the command history index for the given row in the F7 popup, or -1 if it's out of range.
+CommandHistory::Index COOKED_READ_DATA::_commandListAt(const CommandHistory::Index row) const
+{
+    if (_commandListFilter.empty())
+    {
+        return row;
+    }
+    if (row < 0 || row >= _commandListCount())
+    {
+        return -1;
+    }
+    return til::at(_commandListMatches, row);
+}
+
 void COOKED_READ_DATA::_popupDrawPrompt(std::vector<Line>& lines, const til::CoordType width, const UINT id, const std::wstring_view& prefix, const std::wstring_view& suffix) const
 {
     std::wstring str;
@@ -1638,20 +1767,42 @@ void COOKED_READ_DATA::_popupDrawPrompt(std::vector<Line>& lines, const til::Coo
     lines.emplace_back(std::move(line), 0, 0, res.column);
 }
 
+// Draws the text the F7 popup is filtered by.
+void COOKED_READ_DATA::_popupDrawFilter(std::vector<Line>& lines, const til::CoordType width, const std::wstring_view& prefix) const
+{
+    std::wstring str;
+    str.append(prefix);
+    str.append(_commandListFilter);
+
+    std::wstring line;
+    line.append(L"\x1b[#{\x1b[K");
+    _appendPopupAttr(line);
+    const auto res = _layoutLine(line, str, 0, 0, width);
+    line.append(L"\x1b[m\x1b[#}");
+
+    lines.emplace_back(std::move(line), 0, 0, res.column);
+}
+
 void COOKED_READ_DATA::_popupDrawCommandList(std::vector<Line>& lines, const til::size size, Popup& popup) const
 {
     assert(popup.kind == PopupKind::CommandList);
 
     auto& cl = popup.commandList;
-    const auto historySize = _history->GetNumberOfCommands();
-    const auto indexWidth = gsl::narrow_cast<til::CoordType>(fmt::formatted_size(FMT_COMPILE(L"{}"), historySize));
+    const auto historySize = _commandListCount();
+    const auto indexWidth = gsl::narrow_cast<til::CoordType>(fmt::formatted_size(FMT_COMPILE(L"{}"), _history->GetNumberOfCommands()));
+    const auto stackedCommandNumberPopup = _popups.size() == 2 && _popups.back().kind == PopupKind::CommandNumber;
 
     // The popup is half the height of the viewport, but at least 1 and at most 20 lines.
     // Unless of course the history size is less than that. We also reserve 1 additional line
-    // of space in case the user presses F9 which will open the "Enter command number:" popup.
+    // of space in case the user presses F9 which will open the "Enter command number:" popup,
+    // which is also where the filter text is shown.
     const auto height = std::min(historySize, std::min(size.height / 2 - 1, 20));
     if (height < 1)
     {
+        if (!_commandListFilter.empty() && !stackedCommandNumberPopup)
+        {
+            _popupDrawFilter(lines, size.width - 1, L"");
+        }
         return;
     }
 
@@ -1680,13 +1831,13 @@ void COOKED_READ_DATA::_popupDrawCommandList(std::vector<Line>& lines, const til
     const auto historyMax = historySize - 1;
     const auto trackPositionMax = height - 3;
     const auto trackPosition = historyMax <= 0 ? 0 : 1 + (trackPositionMax * cl.selected + historyMax / 2) / historyMax;
-    const auto stackedCommandNumberPopup = _popups.size() == 2 && _popups.back().kind == PopupKind::CommandNumber;
 
     for (til::CoordType off = 0; off < height; ++off)
     {
-        const auto index = cl.top + off;
+        const auto row = cl.top + off;
+        const auto index = _commandListAt(row);
         const auto str = _history->GetNth(index);
-        const auto selected = index == cl.selected && !stackedCommandNumberPopup;
+        const auto selected = row == cl.selected && !stackedCommandNumberPopup;
 
         std::wstring line;
         line.append(L"\x1b[#{\x1b[K");
@@ -1737,6 +1888,10 @@ void COOKED_READ_DATA::_popupDrawCommandList(std::vector<Line>& lines, const til
         const std::wstring_view suffix{ _popups.back().commandNumber.buffer.data(), CommandNumberMaxInputLength };
         _popupDrawPrompt(lines, size.width - 1, ID_CONSOLE_MSGCMDLINEF9, L"╰", suffix);
     }
+    else if (!_commandListFilter.empty())
+    {
+        _popupDrawFilter(lines, size.width - 1, L"╰");
+    }
     else
     {
         // Remove the \r\n we added to the last line, as we don't want to have an empty line at the end.
@@ -98,11 +98,13 @@ private:
             {
                 // The previous height of the popup.
                 til::CoordType height;
-                // Command history index of the first row we draw in the popup.
+                // Index of the first row we draw in the popup.
                 // A value of -1 means it hasn't been initialized yet.
                 CommandHistory::Index top;
-                // Command history index of the currently selected row.
+                // Index of the currently selected row.
                 CommandHistory::Index selected;
+                // Rows are command history indices, unless the list is filtered,
+                // in which case they're indices into _commandListMatches.
             } commandList;
         };
     };
@@ -148,7 +150,11 @@ private:
     void _popupHandleCommandListInput(Popup& popup, wchar_t wch, uint16_t vkey, DWORD modifiers);
     void _popupHandleInput(wchar_t wch, uint16_t vkey, DWORD keyState);
     void _popupDrawPrompt(std::vector<Line>& lines, const til::CoordType width, UINT id, const std::wstring_view& prefix, const std::wstring_view& suffix) const;
+    void _popupDrawFilter(std::vector<Line>& lines, til::CoordType width, const std::wstring_view& prefix) const;
     void _popupDrawCommandList(std::vector<Line>& lines, til::size size, Popup& popup) const;
+    void _commandListFilterUpdate(Popup& popup, bool narrow);
+    CommandHistory::Index _commandListCount() const;
+    CommandHistory::Index _commandListAt(CommandHistory::Index row) const;
 
     SCREEN_INFORMATION& _screenInfo;
     std::span<char> _userBuffer;
@@ -177,7 +183,21 @@ private:
     til::CoordType _pagerContentTop = 0;
     // Contains the viewport height for which it previously was drawn for.
     til::CoordType _pagerHeight = 0;
+    // The _buffer offsets at which each line started during the last _redisplay(). Lines that start
+    // in front of _layoutValidEnd are unaffected by later edits past that point, which allows the next
+    // _redisplay() to skip laying them out, as long as the origin column and width are still the same.
+    std::vector<size_t> _layoutLineStarts;
+    size_t _layoutValidEnd = 0;
+    til::CoordType _layoutOriginX = -1;
+    til::CoordType _layoutWidth = -1;
 
     std::vector<Popup> _popups;
     bool _popupOpened = false;
+    // The text typed into the F7 popup and the command history indices that fuzzy-match it.
+    std::wstring _commandListFilter;
+    std::vector<CommandHistory::Index> _commandListMatches;
+
+#ifdef UNIT_TESTING
+    friend class CookedReadTests;
+#endif
 };
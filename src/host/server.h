@@ -16,6 +16,7 @@ Revision History:
 
 #pragma once
 
+#include "ConsoleStateCache.hpp"
 #include "IIoProvider.hpp"
 #include "readDataCooked.hpp"
 #include "settings.hpp"
@@ -149,6 +150,9 @@ public:
 
     RenderData renderData;
 
+    // Invalidated whenever the console lock is released. See ConsoleStateCache.hpp.
+    ConsoleStateCache StateCache;
+
 private:
     til::recursive_ticket_lock _lock;
 
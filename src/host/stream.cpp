@@ -417,6 +417,25 @@ try
 
     while (writer.size() >= charSize)
     {
+        // Pasted text can be copied over in bulk, without turning it into INPUT_RECORDs first.
+        if (auto text = inputBuffer.PeekText(); !text.empty())
+        {
+            // GetChar() drops linefeeds unless we're in VT input mode. Leave those to it.
+            if (WI_IsFlagClear(inputBuffer.InputMode, ENABLE_VIRTUAL_TERMINAL_INPUT))
+            {
+                text = text.substr(0, text.find(UNICODE_LINEFEED));
+            }
+
+            if (!text.empty())
+            {
+                const auto length = text.size();
+                inputBuffer.Consume(unicode, text, writer);
+                inputBuffer.ConsumeText(length - text.size());
+                noDataReadYet = false;
+                continue;
+            }
+        }
+
         wchar_t wch;
         // We don't need to wait for input if `ConsumeCached` read something already, which is
         // indicated by the writer having been advanced (= it's shorter than the original buffer).
@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+
+#include "CommonState.hpp"
+
+#include "ApiRoutines.h"
+#include "../../server/ApiDispatchers.h"
+#include "../../server/DeviceComm.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using Microsoft::Console::Interactivity::ServiceLocator;
+
+// Serves the input payload of a single message, like the console driver would.
+class MockDeviceComm : public IDeviceComm
+{
+public:
+    explicit MockDeviceComm(std::wstring_view payload) :
+        _payload{ payload }
+    {
+    }
+
+    [[nodiscard]] HRESULT SetServerInformation(CD_IO_SERVER_INFORMATION* const) const override { return E_NOTIMPL; }
+    [[nodiscard]] HRESULT ReadIo(PCONSOLE_API_MSG const, CONSOLE_API_MSG* const) const override { return E_NOTIMPL; }
+    [[nodiscard]] HRESULT CompleteIo(CD_IO_COMPLETE* const) const override { return E_NOTIMPL; }
+
+    [[nodiscard]] HRESULT ReadInput(CD_IO_OPERATION* const pIoOperation) const override
+    {
+        const auto bytes = std::as_bytes(std::span{ _payload });
+        const auto offset = pIoOperation->Buffer.Offset;
+        const auto size = pIoOperation->Buffer.Size;
+        RETURN_HR_IF(E_INVALIDARG, offset > bytes.size() || size > bytes.size() - offset);
+
+        memcpy(pIoOperation->Buffer.Data, bytes.data() + offset, size);
+        reads++;
+        readsWhileLocked += ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked() ? 1 : 0;
+        return S_OK;
+    }
+
+    [[nodiscard]] HRESULT WriteOutput(CD_IO_OPERATION* const) const override { return E_NOTIMPL; }
+    [[nodiscard]] HRESULT AllowUIAccess() const override { return E_NOTIMPL; }
+    [[nodiscard]] ULONG_PTR PutHandle(const void* handle) override { return reinterpret_cast<ULONG_PTR>(handle); }
+    [[nodiscard]] void* GetHandle(ULONG_PTR handle) const override { return reinterpret_cast<void*>(handle); }
+    [[nodiscard]] HRESULT GetServerHandle(HANDLE* const) const override { return E_NOTIMPL; }
+
+    mutable size_t reads = 0;
+    mutable size_t readsWhileLocked = 0;
+
+private:
+    std::wstring_view _payload;
+};
+
+// Records the strings passed to WriteConsoleWImpl() instead of writing them.
+// Writes at most maxWrite characters at a time, like a short write would.
+class RecordingApiRoutines : public ApiRoutines
+{
+public:
+    [[nodiscard]] HRESULT WriteConsoleWImpl(IConsoleOutputObject&, const std::wstring_view buffer, size_t& read, CONSOLE_API_MSG*) noexcept override
+    try
+    {
+        const auto written = buffer.substr(0, maxWrite);
+        writes.emplace_back(written);
+        writesWhileUnlocked += ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked() ? 0 : 1;
+        read = written.size();
+        return S_OK;
+    }
+    CATCH_RETURN()
+
+    size_t maxWrite = SIZE_MAX;
+    std::vector<std::wstring> writes;
+    size_t writesWhileUnlocked = 0;
+};
+
+class ApiDispatchersTests
+{
+    TEST_CLASS(ApiDispatchersTests);
+
+    std::unique_ptr<CommonState> m_state;
+    std::unique_ptr<ConsoleHandleData> m_handle;
+
+    TEST_METHOD_SETUP(MethodSetup)
+    {
+        m_state = std::make_unique<CommonState>();
+        m_state->PrepareGlobalInputBuffer();
+        m_state->PrepareGlobalScreenBuffer();
+
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        return SUCCEEDED(gci.GetActiveOutputBuffer().AllocateIoHandle(ConsoleHandleData::HandleType::Output,
+                                                                      GENERIC_WRITE,
+                                                                      FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                                                      m_handle));
+    }
+
+    TEST_METHOD_CLEANUP(MethodCleanup)
+    {
+        m_handle.reset();
+        m_state->CleanupGlobalScreenBuffer();
+        m_state->CleanupGlobalInputBuffer();
+        m_state.reset();
+        return true;
+    }
+
+    // Dispatches a WriteConsoleW call with the given payload and returns the strings that got written.
+    std::vector<std::wstring> writeConsoleW(const std::wstring_view payload, size_t& reads, const size_t maxWrite = SIZE_MAX)
+    {
+        MockDeviceComm comm{ payload };
+        RecordingApiRoutines routines;
+        routines.maxWrite = maxWrite;
+
+        CONSOLE_API_MSG m;
+        m._pDeviceComm = &comm;
+        m._pApiRoutines = &routines;
+        m.Descriptor.Object = reinterpret_cast<ULONG_PTR>(m_handle.get());
+        m.Descriptor.InputSize = gsl::narrow<ULONG>(payload.size() * sizeof(wchar_t));
+        m.State.ReadOffset = 0;
+        m.u.consoleMsgL1.WriteConsole.Unicode = TRUE;
+
+        BOOL replyPending = FALSE;
+        VERIFY_SUCCEEDED(ApiDispatchers::ServerWriteConsole(&m, &replyPending));
+        VERIFY_IS_FALSE(replyPending);
+        VERIFY_ARE_EQUAL(m.Descriptor.InputSize, m.u.consoleMsgL1.WriteConsole.NumBytes);
+
+        Log::Comment(L"The console lock is held while writing, but not while reading from the driver.");
+        VERIFY_ARE_EQUAL(0u, comm.readsWhileLocked);
+        VERIFY_ARE_EQUAL(0u, routines.writesWhileUnlocked);
+
+        reads = comm.reads;
+        return std::move(routines.writes);
+    }
+
+    TEST_METHOD(LargeWriteConsoleWIsSliced)
+    {
+        std::wstring payload;
+        for (size_t i = 0; i < 80 * 1024; ++i)
+        {
+            payload.push_back(static_cast<wchar_t>(L'a' + i % 26));
+        }
+
+        size_t reads = 0;
+        const auto writes = writeConsoleW(payload, reads);
+
+        Log::Comment(L"160 KiB are read and written in 64 KiB slices without going through the message's input buffer.");
+        VERIFY_ARE_EQUAL(3u, reads);
+        VERIFY_ARE_EQUAL(3u, writes.size());
+        VERIFY_ARE_EQUAL(32u * 1024, writes[0].size());
+        VERIFY_ARE_EQUAL(32u * 1024, writes[1].size());
+        VERIFY_ARE_EQUAL(16u * 1024, writes[2].size());
+        VERIFY_IS_TRUE(payload == writes[0] + writes[1] + writes[2]);
+    }
+
+    TEST_METHOD(SurrogatePairIsNotSplitAcrossSlices)
+    {
+        // The leading surrogate is the last character of the first 64 KiB slice.
+        std::wstring payload(32 * 1024 - 1, L'a');
+        payload.append(L"\U0001F600");
+        payload.append(40000, L'b');
+
+        size_t reads = 0;
+        const auto writes = writeConsoleW(payload, reads);
+
+        Log::Comment(L"It's held back and written together with its trailing half in the next slice.");
+        VERIFY_ARE_EQUAL(3u, writes.size());
+        VERIFY_ARE_EQUAL(32u * 1024 - 1, writes[0].size());
+        VERIFY_IS_FALSE(til::is_leading_surrogate(writes[0].back()));
+        VERIFY_IS_TRUE(writes[1].starts_with(L"\U0001F600"));
+        VERIFY_IS_TRUE(payload == writes[0] + writes[1] + writes[2]);
+    }
+
+    TEST_METHOD(ShortWritesAreContinued)
+    {
+        std::wstring payload;
+        for (size_t i = 0; i < 40 * 1024; ++i)
+        {
+            payload.push_back(static_cast<wchar_t>(L'a' + i % 26));
+        }
+
+        size_t reads = 0;
+        const auto writes = writeConsoleW(payload, reads, 10000);
+
+        Log::Comment(L"Writing the first 32K character slice takes 4 calls. The reply counts all of them.");
+        VERIFY_ARE_EQUAL(2u, reads);
+        VERIFY_ARE_EQUAL(5u, writes.size());
+        VERIFY_ARE_EQUAL(10000u, writes[0].size());
+        VERIFY_ARE_EQUAL(2768u, writes[3].size());
+        VERIFY_ARE_EQUAL(8192u, writes[4].size());
+
+        std::wstring written;
+        for (const auto& w : writes)
+        {
+            written.append(w);
+        }
+        VERIFY_IS_TRUE(payload == written);
+    }
+};
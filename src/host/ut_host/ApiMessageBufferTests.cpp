@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+
+#include "../../server/ApiMessageBuffer.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class ApiMessageBufferTests
+{
+    TEST_CLASS(ApiMessageBufferTests);
+
+    TEST_METHOD(SmallPayloadsAreStoredInline)
+    {
+        ApiMessageBuffer buffer;
+        buffer.resize(ApiMessageBuffer::InlineSize);
+
+        const auto data = buffer.data();
+        const auto self = reinterpret_cast<BYTE*>(&buffer);
+        VERIFY_IS_TRUE(data >= self && data + ApiMessageBuffer::InlineSize <= self + sizeof(buffer));
+        VERIFY_ARE_EQUAL(ApiMessageBuffer::InlineSize, buffer.size());
+    }
+
+    TEST_METHOD(BlocksAreReusedPerSizeClass)
+    {
+        // The pool is process-wide. Take the 8 KiB blocks other tests might have left
+        // in there, so that the one released below is guaranteed to be retained.
+        std::array<ApiMessageBuffer, 2> drain;
+        for (auto& b : drain)
+        {
+            b.resize(8 * 1024);
+        }
+
+        ApiMessageBuffer first;
+        first.resize(5000);
+        const auto block = first.data();
+
+        Log::Comment(L"Shrinking keeps the block.");
+        first.resize(100);
+        VERIFY_ARE_EQUAL(block, first.data());
+        VERIFY_ARE_EQUAL(100u, first.size());
+
+        Log::Comment(L"A released block is handed out again for any size of the same size class (8 KiB).");
+        first.clear();
+        VERIFY_ARE_EQUAL(0u, first.size());
+
+        ApiMessageBuffer second;
+        second.resize(8 * 1024);
+        VERIFY_ARE_EQUAL(block, second.data());
+
+        Log::Comment(L"...but not for a different one.");
+        second.clear();
+        ApiMessageBuffer third;
+        third.resize(8 * 1024 + 1);
+        VERIFY_ARE_NOT_EQUAL(block, third.data());
+
+        ApiMessageBuffer fourth;
+        fourth.resize(8 * 1024);
+        VERIFY_ARE_EQUAL(block, fourth.data());
+    }
+
+    TEST_METHOD(LargePayloadsAreNotPooled)
+    {
+        ApiMessageBuffer buffer;
+        buffer.resize(ApiMessageBuffer::MaxPooledSize + 1);
+        VERIFY_ARE_EQUAL(ApiMessageBuffer::MaxPooledSize + 1, buffer.size());
+
+        // The block is freed and the buffer falls back to its inline storage.
+        buffer.clear();
+        buffer.resize(1);
+        const auto self = reinterpret_cast<BYTE*>(&buffer);
+        VERIFY_IS_TRUE(buffer.data() >= self && buffer.data() < self + sizeof(buffer));
+    }
+
+    TEST_METHOD(CopyCopiesContents)
+    {
+        ApiMessageBuffer buffer;
+        buffer.resize(10000);
+        for (size_t i = 0; i < buffer.size(); ++i)
+        {
+            buffer.data()[i] = static_cast<BYTE>(i);
+        }
+
+        ApiMessageBuffer copy{ buffer };
+        VERIFY_ARE_NOT_EQUAL(buffer.data(), copy.data());
+        VERIFY_ARE_EQUAL(buffer.size(), copy.size());
+        VERIFY_ARE_EQUAL(0, memcmp(buffer.data(), copy.data(), buffer.size()));
+    }
+};
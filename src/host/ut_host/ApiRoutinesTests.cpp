@@ -209,6 +209,59 @@ class ApiRoutinesTests
         VerifySetConsoleInputModeImpl(E_INVALIDARG, 0x1E4);
     }
 
+    TEST_METHOD(ApiGetConsoleOutputModeCached)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& si = gci.GetActiveOutputBuffer();
+
+        si.OutputMode = ENABLE_PROCESSED_OUTPUT;
+
+        ULONG mode = 0;
+        _pApiRoutines->GetConsoleOutputModeImpl(si, mode);
+        VERIFY_ARE_EQUAL(gsl::narrow_cast<ULONG>(ENABLE_PROCESSED_OUTPUT), mode);
+
+        Log::Comment(L"Read-only calls may release the console lock without invalidating the cache.");
+        {
+            ConsoleStateCache::ReadOnlyScope readOnly{ gci.StateCache };
+            gci.LockConsole();
+            gci.UnlockConsole();
+        }
+        si.OutputMode = ENABLE_PROCESSED_OUTPUT | ENABLE_WRAP_AT_EOL_OUTPUT;
+        _pApiRoutines->GetConsoleOutputModeImpl(si, mode);
+        VERIFY_ARE_EQUAL(gsl::narrow_cast<ULONG>(ENABLE_PROCESSED_OUTPUT), mode);
+
+        Log::Comment(L"Anyone else releasing the console lock invalidates it.");
+        gci.LockConsole();
+        gci.UnlockConsole();
+        _pApiRoutines->GetConsoleOutputModeImpl(si, mode);
+        VERIFY_ARE_EQUAL(gsl::narrow_cast<ULONG>(ENABLE_PROCESSED_OUTPUT | ENABLE_WRAP_AT_EOL_OUTPUT), mode);
+
+        Log::Comment(L"A caller that already holds the console lock must see its own changes and mustn't publish them.");
+        {
+            gci.LockConsole();
+            const auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+            si.OutputMode = ENABLE_PROCESSED_OUTPUT;
+            _pApiRoutines->GetConsoleOutputModeImpl(si, mode);
+            VERIFY_ARE_EQUAL(gsl::narrow_cast<ULONG>(ENABLE_PROCESSED_OUTPUT), mode);
+        }
+        {
+            ConsoleStateCache::ReadOnlyScope readOnly{ gci.StateCache };
+            ULONG cached = 0;
+            VERIFY_IS_FALSE(gci.StateCache.TryGet(&ConsoleStateCache::Entries::outputMode, &si, cached));
+        }
+
+        Log::Comment(L"Suspending the console lock invalidates the cache, because others may acquire the lock meanwhile.");
+        _pApiRoutines->GetConsoleOutputModeImpl(si, mode);
+        {
+            gci.LockConsole();
+            const auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+            si.OutputMode = ENABLE_PROCESSED_OUTPUT | ENABLE_WRAP_AT_EOL_OUTPUT;
+            const auto suspension = gci.SuspendLock();
+            ULONG cached = 0;
+            VERIFY_IS_FALSE(gci.StateCache.TryGet(&ConsoleStateCache::Entries::outputMode, &si, cached));
+        }
+    }
+
     TEST_METHOD(ApiGetConsoleTitleA)
     {
         auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
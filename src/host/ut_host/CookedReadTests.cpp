@@ -0,0 +1,296 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "CommonState.hpp"
+
+#include "_stream.h"
+#include "readDataCooked.hpp"
+
+#include "../interactivity/inc/ServiceLocator.hpp"
+
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using Microsoft::Console::Interactivity::ServiceLocator;
+
+class CookedReadTests
+{
+    TEST_CLASS(CookedReadTests);
+
+    std::unique_ptr<CommonState> m_state;
+
+    TEST_METHOD_SETUP(MethodSetup)
+    {
+        m_state = std::make_unique<CommonState>();
+
+        m_state->PrepareGlobalInputBuffer();
+        m_state->PrepareGlobalScreenBuffer();
+        m_state->PrepareReadHandle();
+
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        WI_SetFlag(gci.pInputBuffer->InputMode, ENABLE_ECHO_INPUT);
+
+        return true;
+    }
+
+    TEST_METHOD_CLEANUP(MethodCleanup)
+    {
+        m_state->CleanupReadHandle();
+        m_state->CleanupGlobalScreenBuffer();
+        m_state->CleanupGlobalInputBuffer();
+
+        m_state.reset(nullptr);
+
+        return true;
+    }
+
+    // Starts a cooked read whose prompt begins at the given position in the VT page area.
+    COOKED_READ_DATA& _prepareCookedRead(til::point origin)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& screenInfo = gci.GetActiveOutputBuffer();
+
+        screenInfo.GetVtPageArea().ConvertFromOrigin(&origin);
+        screenInfo.GetTextBuffer().GetCursor().SetPosition(origin);
+
+        m_state->PrepareCookedReadData();
+        return gci.CookedReadData();
+    }
+
+    static void _insert(COOKED_READ_DATA& cookedRead, size_t offset, const std::wstring_view& text)
+    {
+        cookedRead._replace(offset, 0, text.data(), text.size());
+        cookedRead._redisplay();
+    }
+
+    static void _erase(COOKED_READ_DATA& cookedRead, size_t offset, size_t count)
+    {
+        cookedRead._replace(offset, count, nullptr, 0);
+        cookedRead._redisplay();
+    }
+
+    static std::vector<std::wstring> _pageText()
+    {
+        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto& screenInfo = gci.GetActiveOutputBuffer();
+        const auto& textBuffer = screenInfo.GetTextBuffer();
+        const auto pageArea = screenInfo.GetVtPageArea();
+
+        std::vector<std::wstring> rows;
+        for (auto y = pageArea.Top(); y <= pageArea.BottomInclusive(); ++y)
+        {
+            rows.emplace_back(textBuffer.GetRowByOffset(y).GetText());
+        }
+        return rows;
+    }
+
+    // The incremental layout in _redisplay() must be indistinguishable from laying out the entire prompt
+    // from scratch. This erases the page and draws the prompt again without the previous layout, and
+    // verifies that the line starts, the page contents, and the cursor position are all unchanged.
+    static void _verifyMatchesFullRedisplay(COOKED_READ_DATA& cookedRead)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& screenInfo = gci.GetActiveOutputBuffer();
+        const auto& cursor = screenInfo.GetTextBuffer().GetCursor();
+
+        const auto incrementalLineStarts = cookedRead._layoutLineStarts;
+        const auto incrementalValidEnd = cookedRead._layoutValidEnd;
+        const auto incrementalRows = _pageText();
+        const auto incrementalCursor = cursor.GetPosition();
+
+        WriteCharsVT(screenInfo, L"\x1b[H\x1b[J");
+        cookedRead._layoutOriginX = -1;
+        cookedRead._bufferDirtyBeg = 0;
+        cookedRead._dirty = true;
+        cookedRead._redisplay();
+
+        const auto fullRows = _pageText();
+
+        VERIFY_ARE_EQUAL(cookedRead._layoutLineStarts.size(), incrementalLineStarts.size());
+        for (size_t i = 0; i < incrementalLineStarts.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(cookedRead._layoutLineStarts[i], incrementalLineStarts[i]);
+        }
+
+        VERIFY_ARE_EQUAL(fullRows.size(), incrementalRows.size());
+        for (size_t i = 0; i < incrementalRows.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(std::wstring_view{ fullRows[i] }, std::wstring_view{ incrementalRows[i] });
+        }
+
+        VERIFY_ARE_EQUAL(cursor.GetPosition(), incrementalCursor);
+
+        // The full redisplay didn't reuse anything. Restore the state of the incremental
+        // one so that the next edit continues to build on the previous layout.
+        cookedRead._layoutValidEnd = incrementalValidEnd;
+    }
+
+    TEST_METHOD(RedisplayAppendSkipsUnchangedLines)
+    {
+        auto& cookedRead = _prepareCookedRead({ 5, 0 });
+        auto cleanup = wil::scope_exit([&]() { m_state->CleanupCookedReadData(); });
+
+        std::wstring text;
+        for (auto i = 0; i < 25; ++i)
+        {
+            text.append(L"0123456789");
+        }
+
+        Log::Comment(L"Lay out a prompt that spans 4 lines, starting at column 5.");
+        cookedRead._replace(text);
+        cookedRead._redisplay();
+
+        const std::vector<size_t> expectedLineStarts{ 0, 75, 155, 235 };
+        VERIFY_ARE_EQUAL(expectedLineStarts.size(), cookedRead._layoutLineStarts.size());
+        for (size_t i = 0; i < expectedLineStarts.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(expectedLineStarts[i], cookedRead._layoutLineStarts[i]);
+        }
+        VERIFY_ARE_EQUAL(5, cookedRead._layoutOriginX);
+        VERIFY_ARE_EQUAL(80, cookedRead._layoutWidth);
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        Log::Comment(L"Type at the end until the prompt wraps onto a 5th line.");
+        for (auto i = 0; i < 70; ++i)
+        {
+            const auto end = cookedRead._buffer.size();
+            _insert(cookedRead, end, L"x");
+            VERIFY_ARE_EQUAL(end, cookedRead._layoutValidEnd);
+            _verifyMatchesFullRedisplay(cookedRead);
+        }
+        VERIFY_ARE_EQUAL(5u, cookedRead._layoutLineStarts.size());
+        VERIFY_ARE_EQUAL(315u, cookedRead._layoutLineStarts[4]);
+
+        Log::Comment(L"Backspace across the start of the last line.");
+        for (auto i = 0; i < 6; ++i)
+        {
+            _erase(cookedRead, cookedRead._buffer.size() - 1, 1);
+            _verifyMatchesFullRedisplay(cookedRead);
+        }
+        VERIFY_ARE_EQUAL(4u, cookedRead._layoutLineStarts.size());
+    }
+
+    TEST_METHOD(RedisplayEditInEarlierLine)
+    {
+        auto& cookedRead = _prepareCookedRead({ 5, 0 });
+        auto cleanup = wil::scope_exit([&]() { m_state->CleanupCookedReadData(); });
+
+        cookedRead._replace(std::wstring(250, L'a'));
+        cookedRead._redisplay();
+
+        Log::Comment(L"Insert in the middle of the 2nd line, shifting all following lines.");
+        _insert(cookedRead, 100, L"bcd");
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        Log::Comment(L"Delete the first character of the 3rd line.");
+        _erase(cookedRead, 155, 1);
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        Log::Comment(L"Delete the last character of the 1st line.");
+        _erase(cookedRead, 74, 1);
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        Log::Comment(L"Delete an entire line's worth of text from the 2nd line.");
+        _erase(cookedRead, 80, 80);
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        Log::Comment(L"Type at the end after moving the cursor around without editing.");
+        cookedRead._setCursorPosition(10);
+        cookedRead._redisplay();
+        _verifyMatchesFullRedisplay(cookedRead);
+        cookedRead._setCursorPosition(cookedRead._buffer.size());
+        cookedRead._redisplay();
+        _insert(cookedRead, cookedRead._buffer.size(), L"z");
+        _verifyMatchesFullRedisplay(cookedRead);
+    }
+
+    TEST_METHOD(RedisplayWideGlyphWrapsAtLineEnd)
+    {
+        auto& cookedRead = _prepareCookedRead({ 5, 0 });
+        auto cleanup = wil::scope_exit([&]() { m_state->CleanupCookedReadData(); });
+
+        Log::Comment(L"A wide glyph that doesn't fit into the last column gets padded and moves to the next line.");
+        cookedRead._replace(std::wstring(74, L'a') + L"\u3042" + L"b\tc");
+        cookedRead._redisplay();
+
+        VERIFY_ARE_EQUAL(2u, cookedRead._layoutLineStarts.size());
+        VERIFY_ARE_EQUAL(74u, cookedRead._layoutLineStarts[1]);
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        Log::Comment(L"Typing after the wrapped glyph resumes the layout at the glyph's line.");
+        _insert(cookedRead, cookedRead._buffer.size(), L"\td");
+        VERIFY_ARE_EQUAL(78u, cookedRead._layoutValidEnd);
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        _insert(cookedRead, cookedRead._buffer.size(), L"g");
+        VERIFY_ARE_EQUAL(80u, cookedRead._layoutValidEnd);
+        VERIFY_ARE_EQUAL(74u, cookedRead._layoutLineStarts[1]);
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        Log::Comment(L"Inserting in front of the glyph fills the 1st line, which moves the start of the 2nd line.");
+        _insert(cookedRead, 10, L"e");
+        VERIFY_ARE_EQUAL(75u, cookedRead._layoutLineStarts[1]);
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        _insert(cookedRead, cookedRead._buffer.size(), L"f");
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        Log::Comment(L"Removing it again pushes the glyph back onto the 2nd line.");
+        _erase(cookedRead, 10, 1);
+        VERIFY_ARE_EQUAL(74u, cookedRead._layoutLineStarts[1]);
+        _verifyMatchesFullRedisplay(cookedRead);
+    }
+
+    TEST_METHOD(RedisplayOriginChangeInvalidatesLayout)
+    {
+        auto& cookedRead = _prepareCookedRead({ 5, 0 });
+        auto cleanup = wil::scope_exit([&]() { m_state->CleanupCookedReadData(); });
+
+        cookedRead._replace(std::wstring(250, L'a'));
+        cookedRead._redisplay();
+        VERIFY_ARE_EQUAL(75u, cookedRead._layoutLineStarts[1]);
+
+        Log::Comment(L"Move the origin without marking the existing text as dirty, like a resize might.");
+        cookedRead._originInViewport = til::point{ 10, 0 };
+        _insert(cookedRead, cookedRead._buffer.size(), L"b");
+
+        VERIFY_ARE_EQUAL(10, cookedRead._layoutOriginX);
+        VERIFY_ARE_EQUAL(70u, cookedRead._layoutLineStarts[1]);
+        VERIFY_ARE_EQUAL(150u, cookedRead._layoutLineStarts[2]);
+        _verifyMatchesFullRedisplay(cookedRead);
+    }
+
+    TEST_METHOD(RedisplayPagerUncoversSkippedLines)
+    {
+        m_state->CleanupGlobalScreenBuffer();
+        m_state->PrepareGlobalScreenBuffer(20, 5, 20, 50);
+
+        auto& cookedRead = _prepareCookedRead({ 0, 0 });
+        auto cleanup = wil::scope_exit([&]() { m_state->CleanupCookedReadData(); });
+
+        Log::Comment(L"Lay out a prompt that is twice as tall as the viewport. The pager shows its end.");
+        std::wstring text;
+        for (auto i = 0; i < 20; ++i)
+        {
+            text.append(L"0123456789");
+        }
+        cookedRead._replace(text);
+        cookedRead._redisplay();
+        _insert(cookedRead, cookedRead._buffer.size(), L"x");
+        VERIFY_ARE_EQUAL(6, cookedRead._pagerContentTop);
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        Log::Comment(L"Shrink the prompt by 3 lines. The pager scrolls up and uncovers lines whose layout was skipped.");
+        _erase(cookedRead, 140, 61);
+        VERIFY_ARE_EQUAL(3, cookedRead._pagerContentTop);
+        _verifyMatchesFullRedisplay(cookedRead);
+
+        Log::Comment(L"Shrink the prompt below the viewport height. The pager redraws everything from the top.");
+        _erase(cookedRead, 40, 100);
+        VERIFY_ARE_EQUAL(0, cookedRead._pagerContentTop);
+        _verifyMatchesFullRedisplay(cookedRead);
+    }
+};
@@ -242,6 +242,95 @@ class HistoryTests
         VERIFY_ARE_EQUAL(2, history->GetNumberOfCommands());
     }
 
+    TEST_METHOD(FindMatchingCommandMatchesLinearSearch)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+
+        // The reference implementation of FindMatchingCommand() that the prefix index replaced.
+        const auto linearSearch = [&](const std::wstring_view prefix, CommandHistory::Index index, const bool exact) -> CommandHistory::Index {
+            const auto count = history->GetNumberOfCommands();
+            for (CommandHistory::Index i = 0; i < count; ++i)
+            {
+                const auto command = history->GetNth(index);
+                if (exact ? command == prefix : til::starts_with(command, prefix))
+                {
+                    return index;
+                }
+                index = index <= 0 ? count - 1 : index - 1;
+            }
+            return -1;
+        };
+
+        const auto verifyAll = [&]() {
+            for (const auto& item : _manyHistoryItems)
+            {
+                for (const auto prefix : { std::wstring_view{ item }, std::wstring_view{ item }.substr(0, 3), std::wstring_view{ item }.substr(0, 1) })
+                {
+                    for (CommandHistory::Index start = 0; start < history->GetNumberOfCommands(); ++start)
+                    {
+                        for (const auto exact : { false, true })
+                        {
+                            CommandHistory::Index found = -1;
+                            const auto options = CommandHistory::MatchOptions::JustLooking | (exact ? CommandHistory::MatchOptions::ExactMatch : CommandHistory::MatchOptions::None);
+                            // With JustLooking, FindMatchingCommand() starts searching at the command before the given one.
+                            const auto expected = linearSearch(prefix, start <= 0 ? history->GetNumberOfCommands() - 1 : start - 1, exact);
+                            const auto actual = history->FindMatchingCommand(prefix, start, found, options);
+                            VERIFY_ARE_EQUAL(expected != -1, actual);
+                            if (actual)
+                            {
+                                VERIFY_ARE_EQUAL(expected, found);
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        // Fill the history beyond its capacity, so that old commands get evicted.
+        for (size_t i = 0; i < _manyHistoryItems.size(); i++)
+        {
+            VERIFY_SUCCEEDED(history->Add(_manyHistoryItems[i], false));
+            VERIFY_SUCCEEDED(history->Add(_manyHistoryItems[i / 2], false));
+        }
+        verifyAll();
+
+        history->Swap(1, 7);
+        history->Swap(0, 9);
+        verifyAll();
+
+        history->Remove(3);
+        history->Remove(0);
+        verifyAll();
+
+        VERIFY_SUCCEEDED(history->Add(L"dir /w", true));
+        verifyAll();
+    }
+
+    TEST_METHOD(FindFuzzyMatches)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+
+        for (CommandHistory::Index i = 0; i < s_BufferSize; i++)
+        {
+            VERIFY_SUCCEEDED(history->Add(_manyHistoryItems[i], false));
+        }
+
+        // "dir", "dir /w", "dir /p /w", "ipconfig", "ipconfig /all" and "ping 127.0.0.1" contain an "i".
+        auto matches = history->FindFuzzyMatches(L"i");
+        VERIFY_IS_TRUE((std::vector<CommandHistory::Index>{ 0, 1, 2, 4, 5, 7 }) == matches);
+
+        // Extending the pattern narrows down the previous matches.
+        history->FilterFuzzyMatches(L"ipc", matches);
+        VERIFY_IS_TRUE((std::vector<CommandHistory::Index>{ 4, 5 }) == matches);
+        history->FilterFuzzyMatches(L"ipc ALL", matches);
+        VERIFY_IS_TRUE((std::vector<CommandHistory::Index>{ 5 }) == matches);
+
+        VERIFY_ARE_EQUAL(static_cast<size_t>(s_BufferSize), history->FindFuzzyMatches(L"").size());
+        VERIFY_IS_TRUE(history->FindFuzzyMatches(L"xyz").empty());
+    }
+
 private:
     const std::array<std::wstring, 5> _manyApps = {
         L"foo.exe",
@@ -595,6 +595,56 @@ class InputBufferTests
         VERIFY_ARE_EQUAL(outEvents.front().Event.KeyEvent.wRepeatCount, 1u);
     }
 
+    TEST_METHOD(WrittenStringsAreStoredAsText)
+    {
+        InputBuffer inputBuffer;
+        inputBuffer.WriteString(std::wstring_view{ L"abc\0d", 5 });
+
+        // "abc", NUL and "d", but still 5 events from the client's point of view.
+        VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 3u);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 5u);
+
+        InputEventQueue outEvents;
+        VERIFY_NT_SUCCESS(inputBuffer.Read(outEvents, 2, false, false, true, false));
+        VERIFY_ARE_EQUAL(outEvents.size(), 2u);
+        VERIFY_ARE_EQUAL(outEvents[0], SynthesizeKeyEvent(true, 1, 0, 0, L'a', 0));
+        VERIFY_ARE_EQUAL(outEvents[1], SynthesizeKeyEvent(true, 1, 0, 0, L'b', 0));
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 3u);
+
+        // The remainder of the text can be consumed without reading INPUT_RECORDs.
+        VERIFY_ARE_EQUAL(inputBuffer.PeekText(), std::wstring_view{ L"c" });
+        inputBuffer.ConsumeText(1);
+        VERIFY_ARE_EQUAL(inputBuffer.PeekText(), std::wstring_view{ L"" });
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 2u);
+
+        outEvents.clear();
+        VERIFY_NT_SUCCESS(inputBuffer.Read(outEvents, 1, false, false, true, false));
+        VERIFY_ARE_EQUAL(outEvents.size(), 1u);
+        VERIFY_ARE_EQUAL(outEvents[0].Event.KeyEvent.uChar.UnicodeChar, UNICODE_NULL);
+
+        VERIFY_ARE_EQUAL(inputBuffer.PeekText(), std::wstring_view{ L"d" });
+        inputBuffer.ConsumeText(1);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+        VERIFY_IS_TRUE(inputBuffer._text.empty());
+    }
+
+    TEST_METHOD(PrependedEventsPrecedeText)
+    {
+        InputBuffer inputBuffer;
+        inputBuffer.WriteString(L"bc");
+
+        const auto record = MakeKeyEvent(true, 1, L'a', 0, L'a', 0);
+        VERIFY_ARE_EQUAL(inputBuffer.Prepend({ &record, 1 }), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 3u);
+
+        InputEventQueue outEvents;
+        VERIFY_NT_SUCCESS(inputBuffer.Read(outEvents, 3, true, false, true, false));
+        VERIFY_ARE_EQUAL(outEvents.size(), 3u);
+        VERIFY_ARE_EQUAL(outEvents[0], record);
+        VERIFY_ARE_EQUAL(outEvents[1], SynthesizeKeyEvent(true, 1, 0, 0, L'b', 0));
+        VERIFY_ARE_EQUAL(outEvents[2], SynthesizeKeyEvent(true, 1, 0, 0, L'c', 0));
+    }
+
     TEST_METHOD(StreamPeekingDeCoalesces)
     {
         InputBuffer inputBuffer;
@@ -79,6 +79,14 @@ class TextBufferTests
 
     TEST_METHOD(TestDoubleBytePadFlag);
 
+    TEST_METHOD(TestWriteCharInfosMatchesWriteCells);
+
+    TEST_METHOD(TestFillCellsMatchesWriteCells);
+
+    TEST_METHOD(TestExportCharInfosMatchesCellIterator);
+
+    TEST_METHOD(TestTrimCommittedMemory);
+
     void DoBoundaryTest(PCWCHAR const pwszInputString,
                         const til::CoordType cLength,
                         const til::CoordType cMax,
@@ -284,6 +292,158 @@ void TextBufferTests::TestDoubleBytePadFlag()
     VERIFY_IS_FALSE(Row.WasDoubleBytePadded());
 }
 
+static void VerifyRowsAreEqual(const ROW& expected, const ROW& actual)
+{
+    VERIFY_ARE_EQUAL(expected.GetText(), actual.GetText());
+    VERIFY_IS_TRUE(expected.Attributes() == actual.Attributes());
+    VERIFY_ARE_EQUAL(expected.WasWrapForced(), actual.WasWrapForced());
+    VERIFY_ARE_EQUAL(expected.WasDoubleBytePadded(), actual.WasDoubleBytePadded());
+    for (til::CoordType x = 0; x < expected.size(); ++x)
+    {
+        VERIFY_IS_TRUE(expected.DbcsAttrAt(x) == actual.DbcsAttrAt(x));
+    }
+}
+
+void TextBufferTests::TestWriteCharInfosMatchesWriteCells()
+{
+    static constexpr WORD L = COMMON_LVB_LEADING_BYTE;
+    static constexpr WORD T = COMMON_LVB_TRAILING_BYTE;
+
+    struct TestCase
+    {
+        std::wstring_view name;
+        til::CoordType column;
+        std::vector<CHAR_INFO> infos;
+    };
+
+    const std::vector<TestCase> testCases{
+        { L"plain text with attribute runs", 1, { { L'a', 0x07 }, { L'b', 0x07 }, { L'c', 0x1f }, { L'd', 0x1f }, { L'e', 0x07 } } },
+        { L"wide glyphs", 0, { { L'\u732B', 0x07 | L }, { L'\u732B', 0x07 | T }, { L'x', 0x07 }, { L'\u732B', 0x2e | L }, { L'\u732B', 0x2e | T } } },
+        { L"leading half in the last column", 8, { { L'x', 0x07 }, { L'\u732B', 0x07 | L }, { L'\u732B', 0x07 | T } } },
+        { L"trailing half in the first column", 0, { { L'\u732B', 0x07 | T }, { L'x', 0x07 } } },
+        { L"trailing half as the first cell", 3, { { L'\u732B', 0x07 | T }, { L'x', 0x07 } } },
+        { L"leading half without a trailer", 2, { { L'\u732B', 0x07 | L }, { L'x', 0x07 }, { L'\u732B', 0x07 | L } } },
+        { L"trailer without a leading half", 2, { { L'x', 0x07 }, { L'\u732B', 0x07 | T }, { L'y', 0x07 } } },
+    };
+
+    for (const auto& test : testCases)
+    {
+        Log::Comment(NoThrowString().Format(L"%.*s", gsl::narrow_cast<int>(test.name.size()), test.name.data()));
+
+        TextBuffer expected{ { 10, 1 }, TextAttribute{ 0x7 }, 0, false, &_renderer };
+        TextBuffer actual{ { 10, 1 }, TextAttribute{ 0x7 }, 0, false, &_renderer };
+
+        // Start with a wide glyph in every other column, so that all writes need to deal with overwriting them.
+        for (auto buffer : { &expected, &actual })
+        {
+            auto& row = buffer->GetMutableRowByOffset(0);
+            for (til::CoordType x = 0; x < 10; x += 2)
+            {
+                row.ReplaceCharacters(x, 2, L"\u3042");
+            }
+        }
+
+        expected.GetMutableRowByOffset(0).WriteCells(OutputCellIterator{ std::span<const CHAR_INFO>{ test.infos } }, test.column);
+        actual.WriteCharInfos({ test.column, 0 }, test.infos);
+
+        VerifyRowsAreEqual(expected.GetRowByOffset(0), actual.GetRowByOffset(0));
+    }
+}
+
+void TextBufferTests::TestFillCellsMatchesWriteCells()
+{
+    TextBuffer expected{ { 10, 3 }, TextAttribute{ 0x7 }, 0, false, &_renderer };
+    TextBuffer actual{ { 10, 3 }, TextAttribute{ 0x7 }, 0, false, &_renderer };
+
+    for (auto buffer : { &expected, &actual })
+    {
+        for (til::CoordType y = 0; y < 3; ++y)
+        {
+            auto& row = buffer->GetMutableRowByOffset(y);
+            row.ReplaceCharacters(1, 2, L"\u3042");
+            row.ReplaceCharacters(8, 2, L"\u3042");
+            row.SetWrapForced(true);
+        }
+    }
+
+    const wchar_t ch = L'x';
+    const TextAttribute attr{ 0x1e };
+
+    expected.Write(OutputCellIterator(ch, 14), { 2, 0 }, false);
+    expected.Write(OutputCellIterator(attr, 7), { 5, 1 }, false);
+    actual.FillCells({ 2, 0 }, 14, &ch, nullptr);
+    actual.FillCells({ 5, 1 }, 7, nullptr, &attr);
+
+    for (til::CoordType y = 0; y < 3; ++y)
+    {
+        VerifyRowsAreEqual(expected.GetRowByOffset(y), actual.GetRowByOffset(y));
+    }
+}
+
+void TextBufferTests::TestExportCharInfosMatchesCellIterator()
+{
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    TextBuffer buffer{ { 10, 1 }, TextAttribute{ 0x7 }, 0, false, &_renderer };
+
+    auto& row = buffer.GetMutableRowByOffset(0);
+    row.ReplaceCharacters(0, 1, L"a");
+    row.ReplaceCharacters(1, 2, L"\u732B");
+    row.ReplaceCharacters(3, 1, L"\U0001F600");
+    row.ReplaceCharacters(8, 2, L"\u3042");
+    row.ReplaceAttributes(2, 5, TextAttribute{ 0x1e });
+    row.ReplaceAttributes(5, 9, TextAttribute{ RGB(255, 0, 0), RGB(0, 0, 255) });
+
+    // U+732B occupies columns 1 and 2. Start at column 2, so that the export begins with its trailing half.
+    std::vector<CHAR_INFO> actual(8);
+    row.ExportCharInfos(2, actual);
+    VERIFY_IS_TRUE(WI_IsFlagSet(actual[0].Attributes, COMMON_LVB_TRAILING_BYTE));
+
+    auto it = buffer.GetCellDataAt({ 2, 0 });
+    for (const auto& info : actual)
+    {
+        VERIFY_ARE_EQUAL(gci.AsCharInfo(*it), info);
+        ++it;
+    }
+}
+
+void TextBufferTests::TestTrimCommittedMemory()
+{
+    TextBuffer buffer{ { 10, 1000 }, TextAttribute{ 0x7 }, 0, false, &_renderer };
+
+    buffer.GetMutableRowByOffset(0).ReplaceCharacters(0, 1, L"a");
+    buffer.GetMutableRowByOffset(3).ReplaceAttributes(0, 2, TextAttribute{ 0x1e });
+
+    // Reading a row commits everything up to it, plus some read-ahead.
+    VERIFY_ARE_EQUAL(std::wstring_view{ L"          " }, buffer.GetRowByOffset(500).GetText());
+    VERIFY_IS_GREATER_THAN_OR_EQUAL(buffer._estimateOffsetOfLastCommittedRow(), 500);
+
+    Log::Comment(L"Only the rows up to the last modified one should stay committed.");
+    buffer.TrimCommittedMemory();
+    VERIFY_ARE_EQUAL(3, buffer._estimateOffsetOfLastCommittedRow());
+
+    buffer.TrimCommittedMemory();
+    VERIFY_ARE_EQUAL(3, buffer._estimateOffsetOfLastCommittedRow());
+
+    Log::Comment(L"The contents must be unaffected and trimmed rows get recreated on demand.");
+    VERIFY_ARE_EQUAL(std::wstring_view{ L"a         " }, buffer.GetRowByOffset(0).GetText());
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x1e }, buffer.GetRowByOffset(3).GetAttrByColumn(1));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x7 }, buffer.GetRowByOffset(3).GetAttrByColumn(2));
+    VERIFY_ARE_EQUAL(std::wstring_view{ L"          " }, buffer.GetRowByOffset(500).GetText());
+    VERIFY_IS_GREATER_THAN_OR_EQUAL(buffer._estimateOffsetOfLastCommittedRow(), 500);
+
+    Log::Comment(L"A buffer that wrapped around must not be trimmed, because its newest rows aren't at the end.");
+    VERIFY_ARE_EQUAL(std::wstring_view{ L"          " }, buffer.GetRowByOffset(999).GetText());
+    buffer.IncrementCircularBuffer();
+    buffer.IncrementCircularBuffer();
+    buffer.GetMutableRowByOffset(999).ReplaceCharacters(0, 1, L"z");
+    VERIFY_ARE_EQUAL(999, buffer._estimateOffsetOfLastCommittedRow());
+
+    buffer.TrimCommittedMemory();
+    VERIFY_ARE_EQUAL(999, buffer._estimateOffsetOfLastCommittedRow());
+    VERIFY_ARE_EQUAL(std::wstring_view{ L"z         " }, buffer.GetRowByOffset(999).GetText());
+    VERIFY_ARE_EQUAL(std::wstring_view{ L"          " }, buffer.GetRowByOffset(997).GetText());
+}
+
 void TextBufferTests::DoBoundaryTest(PCWCHAR const pwszInputString,
                                      const til::CoordType cLength,
                                      const til::CoordType cMax,
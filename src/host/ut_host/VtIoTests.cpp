@@ -39,6 +39,9 @@ constexpr CHAR_INFO ci_blu(wchar_t ch) noexcept
 // The escape sequences that ci_red() / ci_blu() result in.
 #define sgr_red(s) "\x1b[0;31;42m" s
 #define sgr_blu(s) "\x1b[0;34;42m" s
+// Within a single row only the difference between ci_red() and ci_blu() is emitted.
+#define sgr_to_red(s) "\x1b[31m" s
+#define sgr_to_blu(s) "\x1b[34m" s
 // What the default attributes `FOREGROUND_BLUE | FOREGROUND_GREEN | FOREGROUND_RED` result in.
 #define sgr_rst() "\x1b[0m"
 
@@ -62,6 +65,30 @@ static constexpr std::wstring_view s_initialContentVTWide{
     // clang-format on
 };
 
+// Reads exactly `length` bytes from the server end of an overlapped pipe.
+static std::string readOverlapped(HANDLE pipe, size_t length)
+{
+    std::string buffer(length, '\0');
+    const wil::unique_event event{ wil::EventOptions::ManualReset };
+    size_t offset = 0;
+
+    while (offset < length)
+    {
+        OVERLAPPED overlapped{};
+        overlapped.hEvent = event.get();
+        if (!ReadFile(pipe, buffer.data() + offset, gsl::narrow_cast<DWORD>(length - offset), nullptr, &overlapped))
+        {
+            THROW_LAST_ERROR_IF(GetLastError() != ERROR_IO_PENDING);
+        }
+
+        DWORD read = 0;
+        THROW_IF_WIN32_BOOL_FALSE(GetOverlappedResult(pipe, &overlapped, &read, TRUE));
+        offset += read;
+    }
+
+    return buffer;
+}
+
 class ::Microsoft::Console::VirtualTerminal::VtIoTests
 {
     BEGIN_TEST_CLASS(VtIoTests)
@@ -279,7 +306,7 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
         Viewport written;
         THROW_IF_FAILED(routines.WriteConsoleOutputWImpl(*screenInfo, payload, target, written));
 
-        const auto expected = decsc() cup(2, 2) sgr_red("ab") sgr_blu("AB") decrc();
+        const auto expected = decsc() cup(2, 2) sgr_red("ab") sgr_to_blu("AB") decrc();
         const auto actual = readOutput();
         VERIFY_ARE_EQUAL(expected, actual);
     }
@@ -295,8 +322,8 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
 
         const auto expected =
             decsc() //
-            cup(2, 7) sgr_red("g") sgr_blu("h") //
-            cup(3, 1) sgr_red("i") sgr_blu("j") //
+            cup(2, 7) sgr_red("g") sgr_to_blu("h") //
+            cup(3, 1) sgr_red("i") sgr_to_blu("j") //
             decrc();
         const auto actual = readOutput();
         VERIFY_ARE_EQUAL(expected, actual);
@@ -313,8 +340,8 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
         THROW_IF_FAILED(routines.WriteConsoleOutputCharacterWImpl(*screenInfo, L"foobar", { 5, 1 }, written));
         expected =
             decsc() //
-            cup(2, 6) sgr_red("f") sgr_blu("oo") //
-            cup(3, 1) sgr_blu("ba") sgr_red("r") //
+            cup(2, 6) sgr_red("f") sgr_to_blu("oo") //
+            cup(3, 1) sgr_blu("ba") sgr_to_red("r") //
             decrc();
         actual = readOutput();
         VERIFY_ARE_EQUAL(6u, written);
@@ -324,7 +351,7 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
         THROW_IF_FAILED(routines.WriteConsoleOutputCharacterWImpl(*screenInfo, L"foobar", { 5, 3 }, written));
         expected =
             decsc() //
-            cup(4, 6) sgr_blu("f") sgr_red("oo") //
+            cup(4, 6) sgr_blu("f") sgr_to_red("oo") //
             decrc();
         actual = readOutput();
         VERIFY_ARE_EQUAL(3u, written);
@@ -334,8 +361,8 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
         THROW_IF_FAILED(routines.WriteConsoleOutputCharacterWImpl(*screenInfo, L"✨✅❌", { 5, 1 }, written));
         expected =
             decsc() //
-            cup(2, 6) sgr_red("✨") sgr_blu(" ") //
-            cup(3, 1) sgr_blu("✅") sgr_red("❌") //
+            cup(2, 6) sgr_red("✨") sgr_to_blu(" ") //
+            cup(3, 1) sgr_blu("✅") sgr_to_red("❌") //
             decrc();
         actual = readOutput();
         VERIFY_ARE_EQUAL(3u, written);
@@ -441,7 +468,7 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
         THROW_IF_FAILED(routines.FillConsoleOutputCharacterWImpl(*screenInfo, L'a', 3, { 0, 0 }, cellsModified, false));
         expected =
             decsc() //
-            cup(1, 1) sgr_red("aa") sgr_blu("a") //
+            cup(1, 1) sgr_red("aa") sgr_to_blu("a") //
             decrc();
         actual = readOutput();
         VERIFY_ARE_EQUAL(expected, actual);
@@ -450,7 +477,7 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
         THROW_IF_FAILED(routines.FillConsoleOutputCharacterWImpl(*screenInfo, L'b', 3, { 5, 0 }, cellsModified, false));
         expected =
             decsc() //
-            cup(1, 6) sgr_red("b") sgr_blu("bb") //
+            cup(1, 6) sgr_red("b") sgr_to_blu("bb") //
             decrc();
         actual = readOutput();
         VERIFY_ARE_EQUAL(expected, actual);
@@ -459,8 +486,8 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
         THROW_IF_FAILED(routines.FillConsoleOutputCharacterWImpl(*screenInfo, L'c', 8, { 4, 1 }, cellsModified, false));
         expected =
             decsc() //
-            cup(2, 5) sgr_red("cc") sgr_blu("cc") //
-            cup(3, 1) sgr_blu("cc") sgr_red("cc") //
+            cup(2, 5) sgr_red("cc") sgr_to_blu("cc") //
+            cup(3, 1) sgr_blu("cc") sgr_to_red("cc") //
             decrc();
         actual = readOutput();
         VERIFY_ARE_EQUAL(expected, actual);
@@ -469,8 +496,8 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
         THROW_IF_FAILED(routines.FillConsoleOutputCharacterWImpl(*screenInfo, L'✨', 3, { 5, 1 }, cellsModified, false));
         expected =
             decsc() //
-            cup(2, 6) sgr_red("✨") sgr_blu(" ") //
-            cup(3, 1) sgr_blu("✨") sgr_red("✨") //
+            cup(2, 6) sgr_red("✨") sgr_to_blu(" ") //
+            cup(3, 1) sgr_blu("✨") sgr_to_red("✨") //
             decrc();
         actual = readOutput();
         VERIFY_ARE_EQUAL(expected, actual);
@@ -533,8 +560,8 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
             decsc() //
             cup(1, 2) sgr_red("ZZ") //
             cup(2, 2) sgr_red("ZZ") //
-            cup(3, 6) sgr_red("B") sgr_blu("a") //
-            cup(4, 6) sgr_red("F") sgr_blu("e") //
+            cup(3, 6) sgr_red("B") sgr_to_blu("a") //
+            cup(4, 6) sgr_red("F") sgr_to_blu("e") //
             decrc();
         actual = readOutput();
         VERIFY_ARE_EQUAL(expected, actual);
@@ -623,9 +650,9 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
             cup(2, 4) sgr_blu("yy") //
             cup(3, 4) sgr_blu("yy") //
             cup(4, 4) sgr_blu("yy") //
-            cup(2, 4) sgr_blu("y") sgr_red("AZZ") sgr_blu("b") //
-            cup(3, 4) sgr_blu("y") sgr_red("E") sgr_blu("zzf") //
-            cup(4, 4) sgr_blu("yizz") sgr_red("J") //
+            cup(2, 4) sgr_blu("y") sgr_to_red("AZZ") sgr_to_blu("b") //
+            cup(3, 4) sgr_blu("y") sgr_to_red("E") sgr_to_blu("zzf") //
+            cup(4, 4) sgr_blu("yizz") sgr_to_red("J") //
             decrc();
         actual = readOutput();
         VERIFY_ARE_EQUAL(expected, actual);
@@ -833,14 +860,82 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
 
         const auto expected =
             "\x1b[?1049l" // ASB (Alternate Screen Buffer)
-            cup(1, 1) sgr_red("AB") sgr_blu("ab") sgr_red("CD") sgr_blu("cd") //
-            cup(2, 1) sgr_red("EF") sgr_blu("ef") sgr_red("GH") sgr_blu("gh") //
-            cup(3, 1) sgr_blu("ij") sgr_red("IJ") sgr_blu("kl") sgr_red("KL") //
-            cup(4, 1) sgr_blu("mn") sgr_red("MN") sgr_blu("op") sgr_red("OP") //
+            cup(1, 1) sgr_red("AB") sgr_to_blu("ab") sgr_to_red("CD") sgr_to_blu("cd") //
+            cup(2, 1) sgr_red("EF") sgr_to_blu("ef") sgr_to_red("GH") sgr_to_blu("gh") //
+            cup(3, 1) sgr_blu("ij") sgr_to_red("IJ") sgr_to_blu("kl") sgr_to_red("KL") //
+            cup(4, 1) sgr_blu("mn") sgr_to_red("MN") sgr_to_blu("op") sgr_to_red("OP") //
             cup(1, 1) sgr_rst() //
             "\x1b[?25h" // DECTCEM (Text Cursor Enable)
             "\x1b[?7h"; // DECAWM (Autowrap Mode)
         const auto actual = readOutput();
         VERIFY_ARE_EQUAL(expected, actual);
     }
+
+    TEST_METHOD(DeferredOutputIsFlushedInOrder)
+    {
+        auto pipe = Utils::CreateOverlappedPipe(PIPE_ACCESS_INBOUND, 4096);
+        VtIo io;
+        THROW_IF_FAILED(io._Initialize(nullptr, pipe.client.release(), nullptr));
+        VERIFY_IS_TRUE(static_cast<bool>(io._flushWait));
+
+        // Nobody is reading yet, so this write exceeds the pipe buffer and remains pending.
+        const std::string first(16 * 1024, 'a');
+        {
+            VtIo::Writer writer{ &io };
+            writer.WriteUTF8(first);
+            writer.Submit();
+        }
+        VERIFY_IS_TRUE(io._overlappedPending);
+
+        // Instead of blocking on the pending write, further output is held back.
+        for (const auto str : { "b", "c" })
+        {
+            VtIo::Writer writer{ &io };
+            writer.WriteUTF8(str);
+            writer.Submit();
+        }
+        VERIFY_IS_TRUE(io._flushDeferred);
+        VERIFY_IS_TRUE(io._back == "bc");
+
+        // Once the terminal reads the first write, the held back output follows in order.
+        const auto expected = first + "bc";
+        const auto actual = readOverlapped(pipe.server.get(), expected.size());
+        VERIFY_IS_TRUE(expected == actual);
+    }
+
+    TEST_METHOD(ShutdownFlushesDeferredOutput)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto pipe = Utils::CreateOverlappedPipe(PIPE_ACCESS_INBOUND, 4096);
+        VtIo io;
+        THROW_IF_FAILED(io._Initialize(nullptr, pipe.client.release(), nullptr));
+        io._state = VtIo::State::Running;
+
+        const std::string first(16 * 1024, 'a');
+        for (const std::string_view str : { std::string_view{ first }, std::string_view{ "b" } })
+        {
+            VtIo::Writer writer{ &io };
+            writer.WriteUTF8(str);
+            writer.Submit();
+        }
+        VERIFY_IS_TRUE(io._flushDeferred);
+
+        // Shutdown() is called with the console lock held (see ServiceLocator::RundownAndExit).
+        gci.LockConsole();
+        const auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+        // Completing the first write queues _flushDeferredCallback(), which then waits for the console lock.
+        // Shutdown() must neither deadlock with it, nor lose the output it was meant to flush.
+        auto actual = readOverlapped(pipe.server.get(), first.size());
+        io.Shutdown();
+        VERIFY_IS_FALSE(static_cast<bool>(io._flushWait));
+        VERIFY_ARE_EQUAL(1ul, gci.GetCSRecursionCount());
+
+        const auto expected = first +
+                              "b"
+                              "\x1b[?1004l" // Focus Event Mode
+                              "\x1b[?9001l"; // Win32 Input Mode
+        actual += readOverlapped(pipe.server.get(), expected.size() - actual.size());
+        VERIFY_IS_TRUE(expected == actual);
+    }
 };
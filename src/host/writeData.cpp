@@ -31,7 +31,8 @@ WriteData::WriteData(SCREEN_INFORMATION& siContext,
     _uiOutputCodepage(uiOutputCodepage),
     _fLeadByteCaptured(false),
     _fLeadByteConsumed(false),
-    _cchUtf8Consumed(0)
+    _cchUtf8Consumed(0),
+    _cchAlreadyWritten(0)
 {
 }
 
@@ -75,6 +76,18 @@ void WriteData::SetUtf8ConsumedCharacters(const size_t cchUtf8Consumed)
     _cchUtf8Consumed = cchUtf8Consumed;
 }
 
+// Routine Description:
+// - For streamed WriteConsoleW calls, remembers how much of the request was already written before it had to wait.
+//   The stowed string only holds the remainder, but the reply must account for the whole request.
+// Arguments:
+// - cchAlreadyWritten - Count of characters written before the wait was created.
+// Return Value:
+// - <none>
+void WriteData::SetAlreadyWrittenCharacters(const size_t cchAlreadyWritten) noexcept
+{
+    _cchAlreadyWritten = cchAlreadyWritten;
+}
+
 // Routine Description:
 // - Called back at a later time to resume the writing operation when the output object becomes unblocked.
 // Arguments:
@@ -125,7 +138,7 @@ bool WriteData::Notify(const WaitTerminationReason TerminationReason,
         return false;
     }
 
-    auto cbContext = _pwchContext.size();
+    auto cbContext = _cchAlreadyWritten + _pwchContext.size();
 
     // There's extra work to do to correct the byte counts if the original call was an A-version call.
     // We always process and hold text in the waiter as W-version text, but the A call is expecting
@@ -34,6 +34,8 @@ public:
 
     void SetUtf8ConsumedCharacters(const size_t cchUtf8Consumed);
 
+    void SetAlreadyWrittenCharacters(const size_t cchAlreadyWritten) noexcept;
+
     void MigrateUserBuffersOnTransitionToBackgroundWait(const void* oldBuffer, void* newBuffer) override;
     bool Notify(const WaitTerminationReason TerminationReason,
                 const bool fIsUnicode,
@@ -49,4 +51,5 @@ private:
     bool _fLeadByteCaptured;
     bool _fLeadByteConsumed;
     size_t _cchUtf8Consumed;
+    size_t _cchAlreadyWritten;
 };
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <thread>
+
+#include "latch.h"
+
+namespace til
+{
+    // Calls func(i) for every i in [0, count) on up to hardware_concurrency() threads
+    // and waits for all of them to finish. func must not throw.
+    // The calling thread does its share of the work, while the others run on the thread pool.
+    // If it can't provide any threads, everything simply runs on the calling thread.
+    template<typename Func>
+    void parallel_for(const size_t count, const Func& func)
+    {
+        const auto workerCount = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+        if (workerCount == 0)
+        {
+            return;
+        }
+
+        std::atomic<size_t> next{ 0 };
+        til::latch latch{ static_cast<ptrdiff_t>(workerCount) };
+
+        const auto work = [&]() noexcept {
+            for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < count; i = next.fetch_add(1, std::memory_order_relaxed))
+            {
+                func(i);
+            }
+            latch.count_down();
+        };
+        using Work = decltype(work);
+
+        // `work` outlives the callbacks, because we wait for the latch below.
+        for (size_t i = 1; i < workerCount; ++i)
+        {
+            const auto callback = [](PTP_CALLBACK_INSTANCE, void* context) noexcept {
+                (*static_cast<const Work*>(context))();
+            };
+            if (!TrySubmitThreadpoolCallback(callback, const_cast<Work*>(&work), nullptr))
+            {
+                latch.count_down(static_cast<ptrdiff_t>(workerCount - i));
+                break;
+            }
+        }
+
+        work();
+        latch.wait();
+    }
+}
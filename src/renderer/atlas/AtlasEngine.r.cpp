@@ -96,6 +96,40 @@ void AtlasEngine::WaitUntilCanRender() noexcept
 
 #pragma endregion
 
+// Releases everything that the next frame can recreate on demand: The swap chain, the backend and
+// its glyph atlas, the D3D device and all viewport-sized buffers. The next frame will be a full redraw.
+// The caller must ensure that we aren't rendering concurrently, e.g. via Renderer::TriggerTeardown().
+void AtlasEngine::ReleaseResources() noexcept
+{
+    _destroySwapChain();
+    _b.reset();
+    _p.deviceContext.reset();
+    _p.device.reset();
+    _p.dxgi = {};
+
+    _p.unorderedRows = {};
+    _p.rowsScratch = {};
+    _p.rows = {};
+    _p.colorBitmap = {};
+    _p.backgroundBitmap = {};
+    _p.foregroundBitmap = {};
+    _p.underlineBitmap = {};
+
+    _api.bufferLine = {};
+    _api.bufferLineColumn = {};
+    _api.analysisResults = {};
+    _api.clusterMap = {};
+    _api.textProps = {};
+    _api.glyphIndices = {};
+    _api.glyphProps = {};
+    _api.glyphAdvances = {};
+    _api.glyphOffsets = {};
+
+    // Resetting the settings generation ensures that the next StartPaint() calls
+    // _handleSettingsUpdate(), which recreates the font and cell count dependent resources.
+    _p.s = {};
+}
+
 void AtlasEngine::_recreateAdapter()
 {
 #ifndef NDEBUG
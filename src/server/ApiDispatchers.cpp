@@ -10,6 +10,14 @@
 #include "../host/stream.h"
 #include "../host/srvinit.h"
 #include "../host/cmdline.h"
+#include "../host/globals.h"
+#include "../host/handle.h"
+#include "../host/server.h"
+#include "../host/writeData.hpp"
+
+#include "../interactivity/inc/ServiceLocator.hpp"
+
+using Microsoft::Console::Interactivity::ServiceLocator;
 
 // Assumes that it will find <m> in the calling environment.
 #define TraceConsoleAPICallWithOrigin(ApiName, ...)                  \
@@ -336,6 +344,126 @@ constexpr T saturate(auto val)
     return hr;
 }
 
+// Large WriteConsoleW payloads are read from the driver and written in slices of this many bytes.
+// This bounds the memory needed to service them, no matter how much a client writes at once.
+static constexpr ULONG WriteConsoleSliceSize = 64 * 1024;
+
+// Routine Description:
+// - Called by StreamWriteConsoleW() if the console got suspended halfway through a write. Queues the
+//   rest of the write to be completed once the console resumes, just like WriteConsoleWImpl() does.
+// - Must be called while holding the console lock.
+// Arguments:
+// - m - the WriteConsole message
+// - screenInfo - the screen buffer to write into
+// - pending - the characters that were read from the driver, but not written yet
+// - cbOffset - the offset of the part of the payload that wasn't read from the driver yet
+// - cbWritten - the number of bytes that were already written
+// Return Value:
+// - CONSOLE_STATUS_WAIT or an error if the wait couldn't be created.
+[[nodiscard]] static HRESULT WaitStreamedWriteConsoleW(CONSOLE_API_MSG* const m, SCREEN_INFORMATION& screenInfo, const std::wstring_view pending, const ULONG cbOffset, const size_t cbWritten)
+try
+{
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    const auto cbTotal = m->Descriptor.InputSize - m->State.ReadOffset;
+    const auto cchUnread = (cbTotal - cbOffset) / sizeof(wchar_t);
+
+    std::wstring rest;
+    rest.resize(pending.size() + cchUnread);
+    std::copy(pending.begin(), pending.end(), rest.begin());
+    RETURN_IF_FAILED(m->ReadMessageInput(cbOffset, rest.data() + pending.size(), gsl::narrow_cast<ULONG>(cchUnread * sizeof(wchar_t))));
+
+    const auto waiter = new WriteData(screenInfo, std::move(rest), gci.OutputCP);
+    waiter->SetAlreadyWrittenCharacters(cbWritten / sizeof(wchar_t));
+    RETURN_IF_FAILED(ConsoleWaitQueue::s_CreateWait(m, waiter));
+    return CONSOLE_STATUS_WAIT;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Services a large WriteConsoleW request by reading its payload from the driver in
+//   slices of WriteConsoleSliceSize and writing each one as soon as it has been read.
+// - The console lock is only held while writing a slice, not while reading the next one from the driver.
+//   If the console gets suspended in between, the rest of the write waits just like a regular one would.
+// Arguments:
+// - m - the WriteConsole message
+// - screenInfo - the screen buffer to write into
+// - cbRead - receives the number of bytes written, even if an error occurred halfway through
+// Return Value:
+// - S_FALSE if the write needs to wait before anything was written. The caller should use the regular path.
+// - CONSOLE_STATUS_WAIT if the rest of the write is waiting for the console to resume.
+// - Otherwise the result of reading or writing the last slice.
+[[nodiscard]] static HRESULT StreamWriteConsoleW(CONSOLE_API_MSG* const m, SCREEN_INFORMATION& screenInfo, size_t& cbRead)
+{
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+    cbRead = 0;
+
+    const auto cbTotal = m->Descriptor.InputSize - m->State.ReadOffset;
+
+    // +1 for a leading surrogate held back from the previous slice.
+    ApiMessageBuffer slice;
+    slice.resize(WriteConsoleSliceSize + sizeof(wchar_t));
+    const auto chars = reinterpret_cast<wchar_t*>(slice.data());
+    size_t carry = 0;
+
+    for (ULONG cbOffset = 0; cbOffset < cbTotal;)
+    {
+        const auto cbSlice = std::min(cbTotal - cbOffset, WriteConsoleSliceSize);
+        RETURN_IF_FAILED(m->ReadMessageInput(cbOffset, chars + carry, cbSlice));
+        cbOffset += cbSlice;
+
+        auto cch = carry + cbSlice / sizeof(wchar_t);
+        carry = 0;
+
+        // Don't split surrogate pairs across two writes.
+        if (cbOffset < cbTotal && cch != 0 && til::is_leading_surrogate(chars[cch - 1]))
+        {
+            carry = 1;
+            cch--;
+        }
+
+        // WriteConsoleWImpl() may write less than it was given, so we keep going until the slice is consumed.
+        for (std::wstring_view buffer{ chars, cch }; !buffer.empty();)
+        {
+            LockConsole();
+            auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
+            if (WI_IsAnyFlagSet(gci.Flags, (CONSOLE_SUSPENDED | CONSOLE_SELECTING | CONSOLE_SCROLLBAR_TRACKING)))
+            {
+                if (cbRead == 0)
+                {
+                    return S_FALSE;
+                }
+                // The held back leading surrogate (if any) directly follows the slice.
+                return WaitStreamedWriteConsoleW(m, screenInfo, { buffer.data(), buffer.size() + carry }, cbOffset, cbRead);
+            }
+
+            size_t cchInputRead = 0;
+
+            TraceConsoleAPICallWithOrigin(
+                "WriteConsoleW",
+                TraceLoggingUInt32(m->u.consoleMsgL1.WriteConsole.NumBytes, "NumBytes"),
+                TraceLoggingCountedWideString(buffer.data(), static_cast<ULONG>(buffer.size()), "Buffer"));
+
+            const auto hr = m->_pApiRoutines->WriteConsoleWImpl(screenInfo, buffer, cchInputRead, m);
+            cchInputRead = std::min(cchInputRead, buffer.size());
+            cbRead += cchInputRead * sizeof(wchar_t);
+            RETURN_IF_FAILED(hr);
+            // Don't spin forever if the write makes no progress.
+            RETURN_HR_IF(E_UNEXPECTED, cchInputRead == 0);
+
+            buffer = buffer.substr(cchInputRead);
+        }
+
+        if (carry)
+        {
+            chars[0] = chars[cch];
+        }
+    }
+
+    return S_OK;
+}
+
 [[nodiscard]] HRESULT ApiDispatchers::ServerWriteConsole(_Inout_ CONSOLE_API_MSG* const m,
                                                          _Inout_ BOOL* const pbReplyPending)
 {
@@ -349,6 +477,27 @@ constexpr T saturate(auto val)
     SCREEN_INFORMATION* pScreenInfo;
     RETURN_IF_FAILED(HandleData->GetScreenBuffer(GENERIC_WRITE, &pScreenInfo));
 
+    // Large writes are streamed from the driver instead of being copied into the message first.
+    if (a->Unicode &&
+        m->State.InputBuffer == nullptr &&
+        m->State.ReadOffset <= m->Descriptor.InputSize &&
+        m->Descriptor.InputSize - m->State.ReadOffset > WriteConsoleSliceSize)
+    {
+        size_t cbRead;
+        const auto hr = StreamWriteConsoleW(m, *pScreenInfo, cbRead);
+        if (hr == CONSOLE_STATUS_WAIT)
+        {
+            *pbReplyPending = TRUE;
+            return S_OK;
+        }
+        if (hr != S_FALSE)
+        {
+            LOG_IF_FAILED(SizeTToULong(cbRead, &a->NumBytes));
+            m->SetReplyInformation(a->NumBytes);
+            return hr;
+        }
+    }
+
     // Get input parameter buffer
     PVOID pvBuffer;
     ULONG cbBufferSize;
@@ -106,13 +106,6 @@ try
 
         const auto cbReadSize = Descriptor.InputSize - State.ReadOffset;
 
-        // If we were previously called with a huge buffer we have an equally large _inputBuffer.
-        // We shouldn't just keep this huge buffer around, if no one needs it anymore.
-        if (_inputBuffer.capacity() > 128 * 1024 && (_inputBuffer.capacity() >> 1) > cbReadSize)
-        {
-            _inputBuffer.shrink_to_fit();
-        }
-
         _inputBuffer.resize(cbReadSize);
 
         RETURN_IF_FAILED(ReadMessageInput(0, _inputBuffer.data(), cbReadSize));
@@ -149,13 +142,6 @@ try
 
         auto cbWriteSize = Descriptor.OutputSize - State.WriteOffset;
 
-        // If we were previously called with a huge buffer we have an equally large _outputBuffer.
-        // We shouldn't just keep this huge buffer around, if no one needs it anymore.
-        if (_outputBuffer.capacity() > 128 * 1024 && (_outputBuffer.capacity() >> 1) > cbWriteSize)
-        {
-            _outputBuffer.shrink_to_fit();
-        }
-
         _outputBuffer.resize(cbWriteSize);
 
         // 0 it out.
@@ -17,6 +17,7 @@ Revision History:
 
 #pragma once
 
+#include "ApiMessageBuffer.h"
 #include "ApiMessageState.h"
 #include "IApiRoutines.h"
 
@@ -59,8 +60,8 @@ typedef struct _CONSOLE_API_MSG
     IDeviceComm* _pDeviceComm{ nullptr };
     IApiRoutines* _pApiRoutines{ nullptr };
 
-    til::small_vector<BYTE, 128> _inputBuffer;
-    til::small_vector<BYTE, 128> _outputBuffer;
+    ApiMessageBuffer _inputBuffer;
+    ApiMessageBuffer _outputBuffer;
 
     // From here down is the actual packet data sent/received.
     CD_IO_DESCRIPTOR Descriptor;
@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "ApiMessageBuffer.h"
+
+#include <bit>
+
+namespace
+{
+    // Size classes from MinPooledSize up to and including MaxPooledSize.
+    constexpr size_t SizeClassCount = std::countr_zero(ApiMessageBuffer::MaxPooledSize) - std::countr_zero(ApiMessageBuffer::MinPooledSize) + 1;
+    // Most clients only ever have a single request in flight, and the ones that
+    // aren't serviced immediately (waits) are rare. Retaining a couple is plenty.
+    constexpr size_t BlocksPerSizeClass = 2;
+
+    struct Pool
+    {
+        std::mutex lock;
+        std::array<til::small_vector<BYTE*, BlocksPerSizeClass>, SizeClassCount> free;
+    };
+
+    Pool& pool() noexcept
+    {
+        static Pool pool;
+        return pool;
+    }
+
+    size_t roundUpToSizeClass(size_t size) noexcept
+    {
+        return std::bit_ceil(std::max(size, ApiMessageBuffer::MinPooledSize));
+    }
+
+    size_t sizeClassIndex(size_t capacity) noexcept
+    {
+        return gsl::narrow_cast<size_t>(std::countr_zero(capacity) - std::countr_zero(ApiMessageBuffer::MinPooledSize));
+    }
+
+    BYTE* acquire(size_t capacity)
+    {
+        if (capacity <= ApiMessageBuffer::MaxPooledSize)
+        {
+            auto& p = pool();
+            const std::lock_guard guard{ p.lock };
+            auto& free = til::at(p.free, sizeClassIndex(capacity));
+            if (!free.empty())
+            {
+                const auto block = free.back();
+                free.pop_back();
+                return block;
+            }
+        }
+
+        return static_cast<BYTE*>(::operator new(capacity));
+    }
+
+    void release(BYTE* block, size_t capacity) noexcept
+    {
+        if (capacity <= ApiMessageBuffer::MaxPooledSize)
+        {
+            auto& p = pool();
+            const std::lock_guard guard{ p.lock };
+            auto& free = til::at(p.free, sizeClassIndex(capacity));
+            if (free.size() < BlocksPerSizeClass)
+            {
+                free.push_back(block);
+                return;
+            }
+        }
+
+        ::operator delete(block);
+    }
+}
+
+ApiMessageBuffer::ApiMessageBuffer(const ApiMessageBuffer& other)
+{
+    *this = other;
+}
+
+ApiMessageBuffer& ApiMessageBuffer::operator=(const ApiMessageBuffer& other)
+{
+    if (this != &other)
+    {
+        resize(other._size);
+        memcpy(_data, other._data, other._size);
+    }
+    return *this;
+}
+
+ApiMessageBuffer::~ApiMessageBuffer()
+{
+    _release();
+}
+
+BYTE* ApiMessageBuffer::data() noexcept
+{
+    return _data;
+}
+
+size_t ApiMessageBuffer::size() const noexcept
+{
+    return _size;
+}
+
+void ApiMessageBuffer::resize(size_t size)
+{
+    if (size > _capacity)
+    {
+        const auto capacity = size > MaxPooledSize ? size : roundUpToSizeClass(size);
+        const auto data = acquire(capacity);
+        _release();
+        _data = data;
+        _capacity = capacity;
+    }
+
+    _size = size;
+}
+
+void ApiMessageBuffer::clear() noexcept
+{
+    _release();
+    _data = &_inline[0];
+    _size = 0;
+    _capacity = InlineSize;
+}
+
+void ApiMessageBuffer::_release() noexcept
+{
+    if (_data != &_inline[0])
+    {
+        release(_data, _capacity);
+    }
+}
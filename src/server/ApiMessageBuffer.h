@@ -0,0 +1,49 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ApiMessageBuffer.h
+
+Abstract:
+- Storage for the input and output payloads of an API message.
+- Small payloads are stored inline. Larger ones are taken from a process-wide pool
+  of power-of-two sized blocks which are handed back once the message is released,
+  so that the IO thread doesn't allocate and free memory for every single request.
+- The pool only retains a few blocks per size class and never any above MaxPooledSize.
+  Larger payloads are allocated on demand and freed immediately after use.
+
+--*/
+
+#pragma once
+
+class ApiMessageBuffer
+{
+public:
+    static constexpr size_t InlineSize = 128;
+    static constexpr size_t MinPooledSize = 4 * 1024;
+    static constexpr size_t MaxPooledSize = 1024 * 1024;
+
+    ApiMessageBuffer() = default;
+    ApiMessageBuffer(const ApiMessageBuffer& other);
+    ApiMessageBuffer& operator=(const ApiMessageBuffer& other);
+    ApiMessageBuffer(ApiMessageBuffer&&) = delete;
+    ApiMessageBuffer& operator=(ApiMessageBuffer&&) = delete;
+    ~ApiMessageBuffer();
+
+    BYTE* data() noexcept;
+    size_t size() const noexcept;
+
+    // Unlike std::vector::resize() this doesn't preserve the existing contents.
+    void resize(size_t size);
+    // Returns any pooled block back to the pool.
+    void clear() noexcept;
+
+private:
+    void _release() noexcept;
+
+    BYTE* _data = &_inline[0];
+    size_t _size = 0;
+    size_t _capacity = InlineSize;
+    BYTE _inline[InlineSize];
+};
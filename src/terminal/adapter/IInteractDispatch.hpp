@@ -32,6 +32,7 @@ namespace Microsoft::Console::VirtualTerminal
 
         virtual void WriteInput(const std::span<const INPUT_RECORD>& inputEvents) = 0;
         virtual void WriteCtrlKey(const INPUT_RECORD& event) = 0;
+        virtual void WriteCtrlKeys(const std::span<const INPUT_RECORD>& events) = 0;
         virtual void WriteString(std::wstring_view string) = 0;
         virtual void WriteStringRaw(std::wstring_view string) = 0;
         virtual void WindowManipulation(DispatchTypes::WindowManipulationType function, VTParameter parameter1, VTParameter parameter2) = 0;
@@ -53,6 +53,16 @@ void InteractDispatch::WriteCtrlKey(const INPUT_RECORD& event)
     HandleGenericKeyEvent(event, false);
 }
 
+// Method Description:
+// - Same as WriteCtrlKey, but for many key events at once. Keys that don't
+//   require special handling are written to the input buffer in bulk.
+// Arguments:
+// - events: The keys to send to the host.
+void InteractDispatch::WriteCtrlKeys(const std::span<const INPUT_RECORD>& events)
+{
+    HandleGenericKeyEvents(events);
+}
+
 // Call this method to write some plain text to the InputBuffer.
 //
 // Since the hosting terminal for ConPTY may not support win32-input-mode,
@@ -86,6 +96,8 @@ void InteractDispatch::WriteString(const std::wstring_view string)
         {
             const auto codepage = _api.GetOutputCodePage();
             InputEventQueue keyEvents;
+            // Most characters turn into a key down and up event.
+            keyEvents.reserve(string.size() * 2);
 
             for (const auto& wch : string)
             {
@@ -35,6 +35,7 @@ namespace Microsoft::Console::VirtualTerminal
         virtual bool ActionExecuteFromEscape(const wchar_t wch) = 0;
         virtual bool ActionPrint(const wchar_t wch) = 0;
         virtual bool ActionPrintString(const std::wstring_view string) = 0;
+        virtual size_t ActionWin32KeyRun(const std::wstring_view string) = 0;
 
         virtual bool ActionPassThroughString(const std::wstring_view string) = 0;
 
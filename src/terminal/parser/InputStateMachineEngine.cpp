@@ -295,6 +295,46 @@ bool InputStateMachineEngine::ActionPrintString(const std::wstring_view string)
     return true;
 }
 
+// Method Description:
+// - Consumes a run of consecutive win32-input-mode sequences at the start of the
+//      given string and writes them to the input in a single batch. This bypasses
+//      the generic CSI parameter parsing of the state machine for what is by far
+//      the most common input when ConPTY is hosted by a terminal that supports
+//      this mode: Every keystroke (or pasted character) turns into 2 of them.
+// - The run ends at the first sequence that isn't a complete and well-formed
+//      win32-input-mode sequence. It's left to the state machine as usual.
+// Arguments:
+// - string - the input to parse, usually starting with an ESC character.
+// Return Value:
+// - The number of characters that were consumed.
+size_t InputStateMachineEngine::ActionWin32KeyRun(const std::wstring_view string)
+{
+    InputEventQueue keys;
+    size_t consumed = 0;
+
+    for (;;)
+    {
+        INPUT_RECORD key;
+        const auto length = _ParseWin32Key(string.substr(consumed), key);
+        if (!length)
+        {
+            break;
+        }
+        keys.push_back(key);
+        consumed += length;
+    }
+
+    if (!keys.empty())
+    {
+        // Like in ActionCsiDispatch, these go through WriteCtrlKeys so that
+        // things like Ctrl+C and Ctrl+Break are handled correctly.
+        _pDispatch->WriteCtrlKeys(keys);
+        _encounteredWin32InputModeSequence = true;
+    }
+
+    return consumed;
+}
+
 // Method Description:
 // - Triggers the Print action to indicate that the listener should render the
 //      string of characters given.
@@ -1162,3 +1202,73 @@ INPUT_RECORD InputStateMachineEngine::_GenerateWin32Key(const VTParameters& para
         ::base::saturated_cast<wchar_t>(parameters.at(2).value_or(0)),
         ::base::saturated_cast<uint32_t>(parameters.at(4).value_or(0)));
 }
+
+// Method Description:
+// - A fixed-format parser for a single win32-input-mode sequence at the start of
+//      the string (see _GenerateWin32Key for the format). It only accepts a CSI,
+//      up to 6 numeric parameters separated by ';' and the final '_'. Anything else,
+//      including sequences that are incomplete or that the state machine would parse
+//      differently (sub-parameters, intermediates, embedded C0 controls, ...)
+//      is rejected, so that the caller can fall back to the state machine.
+// Arguments:
+// - string: the input to parse.
+// - record: Receives the deserialized KeyEvent.
+// Return Value:
+// - The length of the sequence, or 0 if the string doesn't start with one.
+size_t InputStateMachineEngine::_ParseWin32Key(const std::wstring_view string, INPUT_RECORD& record) noexcept
+{
+    if (string.size() < 3 || til::at(string, 0) != L'\x1b' || til::at(string, 1) != L'[')
+    {
+        return 0;
+    }
+
+    // Vk, Sc, Uc, Kd, Cs, Rc with their respective default values.
+    std::array<VTInt, 6> values{ 0, 0, 0, 0, 0, 1 };
+    size_t index = 0;
+    VTInt value = 0;
+    auto hasValue = false;
+
+    for (size_t i = 2; i < string.size(); ++i)
+    {
+        const auto wch = til::at(string, i);
+
+        if (wch >= L'0' && wch <= L'9')
+        {
+            // Same saturation as in StateMachine::_AccumulateTo.
+            value = std::min(value * 10 + (wch - L'0'), MAX_PARAMETER_VALUE);
+            hasValue = true;
+            continue;
+        }
+
+        if (wch != L';' && wch != L'_')
+        {
+            return 0;
+        }
+
+        if (hasValue)
+        {
+            til::at(values, index) = value;
+        }
+
+        if (wch == L'_')
+        {
+            record = SynthesizeKeyEvent(
+                til::at(values, 3) != 0,
+                ::base::saturated_cast<uint16_t>(til::at(values, 5)),
+                ::base::saturated_cast<uint16_t>(til::at(values, 0)),
+                ::base::saturated_cast<uint16_t>(til::at(values, 1)),
+                ::base::saturated_cast<wchar_t>(til::at(values, 2)),
+                ::base::saturated_cast<uint32_t>(til::at(values, 4)));
+            return i + 1;
+        }
+
+        if (++index >= values.size())
+        {
+            return 0;
+        }
+        value = 0;
+        hasValue = false;
+    }
+
+    return 0;
+}
@@ -176,6 +176,8 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionPrintString(const std::wstring_view string) override;
 
+        size_t ActionWin32KeyRun(const std::wstring_view string) override;
+
         bool ActionPassThroughString(const std::wstring_view string) override;
 
         bool ActionEscDispatch(const VTID id) override;
@@ -237,6 +239,7 @@ namespace Microsoft::Console::VirtualTerminal
                                         unsigned int& function) const noexcept;
 
         static INPUT_RECORD _GenerateWin32Key(const VTParameters& parameters);
+        static size_t _ParseWin32Key(const std::wstring_view string, INPUT_RECORD& record) noexcept;
 
         bool _DoControlCharacter(const wchar_t wch, const bool writeAlt);
 
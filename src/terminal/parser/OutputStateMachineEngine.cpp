@@ -168,6 +168,17 @@ bool OutputStateMachineEngine::ActionPrintString(const std::wstring_view string)
     return true;
 }
 
+// Method Description:
+// - win32-input-mode sequences are input sequences. Nothing to do here.
+// Arguments:
+// - string - string to dispatch.
+// Return Value:
+// - 0, the number of characters that were consumed.
+size_t OutputStateMachineEngine::ActionWin32KeyRun(const std::wstring_view /*string*/) noexcept
+{
+    return 0;
+}
+
 // Routine Description:
 // This is called when we have determined that we don't understand a particular
 //      sequence, or the adapter has determined that the string is intended for
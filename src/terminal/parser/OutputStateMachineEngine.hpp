@@ -34,6 +34,8 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionPrintString(const std::wstring_view string) override;
 
+        size_t ActionWin32KeyRun(const std::wstring_view string) noexcept override;
+
         bool ActionPassThroughString(const std::wstring_view string) noexcept override;
 
         bool ActionEscDispatch(const VTID id) override;
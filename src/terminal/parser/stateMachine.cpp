@@ -432,6 +432,25 @@ void StateMachine::_ActionPrintString(const std::wstring_view string)
     _trace.DispatchPrintRunTrace(string);
 }
 
+// Routine Description:
+// - Triggers the Win32KeyRun action, which allows the input engine to consume a run of
+//   win32-input-mode sequences at once, without going through the state machine.
+// Arguments:
+// - string - The remaining input, starting with an ESC character.
+// Return Value:
+// - The number of characters that were consumed.
+size_t StateMachine::_ActionWin32KeyRun(const std::wstring_view string)
+try
+{
+    _trace.TraceOnAction(L"Win32KeyRun");
+    return _engine->ActionWin32KeyRun(string);
+}
+catch (...)
+{
+    LOG_HR(wil::ResultFromCaughtException());
+    return 0;
+}
+
 // Routine Description:
 // - Triggers the EscDispatch action to indicate that the listener should handle a simple escape sequence.
 //   These sequences traditionally start with ESC and a simple letter. No complicated parameters.
@@ -2011,6 +2030,19 @@ void StateMachine::ProcessString(const std::wstring_view string)
             }
         }
 
+        // In ConPTY, most input consists of win32-input-mode sequences (2 per keystroke),
+        // which the input engine can parse a lot faster than the generic state machine.
+        if (_isEngineForInput && i < string.size())
+        {
+            const auto consumed = _ActionWin32KeyRun(string.substr(i));
+            if (consumed)
+            {
+                i += consumed;
+                _runOffset = i;
+                continue;
+            }
+        }
+
     processStringLoopVtStart:
         if (i >= string.size())
         {
@@ -98,6 +98,7 @@ namespace Microsoft::Console::VirtualTerminal
         void _ActionExecuteFromEscape(const wchar_t wch);
         void _ActionPrint(const wchar_t wch);
         void _ActionPrintString(const std::wstring_view string);
+        size_t _ActionWin32KeyRun(const std::wstring_view string);
         void _ActionEscDispatch(const wchar_t wch);
         void _ActionVt52EscDispatch(const wchar_t wch);
         void _ActionCollect(const wchar_t wch) noexcept;
@@ -273,6 +273,7 @@ class Microsoft::Console::VirtualTerminal::InputEngineTest
 
     TEST_METHOD(TestWin32InputParsing);
     TEST_METHOD(TestWin32InputOptionals);
+    TEST_METHOD(TestWin32InputFastPath);
 
     friend class TestInteractDispatch;
 };
@@ -318,6 +319,7 @@ public:
     virtual void WriteInput(_In_ const std::span<const INPUT_RECORD>& inputEvents) override;
 
     virtual void WriteCtrlKey(const INPUT_RECORD& event) override;
+    virtual void WriteCtrlKeys(const std::span<const INPUT_RECORD>& events) override;
     virtual void WindowManipulation(const DispatchTypes::WindowManipulationType function,
                                     const VTParameter parameter1,
                                     const VTParameter parameter2) override; // DTTERM_WindowManipulation
@@ -354,6 +356,12 @@ void TestInteractDispatch::WriteCtrlKey(const INPUT_RECORD& event)
     WriteInput({ &event, 1 });
 }
 
+void TestInteractDispatch::WriteCtrlKeys(const std::span<const INPUT_RECORD>& events)
+{
+    VERIFY_IS_TRUE(_testState->_expectSendCtrlC);
+    WriteInput(events);
+}
+
 void TestInteractDispatch::WindowManipulation(const DispatchTypes::WindowManipulationType function,
                                               const VTParameter parameter1,
                                               const VTParameter parameter2)
@@ -1561,3 +1569,79 @@ void InputEngineTest::TestWin32InputOptionals()
         }
     }
 }
+
+void InputEngineTest::TestWin32InputFastPath()
+{
+    INPUT_RECORD record{};
+
+    Log::Comment(L"Complete sequences are parsed exactly like _GenerateWin32Key would.");
+    {
+        const std::wstring_view seq{ L"\x1b[65;30;97;1;8;2_" };
+        VERIFY_ARE_EQUAL(seq.size(), InputStateMachineEngine::_ParseWin32Key(seq, record));
+        const auto& key = record.Event.KeyEvent;
+        VERIFY_ARE_EQUAL(65, key.wVirtualKeyCode);
+        VERIFY_ARE_EQUAL(30, key.wVirtualScanCode);
+        VERIFY_ARE_EQUAL(L'a', key.uChar.UnicodeChar);
+        VERIFY_ARE_EQUAL(TRUE, key.bKeyDown);
+        VERIFY_ARE_EQUAL(8u, key.dwControlKeyState);
+        VERIFY_ARE_EQUAL(2, key.wRepeatCount);
+    }
+    {
+        const std::wstring_view seq{ L"\x1b[;;;;;_" };
+        VERIFY_ARE_EQUAL(seq.size(), InputStateMachineEngine::_ParseWin32Key(seq, record));
+        const auto& key = record.Event.KeyEvent;
+        VERIFY_ARE_EQUAL(0, key.wVirtualKeyCode);
+        VERIFY_ARE_EQUAL(0, key.wVirtualScanCode);
+        VERIFY_ARE_EQUAL(L'\0', key.uChar.UnicodeChar);
+        VERIFY_ARE_EQUAL(FALSE, key.bKeyDown);
+        VERIFY_ARE_EQUAL(0u, key.dwControlKeyState);
+        VERIFY_ARE_EQUAL(1, key.wRepeatCount);
+    }
+    {
+        const std::wstring_view seq{ L"\x1b[99999;0;65535;1_trailing" };
+        VERIFY_ARE_EQUAL(seq.find(L'_') + 1, InputStateMachineEngine::_ParseWin32Key(seq, record));
+        const auto& key = record.Event.KeyEvent;
+        VERIFY_ARE_EQUAL(65535, key.wVirtualKeyCode);
+        VERIFY_ARE_EQUAL(L'\xffff', key.uChar.UnicodeChar);
+        VERIFY_ARE_EQUAL(1, key.wRepeatCount);
+    }
+
+    Log::Comment(L"Anything else is left to the state machine.");
+    for (const auto seq : {
+             L"\x1b[65;30;97;1;0;1",
+             L"\x1b[1;2;3;4;5;6;7_",
+             L"\x1b[1:2_",
+             L"\x1b[?1_",
+             L"\x1b[1;2\r_",
+             L"\x1b[A",
+             L"\x1bO",
+             L"a",
+         })
+    {
+        VERIFY_ARE_EQUAL(0u, InputStateMachineEngine::_ParseWin32Key(seq, record));
+    }
+
+    Log::Comment(L"A run of sequences is written in a single batch.");
+    {
+        std::vector<std::vector<INPUT_RECORD>> writes;
+        auto pfn = [&](const std::span<const INPUT_RECORD>& records) {
+            writes.emplace_back(records.begin(), records.end());
+        };
+        auto dispatch = std::make_unique<TestInteractDispatch>(pfn, &testState);
+        auto inputEngine = std::make_unique<InputStateMachineEngine>(std::move(dispatch));
+        auto engine = inputEngine.get();
+        auto stateMachine = std::make_unique<StateMachine>(std::move(inputEngine));
+
+        testState._expectSendCtrlC = true;
+        auto restore = wil::scope_exit([&] { testState._expectSendCtrlC = false; });
+
+        stateMachine->ProcessString(L"\x1b[65;30;97;1;0;1_\x1b[65;30;97;0;0;1_\x1b[66;48;98;1;0;1_\x1b[66;48;98;0;0;1_");
+
+        VERIFY_ARE_EQUAL(1u, writes.size());
+        VERIFY_ARE_EQUAL(4u, writes[0].size());
+        VERIFY_ARE_EQUAL(L'a', writes[0][0].Event.KeyEvent.uChar.UnicodeChar);
+        VERIFY_ARE_EQUAL(L'b', writes[0][3].Event.KeyEvent.uChar.UnicodeChar);
+        VERIFY_IS_TRUE(engine->EncounteredWin32InputModeSequence());
+        VERIFY_ARE_EQUAL(StateMachine::VTStates::Ground, stateMachine->_state);
+    }
+}
@@ -63,6 +63,11 @@ public:
         return true;
     };
 
+    size_t ActionWin32KeyRun(const std::wstring_view /*string*/) override
+    {
+        return 0;
+    };
+
     bool ActionPassThroughString(const std::wstring_view string) override
     {
         passedThrough += string;
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "til/parallel.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class ParallelTests
+{
+    BEGIN_TEST_CLASS(ParallelTests)
+        TEST_CLASS_PROPERTY(L"TestTimeout", L"0:0:10") // 10s timeout
+    END_TEST_CLASS()
+
+    TEST_METHOD(Empty)
+    {
+        auto called = false;
+        til::parallel_for(0, [&](size_t) noexcept {
+            called = true;
+        });
+        VERIFY_IS_FALSE(called);
+    }
+
+    TEST_METHOD(CallsEveryIndexOnce)
+    {
+        static constexpr size_t count = 1000;
+        std::vector<std::atomic<int>> calls(count);
+
+        til::parallel_for(count, [&](const size_t i) noexcept {
+            calls[i].fetch_add(1, std::memory_order_relaxed);
+        });
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            VERIFY_ARE_EQUAL(1, calls[i].load(std::memory_order_relaxed));
+        }
+    }
+
+    TEST_METHOD(WaitsForAllWork)
+    {
+        std::atomic<size_t> done{ 0 };
+
+        til::parallel_for(16, [&](size_t) noexcept {
+            Sleep(10);
+            done.fetch_add(1, std::memory_order_relaxed);
+        });
+
+        VERIFY_ARE_EQUAL(16u, done.load(std::memory_order_relaxed));
+    }
+};